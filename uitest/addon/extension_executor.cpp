@@ -41,6 +41,8 @@ namespace OHOS::uitest {
     static mutex g_captureLock;
     static mutex g_recordRunningLock;
     static set<string> g_runningCaptures;
+    // layout of the last dumpLayout capture in the diff mode, which the next one is diffed against
+    static nlohmann::json g_lastDiffLayout = nullptr;
 
 #define EXTENSION_API_CHECK(cond, errorMessage, errorCode) \
 do { \
@@ -125,7 +127,7 @@ do { \
         unique_lock<mutex> guard(g_callThroughLock, std::adopt_lock);
         using namespace nlohmann;
         using VT = nlohmann::detail::value_t;
-        static auto server = FrontendApiServer::Get();
+        auto &server = FrontendApiServer::Get();
         CALL_THROUGH_CHECK(in.data != nullptr, "Null message", ERR_BAD_ARG, true, ptr);
         CALL_THROUGH_CHECK(out.data != nullptr, "Null output buffer", ERR_BAD_ARG, true, ptr);
         CALL_THROUGH_CHECK(out.size != nullptr, "Null output size pointer", ERR_BAD_ARG, true, ptr);
@@ -300,7 +302,13 @@ do { \
             EXTENSION_API_CHECK(GetDumpInfo(options, tree, err) == RETCODE_SUCCESS, "Illegal options", ERR_BAD_ARG);
             g_runningCaptures.erase("dumpLayout"); // dumpLayout is sync&once
             EXTENSION_API_CHECK(err.code_ == NO_ERROR, err.message_, err.code_);
-            auto layout = tree.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+            nlohmann::json layoutDiff = nullptr;
+            if (ReadArgFromJson<bool>(options, "diff", false)) {
+                // marked as the full layout on the first capture or if the nodes can not be keyed by hashcode
+                DumpHandler::DiffLayoutWithLast(g_lastDiffLayout, tree, layoutDiff);
+            }
+            const auto &out = layoutDiff.is_null() ? tree : layoutDiff;
+            auto layout = out.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
             callback(Text{layout.c_str(), layout.length()});
         } else if (strcmp(name.data, "copyScreen") == 0) {
             float scale = ReadArgFromJson<float>(options, "scale", 0.5f);
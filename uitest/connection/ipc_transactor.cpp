@@ -349,18 +349,9 @@ namespace OHOS::uitest {
             reply.exception_ = ApiCallErr(ERR_INTERNAL, "ipc connection is dead");
             return;
         }
-        // check concurrent call
-        if (!processingApi_.empty()) {
-            constexpr auto msg = "uitest-api dose not allow calling concurrently, current processing:";
-            reply.exception_.code_ = ERR_API_USAGE;
-            reply.exception_.message_ = string(msg) + processingApi_ + ", incoming: " + call.apiId_;
-            return;
-        }
-        processingApi_ = call.apiId_;
-        // forward to peer
+        // forward to peer, the overlapping calls are scheduled by the server
         DCHECK(remoteCaller_ != nullptr);
         remoteCaller_->Call(call, reply);
-        processingApi_.clear();
     }
 
     // functions for sending/handling broadcast commands
@@ -91,8 +91,6 @@ namespace OHOS::uitest {
         const bool asServer_ = false;
         ConnectionStat connectState_ = UNINIT;
         bool singlenessMode_ = false;
-        // for concurrent invocation detect
-        std::string processingApi_ = "";
         sptr<ApiCaller> caller_ = nullptr;
         // ipc objects
         sptr<ApiCallerProxy> remoteCaller_ = nullptr;
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "api_call_scheduler.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    uint64_t ApiCallScheduler::Enter(ApiAccess access)
+    {
+        unique_lock<mutex> lock(mutex_);
+        const auto ticket = nextTicket_++;
+        if (access == API_MUTATING) {
+            // run after the former writes and reads
+            writes_.push_back(ticket);
+            condition_.wait(lock, [this, ticket]() {
+                return writes_.front() == ticket && (reads_.empty() || *reads_.begin() > ticket);
+            });
+        } else {
+            // run after the former writes
+            reads_.insert(ticket);
+            condition_.wait(lock, [this, ticket]() { return writes_.empty() || writes_.front() > ticket; });
+        }
+        lock.unlock();
+        LockSnapshot(access);
+        return ticket;
+    }
+
+    void ApiCallScheduler::Leave(uint64_t ticket, ApiAccess access)
+    {
+        UnlockSnapshot(access);
+        {
+            lock_guard<mutex> guard(mutex_);
+            if (access == API_MUTATING) {
+                writes_.pop_front();
+            } else {
+                reads_.erase(ticket);
+            }
+        }
+        condition_.notify_all();
+    }
+
+    void ApiCallScheduler::LockSnapshot(ApiAccess access)
+    {
+        if (access == API_READ_SNAPSHOT) {
+            snapshotMutex_.lock();
+        } else if (access == API_READ_WIDGET) {
+            snapshotMutex_.lock_shared();
+        }
+    }
+
+    void ApiCallScheduler::UnlockSnapshot(ApiAccess access)
+    {
+        if (access == API_READ_SNAPSHOT) {
+            snapshotMutex_.unlock();
+        } else if (access == API_READ_WIDGET) {
+            snapshotMutex_.unlock_shared();
+        }
+    }
+
+    size_t ApiCallScheduler::GetQueuedCount() const
+    {
+        lock_guard<mutex> guard(mutex_);
+        return reads_.size() + writes_.size();
+    }
+} // namespace OHOS::uitest
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef API_CALL_SCHEDULER_H
+#define API_CALL_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <shared_mutex>
+
+namespace OHOS::uitest {
+    /**How a call of the api accesses the ui and the daemon, which decides the calls it can run along with.*/
+    enum ApiAccess : uint8_t {
+        // injects input, changes the ui or the state of the daemon
+        API_MUTATING = 0,
+        // reads the ui snapshot of the driver, which is traversed by stateful node iterators
+        API_READ_SNAPSHOT,
+        // reads the stored widgets, which are retrieved from the ui snapshot in turn only if the ui changed
+        API_READ_WIDGET,
+        // builds or reads the backend objects only
+        API_READ_PURE,
+    };
+
+    /**Schedules the api calls in the order of arrival. The reading calls run along with each other, a mutating call
+     * waits for all the calls arrived before it and blocks the ones arrived after it. The snapshot reading calls
+     * also take the ui snapshot in turn, the widget reading calls share it.*/
+    class ApiCallScheduler {
+    public:
+        /**Wait for the turn of the call, returns the ticket to leave with.*/
+        uint64_t Enter(ApiAccess access);
+
+        /**Leave the turn taken by Enter.*/
+        void Leave(uint64_t ticket, ApiAccess access);
+
+        /**Count of the calls entered but not left, the waiting ones included.*/
+        size_t GetQueuedCount() const;
+
+        /**Take or release the ui snapshot as the call of the access does.*/
+        void LockSnapshot(ApiAccess access);
+        void UnlockSnapshot(ApiAccess access);
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable condition_;
+        uint64_t nextTicket_ = 0;
+        // tickets of the waiting or running reads and writes
+        std::set<uint64_t> reads_;
+        std::deque<uint64_t> writes_;
+        std::shared_mutex snapshotMutex_;
+    };
+
+    /**Holds the turn of a call from construction to destruction.*/
+    class ApiCallTurn {
+    public:
+        ApiCallTurn(ApiCallScheduler &scheduler, ApiAccess access)
+            : scheduler_(scheduler), access_(access), ticket_(scheduler.Enter(access)), outer_(current_)
+        {
+            current_ = this;
+        }
+
+        ~ApiCallTurn()
+        {
+            current_ = outer_;
+            scheduler_.Leave(ticket_, access_);
+        }
+
+        ApiCallTurn(const ApiCallTurn &) = delete;
+        ApiCallTurn &operator=(const ApiCallTurn &) = delete;
+
+    private:
+        friend class ApiCallYield;
+        ApiCallScheduler &scheduler_;
+        const ApiAccess access_;
+        const uint64_t ticket_;
+        // turn held by the thread before this one
+        ApiCallTurn *const outer_;
+        static inline thread_local ApiCallTurn *current_ = nullptr;
+    };
+
+    /**Releases the ui snapshot taken by the turn of the calling thread from construction to destruction, so that
+     * the other reads go on while the call waits for the ui. Nothing is done out of any turn.*/
+    class ApiCallYield {
+    public:
+        ApiCallYield() : turn_(ApiCallTurn::current_)
+        {
+            if (turn_ != nullptr) {
+                turn_->scheduler_.UnlockSnapshot(turn_->access_);
+            }
+        }
+
+        ~ApiCallYield()
+        {
+            if (turn_ != nullptr) {
+                turn_->scheduler_.LockSnapshot(turn_->access_);
+            }
+        }
+
+        ApiCallYield(const ApiCallYield &) = delete;
+        ApiCallYield &operator=(const ApiCallYield &) = delete;
+
+    private:
+        ApiCallTurn *const turn_;
+    };
+} // namespace OHOS::uitest
+
+#endif
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ui_model.h"
+#include "backend_object_table.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    static constexpr uint64_t SLOT_MASK = (1ULL << BackendObjectTable::SLOT_BITS) - 1;
+
+    /**Split the reference "Type#N" into the type name and N, returns false if it's not in this format.*/
+    static bool SplitObjectRef(string_view ref, string_view &typeName, uint64_t &number)
+    {
+        constexpr uint64_t decimal = 10;
+        const auto pos = ref.find('#');
+        if (pos == string_view::npos || pos == 0 || pos + 1 == ref.length()) {
+            return false;
+        }
+        typeName = ref.substr(0, pos);
+        number = 0;
+        for (auto index = pos + 1; index < ref.length(); index++) {
+            const char ch = ref[index];
+            if (ch < '0' || ch > '9' || number > (UINT64_MAX - (ch - '0')) / decimal) {
+                return false;
+            }
+            number = number * decimal + static_cast<uint64_t>(ch - '0');
+        }
+        return true;
+    }
+
+    bool BackendObjectTable::IsObjectRef(string_view ref)
+    {
+        string_view typeName;
+        uint64_t number = 0;
+        if (!SplitObjectRef(ref, typeName, number)) {
+            return false;
+        }
+        for (auto classDef : FRONTEND_CLASS_DEFS) {
+            if (classDef->name_ == typeName) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool BackendObjectTable::Resolve(string_view ref, Handle &handle) const
+    {
+        string_view typeName;
+        uint64_t number = 0;
+        if (!SplitObjectRef(ref, typeName, number) || (number >> SLOT_BITS) > UINT32_MAX) {
+            return false;
+        }
+        for (size_t slab = 0; slab < slabs_.size(); slab++) {
+            if (slabs_[slab].typeName_ == typeName) {
+                handle.slab_ = static_cast<uint32_t>(slab);
+                handle.slot_ = static_cast<uint32_t>(number & SLOT_MASK);
+                handle.generation_ = static_cast<uint32_t>(number >> SLOT_BITS);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    string BackendObjectTable::MakeRef(const Handle &handle) const
+    {
+        const auto number = (static_cast<uint64_t>(handle.generation_) << SLOT_BITS) | handle.slot_;
+        return string(slabs_[handle.slab_].typeName_) + "#" + to_string(number);
+    }
+
+    BackendObjectTable::Entry *BackendObjectTable::GetEntry(const Handle &handle)
+    {
+        if (handle.slab_ >= slabs_.size()) {
+            return nullptr;
+        }
+        auto &entries = slabs_[handle.slab_].entries_;
+        if (handle.slot_ >= entries.size()) {
+            return nullptr;
+        }
+        auto &entry = entries[handle.slot_];
+        return entry.object_ != nullptr && entry.generation_ == handle.generation_ ? &entry : nullptr;
+    }
+
+    uint64_t BackendObjectTable::BeginCall()
+    {
+        lock_guard<mutex> guard(mutex_);
+        callEpoch_++;
+        activeEpochs_.insert(callEpoch_);
+        return callEpoch_;
+    }
+
+    void BackendObjectTable::EndCall(uint64_t epoch)
+    {
+        lock_guard<mutex> guard(mutex_);
+        auto find = activeEpochs_.find(epoch);
+        if (find != activeEpochs_.end()) {
+            activeEpochs_.erase(find);
+        }
+    }
+
+    void BackendObjectTable::SetWidgetMemoryLimit(size_t bytes)
+    {
+        lock_guard<mutex> guard(mutex_);
+        widgetMemoryLimit_ = bytes;
+    }
+
+    size_t BackendObjectTable::GetWidgetMemory() const
+    {
+        lock_guard<mutex> guard(mutex_);
+        return widgetMemory_;
+    }
+
+    size_t BackendObjectTable::GetLivingCount() const
+    {
+        lock_guard<mutex> guard(mutex_);
+        return livingCount_;
+    }
+
+    string BackendObjectTable::Store(unique_ptr<BackendClass> object, string_view ownerRef)
+    {
+        DCHECK(object != nullptr);
+        lock_guard<mutex> guard(mutex_);
+        const auto typeName = object->GetFrontendClassDef().name_;
+        Handle handle;
+        for (size_t slab = 0; slab < slabs_.size() && handle.slab_ == NO_SLOT; slab++) {
+            handle.slab_ = slabs_[slab].typeName_ == typeName ? static_cast<uint32_t>(slab) : NO_SLOT;
+        }
+        if (handle.slab_ == NO_SLOT) {
+            handle.slab_ = static_cast<uint32_t>(slabs_.size());
+            slabs_.emplace_back();
+            slabs_.back().typeName_ = typeName;
+            widgetSlab_ = typeName == COMPONENT_DEF.name_ ? handle.slab_ : widgetSlab_;
+        }
+        auto &slab = slabs_[handle.slab_];
+        if (!slab.freeSlots_.empty()) {
+            handle.slot_ = slab.freeSlots_.back();
+            slab.freeSlots_.pop_back();
+        } else {
+            DCHECK(slab.entries_.size() <= SLOT_MASK);
+            handle.slot_ = static_cast<uint32_t>(slab.entries_.size());
+            slab.entries_.emplace_back();
+        }
+        auto &entry = slab.entries_[handle.slot_];
+        handle.generation_ = entry.generation_;
+        entry.lastUseEpoch_ = callEpoch_;
+        if (handle.slab_ == widgetSlab_) {
+            entry.memory_ = static_cast<const Widget *>(object.get())->GetMemoryBytes();
+            widgetMemory_ += entry.memory_;
+            LinkLru(handle.slot_);
+        }
+        entry.object_ = move(object);
+        livingCount_++;
+        Handle owner;
+        auto ownerEntry = !ownerRef.empty() && Resolve(ownerRef, owner) ? GetEntry(owner) : nullptr;
+        if (ownerEntry != nullptr) {
+            entry.owner_ = owner;
+            entry.ownerPos_ = ownerEntry->children_.size();
+            ownerEntry->children_.emplace_back(handle);
+        }
+        auto ref = MakeRef(handle);
+        if (handle.slab_ == widgetSlab_) {
+            EvictWidgets();
+        }
+        return ref;
+    }
+
+    BackendClass *BackendObjectTable::Find(string_view ref)
+    {
+        lock_guard<mutex> guard(mutex_);
+        Handle handle;
+        auto entry = Resolve(ref, handle) ? GetEntry(handle) : nullptr;
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        entry->lastUseEpoch_ = callEpoch_;
+        if (handle.slab_ == widgetSlab_ && lruHead_ != handle.slot_) {
+            UnlinkLru(handle.slot_);
+            LinkLru(handle.slot_);
+        }
+        return entry->object_.get();
+    }
+
+    BackendClass *BackendObjectTable::FindOwner(string_view ref)
+    {
+        lock_guard<mutex> guard(mutex_);
+        Handle handle;
+        auto entry = Resolve(ref, handle) ? GetEntry(handle) : nullptr;
+        if (entry == nullptr) {
+            return nullptr;
+        }
+        auto owner = GetEntry(entry->owner_);
+        return owner == nullptr ? nullptr : owner->object_.get();
+    }
+
+    string BackendObjectTable::GetOwnerRef(string_view ref)
+    {
+        lock_guard<mutex> guard(mutex_);
+        Handle handle;
+        auto entry = Resolve(ref, handle) ? GetEntry(handle) : nullptr;
+        if (entry == nullptr || GetEntry(entry->owner_) == nullptr) {
+            return "";
+        }
+        return MakeRef(entry->owner_);
+    }
+
+    size_t BackendObjectTable::Release(string_view ref)
+    {
+        lock_guard<mutex> guard(mutex_);
+        Handle handle;
+        size_t count = 0;
+        if (Resolve(ref, handle) && GetEntry(handle) != nullptr) {
+            ReleaseEntry(handle, count);
+        }
+        return count;
+    }
+
+    void BackendObjectTable::ReleaseEntry(const Handle &handle, size_t &count)
+    {
+        auto entry = GetEntry(handle);
+        if (entry == nullptr) {
+            return;
+        }
+        // each released child removes itself from the children
+        while (!entry->children_.empty()) {
+            const auto child = entry->children_.back();
+            if (GetEntry(child) == nullptr) {
+                entry->children_.pop_back();
+                continue;
+            }
+            ReleaseEntry(child, count);
+        }
+        auto owner = GetEntry(entry->owner_);
+        if (owner != nullptr) {
+            // swap-remove from the children of the owner
+            auto &siblings = owner->children_;
+            const auto pos = entry->ownerPos_;
+            if (pos < siblings.size()) {
+                siblings[pos] = siblings.back();
+                siblings.pop_back();
+                if (pos < siblings.size()) {
+                    auto moved = GetEntry(siblings[pos]);
+                    if (moved != nullptr) {
+                        moved->ownerPos_ = pos;
+                    }
+                }
+            }
+        }
+        if (handle.slab_ == widgetSlab_) {
+            UnlinkLru(handle.slot_);
+            widgetMemory_ -= entry->memory_;
+            entry->memory_ = 0;
+        }
+        entry->object_ = nullptr;
+        entry->owner_ = Handle();
+        entry->children_.clear();
+        entry->generation_++;
+        slabs_[handle.slab_].freeSlots_.emplace_back(handle.slot_);
+        livingCount_--;
+        count++;
+    }
+
+    void BackendObjectTable::LinkLru(uint32_t slot)
+    {
+        auto &entries = slabs_[widgetSlab_].entries_;
+        entries[slot].lruPrev_ = NO_SLOT;
+        entries[slot].lruNext_ = lruHead_;
+        if (lruHead_ != NO_SLOT) {
+            entries[lruHead_].lruPrev_ = slot;
+        }
+        lruHead_ = slot;
+        lruTail_ = lruTail_ == NO_SLOT ? slot : lruTail_;
+    }
+
+    void BackendObjectTable::UnlinkLru(uint32_t slot)
+    {
+        auto &entries = slabs_[widgetSlab_].entries_;
+        auto &entry = entries[slot];
+        if (entry.lruPrev_ != NO_SLOT) {
+            entries[entry.lruPrev_].lruNext_ = entry.lruNext_;
+        } else {
+            lruHead_ = entry.lruNext_;
+        }
+        if (entry.lruNext_ != NO_SLOT) {
+            entries[entry.lruNext_].lruPrev_ = entry.lruPrev_;
+        } else {
+            lruTail_ = entry.lruPrev_;
+        }
+        entry.lruPrev_ = NO_SLOT;
+        entry.lruNext_ = NO_SLOT;
+    }
+
+    void BackendObjectTable::EvictWidgets()
+    {
+        size_t count = 0;
+        const auto protectedEpoch = activeEpochs_.empty() ? callEpoch_ : *activeEpochs_.begin();
+        while (widgetMemory_ > widgetMemoryLimit_ && lruTail_ != NO_SLOT) {
+            const auto &entry = slabs_[widgetSlab_].entries_[lruTail_];
+            if (entry.lastUseEpoch_ >= protectedEpoch) {
+                break; // may be used by the calls in progress, keep it and the more recent ones
+            }
+            ReleaseEntry(Handle {widgetSlab_, lruTail_, entry.generation_}, count);
+        }
+        if (count > 0) {
+            LOG_I("Evicted %{public}zu components, memory %{public}zu", count, widgetMemory_);
+        }
+    }
+} // namespace OHOS::uitest
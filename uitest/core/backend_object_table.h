@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BACKEND_OBJECT_TABLE_H
+#define BACKEND_OBJECT_TABLE_H
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "frontend_api_handler.h"
+
+namespace OHOS::uitest {
+    /**Table of the backend objects referred by the frontend. Objects of one type live in the slots of a slab, the
+     * reference "Type#N" encodes the slot and its generation in N, so a lookup takes no string map and a reference
+     * to a released slot is told stale. Objects bound to an owner (the driver of a session) are released along
+     * with it. The Component snapshots are kept within a memory limit, evicting the least recently used ones which
+     * are not used by the calls in progress. The found objects are valid until released by the caller, so the
+     * calls releasing objects must not run along with the others.*/
+    class BackendObjectTable {
+    public:
+        static constexpr size_t DEFAULT_WIDGET_MEMORY_LIMIT = 64 * 1024 * 1024;
+        static constexpr uint32_t SLOT_BITS = 20;
+
+        /**Start an api call, the objects it uses or stores are not evicted until it ends. Returns the epoch of
+         * the call to end with.*/
+        uint64_t BeginCall();
+
+        /**End the api call started by BeginCall.*/
+        void EndCall(uint64_t epoch);
+
+        /**Store the object and return its reference, bound to the living owner if ownerRef is given.*/
+        std::string Store(std::unique_ptr<BackendClass> object, std::string_view ownerRef = "");
+
+        /**Find the living object of the reference and mark it used, returns nullptr if it's released, evicted or
+         * not a reference of this table.*/
+        BackendClass *Find(std::string_view ref);
+
+        /**Find the owner of the living object of the reference, returns nullptr if none.*/
+        BackendClass *FindOwner(std::string_view ref);
+
+        /**Get the reference of the owner of the living object, returns empty string if none.*/
+        std::string GetOwnerRef(std::string_view ref);
+
+        /**Tells if the reference is in the format of this table, whether the object is living or not.*/
+        static bool IsObjectRef(std::string_view ref);
+
+        /**Release the object of the reference and the objects bound to it, returns the count of released ones.*/
+        size_t Release(std::string_view ref);
+
+        /**Set the bytes limit of the Component snapshots, exceeding ones are evicted on the next store.*/
+        void SetWidgetMemoryLimit(size_t bytes);
+
+        size_t GetWidgetMemory() const;
+
+        size_t GetLivingCount() const;
+
+    private:
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+        struct Handle {
+            uint32_t slab_ = NO_SLOT;
+            uint32_t slot_ = NO_SLOT;
+            uint32_t generation_ = 0;
+        };
+        struct Entry {
+            std::unique_ptr<BackendClass> object_;
+            // bumped on each release, so the references to the former objects are stale
+            uint32_t generation_ = 0;
+            Handle owner_;
+            // position in the children of the owner
+            size_t ownerPos_ = 0;
+            std::vector<Handle> children_;
+            // the least recently used list of the widgets, by slot
+            uint32_t lruPrev_ = NO_SLOT;
+            uint32_t lruNext_ = NO_SLOT;
+            uint64_t lastUseEpoch_ = 0;
+            size_t memory_ = 0;
+        };
+        struct Slab {
+            std::string_view typeName_;
+            std::vector<Entry> entries_;
+            std::vector<uint32_t> freeSlots_;
+        };
+        bool Resolve(std::string_view ref, Handle &handle) const;
+        std::string MakeRef(const Handle &handle) const;
+        Entry *GetEntry(const Handle &handle);
+        void ReleaseEntry(const Handle &handle, size_t &count);
+        void LinkLru(uint32_t slot);
+        void UnlinkLru(uint32_t slot);
+        void EvictWidgets();
+        mutable std::mutex mutex_;
+        std::vector<Slab> slabs_;
+        uint32_t widgetSlab_ = NO_SLOT;
+        // most and least recently used widgets
+        uint32_t lruHead_ = NO_SLOT;
+        uint32_t lruTail_ = NO_SLOT;
+        uint64_t callEpoch_ = 1;
+        // epochs of the calls in progress
+        std::multiset<uint64_t> activeEpochs_;
+        size_t widgetMemory_ = 0;
+        size_t widgetMemoryLimit_ = DEFAULT_WIDGET_MEMORY_LIMIT;
+        size_t livingCount_ = 0;
+    };
+
+    /**Holds an api call of the table from construction to destruction.*/
+    class BackendObjectCall {
+    public:
+        explicit BackendObjectCall(BackendObjectTable &table) : table_(table), epoch_(table.BeginCall()) {}
+
+        ~BackendObjectCall()
+        {
+            table_.EndCall(epoch_);
+        }
+
+        BackendObjectCall(const BackendObjectCall &) = delete;
+        BackendObjectCall &operator=(const BackendObjectCall &) = delete;
+
+    private:
+        BackendObjectTable &table_;
+        const uint64_t epoch_;
+    };
+} // namespace OHOS::uitest
+
+#endif
@@ -17,8 +17,12 @@
 #define COMMON_UTILITIES_HPP
 
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <string_view>
+#include <thread>
+#include <vector>
 #include "nlohmann/json.hpp"
 
 #ifdef __OHOS__
@@ -88,6 +92,30 @@ namespace OHOS::uitest {
         return defValue;
     }
 
+    // upper bound of the workers used to fetch windows and window nodes concurrently
+    constexpr size_t MAX_FETCH_WORKERS = 4;
+
+    /**Run task(0)..task(taskCount-1) on at most maxWorkers threads (the caller included), returns after all done.
+     * Each task must not throw and may only write the results indexed by its own argument.*/
+    inline void RunConcurrently(size_t taskCount, size_t maxWorkers, const std::function<void(size_t)> &task)
+    {
+        std::atomic<size_t> next = 0;
+        auto worker = [&next, taskCount, &task]() {
+            for (auto index = next++; index < taskCount; index = next++) {
+                task(index);
+            }
+        };
+        const auto workerCount = std::min(taskCount, maxWorkers);
+        std::vector<std::thread> threads;
+        for (size_t index = 1; index < workerCount; index++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &thread : threads) {
+            thread.join();
+        }
+    }
+
     // log tag length limit
     constexpr uint8_t MAX_LOG_TAG_LEN = 64;
 
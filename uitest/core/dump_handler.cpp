@@ -13,45 +13,35 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <unordered_map>
 #include "nlohmann/json.hpp"
+#include "json_stream_writer.h"
 #include "ui_model.h"
 
 namespace OHOS::uitest {
     using namespace std;
     using namespace nlohmann;
 
+    /**Tree of the widgets to dump keyed by their indexes, built once from the hierarchies.*/
     struct DumperCache {
-        std::map<std::string, int> visitWidgetMap_;
-        std::map<std::string, int> widgetCountMap_;
-        std::set<std::string> visibleWidgetHies_;
+        // children of each widget in the order of their positions in the parent
+        std::vector<std::vector<int>> children_;
+        // whether each widget is visible or has any visible descendant
+        std::vector<bool> subtreeVisible_;
         std::string extendedAttrs_ = "";
     };
 
-    static string_view GetMiddleStr(string_view str, size_t &index, string_view startStr, string_view endStr)
-    {
-        size_t ori = index;
-        auto begin = str.find(startStr, index);
-        if (begin != string::npos) {
-            index = begin + startStr.size();
-            auto end = str.find(endStr, index);
-            if (end != string::npos) {
-                string_view result = str.substr(index, end - index);
-                index = end;
-                return result;
-            }
-        }
-        index = ori;
-        return "";
-    }
+    using DumpAttrs = vector<pair<string_view, string>>;
 
-    static bool HasVisibleChild(const std::set<std::string> &visibleWidgetHies, const string &hie)
+    /**Visit the children of the widget to dump, the invisible ones are skipped unless they have visible descendants.*/
+    static void ForEachDumpChild(int index, const DumperCache &cache, const function<void(int)> &visitor)
     {
-        for (auto visibleHie : visibleWidgetHies) {
-            if (visibleHie.find(hie) != string::npos) {
-                return true;
+        for (auto child : cache.children_.at(index)) {
+            if (cache.subtreeVisible_.at(child)) {
+                visitor(child);
             }
         }
-        return false;
     }
 
     static void DFSMarshalWidget(std::vector<Widget> &allWidget, int index, nlohmann::json &dom,
@@ -60,93 +50,530 @@ namespace OHOS::uitest {
         auto attrData = json();
         allWidget.at(index).WrapperWidgetToJson(attrData, cache.extendedAttrs_);
         auto childrenData = json::array();
-        int childIndex = 0;
-        int childCount = 0;
-        int childVisit = 0;
-        auto hierarchy = allWidget.at(index).GetHierarchy();
-        if (cache.widgetCountMap_.find(hierarchy) != cache.widgetCountMap_.cend()) {
-            childCount = cache.widgetCountMap_.at(hierarchy);
-        }
-        while (childVisit < childCount) {
-            auto tempChildHierarchy = WidgetHierarchyBuilder::GetChildHierarchy(hierarchy, childIndex);
-            ++childIndex;
-            if (cache.visitWidgetMap_.find(tempChildHierarchy) == cache.visitWidgetMap_.cend()) {
-                continue;
+        ForEachDumpChild(index, cache, [&allWidget, &childrenData, &cache](int childIndex) {
+            auto childData = json();
+            DFSMarshalWidget(allWidget, childIndex, childData, cache);
+            childrenData.emplace_back(move(childData));
+        });
+        dom["attributes"] = move(attrData);
+        dom["children"] = move(childrenData);
+    }
+
+    void DumpHandler::IndexExtraAttrs(string_view elementTree, ExtraAttrsIndex &index)
+    {
+        constexpr string_view idStart = "AccessibilityId: ";
+        constexpr string_view nodeEnd = "|->";
+        constexpr string_view idEnd = " \r\n";
+        constexpr string_view attrSeparator = ": ";
+        constexpr string_view attrEnd = "\n";
+        constexpr string_view attrKeys[] = {"BackgroundColor: ", "Content: ", "FontColor: ", "FontSize: "};
+        // the info of a node runs from its accessibility id to the start of the next node
+        for (auto begin = elementTree.find(idStart); begin != string_view::npos;) {
+            begin += idStart.size();
+            auto end = elementTree.find(nodeEnd, begin);
+            if (end == string_view::npos) {
+                break;
             }
-            auto childWidIndex = cache.visitWidgetMap_.at(tempChildHierarchy);
-            if (!allWidget.at(childWidIndex).IsVisible()) {
-                if (!HasVisibleChild(cache.visibleWidgetHies_, tempChildHierarchy)) {
-                    ++childVisit;
+            auto idLen = min(elementTree.find_first_of(idEnd, begin), end) - begin;
+            auto accessibilityId = elementTree.substr(begin, idLen);
+            auto nodeInfo = elementTree.substr(begin + idLen, end - begin - idLen);
+            ExtraAttrs extraAttrs;
+            for (auto key : attrKeys) {
+                auto valueBegin = nodeInfo.find(key);
+                if (valueBegin == string_view::npos) {
                     continue;
                 }
+                valueBegin += key.size();
+                auto valueEnd = nodeInfo.find(attrEnd, valueBegin);
+                if (valueEnd != string_view::npos && valueEnd > valueBegin) {
+                    auto name = key.substr(0, key.size() - attrSeparator.size());
+                    extraAttrs.emplace_back(name, nodeInfo.substr(valueBegin, valueEnd - valueBegin));
+                }
             }
-            auto childData = json();
-            DFSMarshalWidget(allWidget, childWidIndex, childData, cache);
-            childrenData.emplace_back(childData);
-            ++childVisit;
+            if (!extraAttrs.empty()) {
+                index.emplace(accessibilityId, move(extraAttrs));
+            }
+            begin = elementTree.find(idStart, end);
+        }
+    }
+
+    /**Index the hidumper info of each window once for the whole dump.*/
+    static void IndexElementTrees(const map<int32_t, string_view> &elementTrees, map<int32_t, ExtraAttrsIndex> &out)
+    {
+        for (const auto &[windowId, elementTree] : elementTrees) {
+            DumpHandler::IndexExtraAttrs(elementTree, out[windowId]);
+        }
+    }
+
+    static const ExtraAttrs *FindExtraAttrs(const map<int32_t, ExtraAttrsIndex> &indexes, const string &windowIdStr,
+        string_view accessibilityId)
+    {
+        auto window = indexes.find(atoi(windowIdStr.c_str()));
+        if (window == indexes.end()) {
+            return nullptr;
         }
-        dom["attributes"] = attrData;
-        dom["children"] = childrenData;
+        auto find = window->second.find(accessibilityId);
+        return find != window->second.end() ? &(find->second) : nullptr;
     }
 
-    void DumpHandler::AddExtraAttrs(nlohmann::json &root, const map<int32_t, string_view> &elementTrees, size_t index)
+    static const string &GetJsonAttr(const json &attrs, const string &name)
     {
-        auto windowIdValue = root["attributes"]["hostWindowId"].dump();
-        auto windowId = atoi(windowIdValue.substr(1, windowIdValue.size() - 2).c_str());
-        auto find = elementTrees.find(windowId);
-        auto elementTree = (find != elementTrees.end()) ? find->second : "";
-        string_view nodeEndStr = "|->";
-        auto accessibilityIdInfo = root["attributes"]["accessibilityId"].dump();
-        auto accessibilityId = accessibilityIdInfo.substr(1, accessibilityIdInfo.size() - 2);
-        string_view accessibilityIdStr = "AccessibilityId: " + accessibilityId;
-        string_view nodeAttrStr = GetMiddleStr(elementTree, index, accessibilityIdStr, nodeEndStr);
-        auto extraAttrs = json();
-        size_t nodeAttrTraverlIndex = 0;
-        auto backgroundColor = GetMiddleStr(nodeAttrStr, nodeAttrTraverlIndex, "BackgroundColor: ", "\n");
-        auto content = GetMiddleStr(nodeAttrStr, nodeAttrTraverlIndex, "Content: ", "\n");
-        auto fontColor = GetMiddleStr(nodeAttrStr, nodeAttrTraverlIndex, "FontColor: ", "\n");
-        auto fontSize = GetMiddleStr(nodeAttrStr, nodeAttrTraverlIndex, "FontSize: ", "\n");
-        if (!backgroundColor.empty()) {
-            extraAttrs["BackgroundColor"] = backgroundColor;
+        static const string empty = "";
+        auto find = attrs.find(name);
+        return (find != attrs.end() && find->is_string()) ? find->get_ref<const string &>() : empty;
+    }
+
+    static void AddIndexedExtraAttrs(json &root, const map<int32_t, ExtraAttrsIndex> &indexes)
+    {
+        const auto &attrData = root["attributes"];
+        auto extraAttrs = FindExtraAttrs(indexes, GetJsonAttr(attrData, ATTR_NAMES[UiAttr::HOST_WINDOW_ID].data()),
+            GetJsonAttr(attrData, ATTR_NAMES[UiAttr::ACCESSIBILITY_ID].data()));
+        if (extraAttrs != nullptr) {
+            auto extraAttrsData = json();
+            for (const auto &[name, value] : *extraAttrs) {
+                extraAttrsData[string(name)] = value;
+            }
+            root["extraAttrs"] = move(extraAttrsData);
         }
-        if (!content.empty()) {
-            extraAttrs["Content"] = move(content);
+        for (auto &child : root["children"]) {
+            AddIndexedExtraAttrs(child, indexes);
         }
-        if (!fontColor.empty()) {
-            extraAttrs["FontColor"] = move(fontColor);
+    }
+
+    void DumpHandler::AddExtraAttrs(nlohmann::json &root, const map<int32_t, string_view> &elementTrees)
+    {
+        map<int32_t, ExtraAttrsIndex> indexes;
+        IndexElementTrees(elementTrees, indexes);
+        AddIndexedExtraAttrs(root, indexes);
+    }
+
+    static void BuildDumperCache(const DumpOption &option, const vector<Widget> &allWidget, DumperCache &cache)
+    {
+        const auto count = allWidget.size();
+        unordered_map<string, int> indexes;
+        indexes.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            indexes.emplace(allWidget.at(i).GetHierarchy(), i);
         }
-        if (!fontSize.empty()) {
-            extraAttrs["FontSize"] = move(fontSize);
+        // link each widget to its parent by the hierarchy, along with its position in the parent
+        vector<vector<pair<uint64_t, int>>> children(count);
+        for (size_t i = 0; i < count; ++i) {
+            const auto &hie = allWidget.at(i).GetHierarchy();
+            auto parent = indexes.find(WidgetHierarchyBuilder::GetParentWidgetHierarchy(hie));
+            const auto separator = hie.find_last_of(',');
+            if (parent == indexes.end() || separator == string::npos || indexes.at(hie) != static_cast<int>(i)) {
+                continue;
+            }
+            constexpr int decimal = 10;
+            auto position = strtoull(hie.c_str() + separator + 1, nullptr, decimal);
+            children.at(parent->second).emplace_back(position, i);
         }
-        if (!extraAttrs.empty()) {
-            root["extraAttrs"] = extraAttrs;
+        cache.children_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            sort(children[i].begin(), children[i].end());
+            for (const auto &child : children[i]) {
+                cache.children_[i].emplace_back(child.second);
+            }
         }
-        auto &childrenData = root["children"];
-        auto childCount = childrenData.size();
-        for (size_t idx = 0; idx < childCount; idx++) {
-            auto &child = childrenData.at(idx);
-            AddExtraAttrs(child, elementTrees, index);
+        // post-order pass from the root, each widget is settled after all of its descendants
+        cache.subtreeVisible_.assign(count, false);
+        vector<pair<int, size_t>> stack;
+        if (count > 0) {
+            stack.emplace_back(0, 0);
         }
+        while (!stack.empty()) {
+            const auto [index, next] = stack.back();
+            if (next < cache.children_[index].size()) {
+                stack.back().second++;
+                stack.emplace_back(cache.children_[index][next], 0);
+                continue;
+            }
+            bool visible = allWidget.at(index).IsVisible();
+            for (auto child : cache.children_[index]) {
+                visible = visible || cache.subtreeVisible_[child];
+            }
+            cache.subtreeVisible_[index] = visible;
+            stack.pop_back();
+        }
+        cache.extendedAttrs_ = option.extendedAttrs_;
     }
 
     void DumpHandler::DumpWindowInfoToJson(const DumpOption &option, vector<Widget> &allWidget, nlohmann::json &root)
     {
         DumperCache cache;
-        for (size_t i = 0; i < allWidget.size(); ++i) {
-            const Widget &wid = allWidget.at(i);
-            std::string hie = wid.GetHierarchy();
-            cache.visitWidgetMap_.emplace(hie, i);
-            std::string parentHie = WidgetHierarchyBuilder::GetParentWidgetHierarchy(hie);
-            if (cache.widgetCountMap_.find(parentHie) == cache.widgetCountMap_.cend()) {
-                cache.widgetCountMap_[parentHie] = 1;
-            } else {
-                cache.widgetCountMap_[parentHie] = cache.widgetCountMap_[parentHie] + 1;
+        BuildDumperCache(option, allWidget, cache);
+        DFSMarshalWidget(allWidget, 0, root, cache);
+    }
+
+    /**Set the attribute as nlohmann::json::operator[] does, a later value replaces the earlier one.*/
+    static void SetDumpAttr(DumpAttrs &attrs, string_view name, string value)
+    {
+        for (auto &attr : attrs) {
+            if (attr.first == name) {
+                attr.second = move(value);
+                return;
             }
-            if (wid.IsVisible()) {
-                cache.visibleWidgetHies_.insert(hie);
+        }
+        attrs.emplace_back(name, move(value));
+    }
+
+    static const string &GetDumpAttr(const DumpAttrs &attrs, string_view name)
+    {
+        static const string empty = "";
+        for (const auto &attr : attrs) {
+            if (attr.first == name) {
+                return attr.second;
             }
         }
-        cache.extendedAttrs_ = option.extendedAttrs_;
-        DFSMarshalWidget(allWidget, 0, root, cache);
+        return empty;
+    }
+
+    struct DumpStreamContext {
+        const map<int32_t, ExtraAttrsIndex> *extraAttrsIndexes_ = nullptr;
+        JsonStreamWriter &writer_;
+    };
+
+    /**Write one node with its children, the keys are written in the sorted order as nlohmann::json does.*/
+    static void StreamNode(DumpAttrs &attrs, const DumpStreamContext &context, const function<void()> &writeChildren)
+    {
+        auto &writer = context.writer_;
+        writer.BeginObject();
+        writer.Key("attributes");
+        sort(attrs.begin(), attrs.end(), [](const auto &left, const auto &right) {
+            return left.first < right.first;
+        });
+        writer.BeginObject();
+        for (const auto &[name, value] : attrs) {
+            writer.Key(name);
+            writer.String(value);
+        }
+        writer.EndObject();
+        const ExtraAttrs *extraAttrs = nullptr;
+        if (context.extraAttrsIndexes_ != nullptr) {
+            extraAttrs = FindExtraAttrs(*context.extraAttrsIndexes_,
+                GetDumpAttr(attrs, ATTR_NAMES[UiAttr::HOST_WINDOW_ID]),
+                GetDumpAttr(attrs, ATTR_NAMES[UiAttr::ACCESSIBILITY_ID]));
+        }
+        writer.Key("children");
+        writer.BeginArray();
+        writeChildren();
+        writer.EndArray();
+        if (extraAttrs != nullptr) {
+            writer.Key("extraAttrs");
+            writer.BeginObject();
+            for (const auto &[name, value] : *extraAttrs) {
+                writer.Key(name);
+                writer.String(value);
+            }
+            writer.EndObject();
+        }
+        writer.EndObject();
+    }
+
+    static void StreamMarshalWidget(const vector<Widget> &allWidget, int index, DumpAttrs &attrs,
+        const DumperCache &cache, const DumpStreamContext &context)
+    {
+        StreamNode(attrs, context, [&allWidget, index, &cache, &context]() {
+            ForEachDumpChild(index, cache, [&](int childIndex) {
+                DumpAttrs childAttrs;
+                allWidget.at(childIndex).WrapperWidgetToAttrs(childAttrs, cache.extendedAttrs_);
+                StreamMarshalWidget(allWidget, childIndex, childAttrs, cache, context);
+            });
+        });
+    }
+
+    static void StreamWindow(const DumpOption &option, const DumpWindow &window, const DumpStreamContext &context)
+    {
+        DumperCache cache;
+        BuildDumperCache(option, window.widgets_, cache);
+        DumpAttrs attrs;
+        window.widgets_.at(0).WrapperWidgetToAttrs(attrs, cache.extendedAttrs_);
+        SetDumpAttr(attrs, ATTR_NAMES[UiAttr::ABILITYNAME], window.window_->abilityName_);
+        SetDumpAttr(attrs, ATTR_NAMES[UiAttr::BUNDLENAME], window.window_->bundleName_);
+        SetDumpAttr(attrs, ATTR_NAMES[UiAttr::PAGEPATH], window.window_->pagePath_);
+        StreamMarshalWidget(window.widgets_, 0, attrs, cache, context);
+    }
+
+    void DumpHandler::DumpLayoutToStream(const DumpOption &option, const Rect &mergeBounds,
+        vector<DumpWindow> &windows, const map<int32_t, string_view> *elementTrees, JsonStreamWriter &writer)
+    {
+        if (option.listWindows_) {
+            const DumpStreamContext context = {nullptr, writer};
+            writer.BeginArray();
+            for (const auto &window : windows) {
+                StreamWindow(option, window, context);
+            }
+            writer.EndArray();
+            return;
+        }
+        map<int32_t, ExtraAttrsIndex> extraAttrsIndexes;
+        if (elementTrees != nullptr) {
+            IndexElementTrees(*elementTrees, extraAttrsIndexes);
+        }
+        const DumpStreamContext context = {elementTrees != nullptr ? &extraAttrsIndexes : nullptr, writer};
+        DumpAttrs rootAttrs;
+        for (int i = 0; i < UiAttr::HIERARCHY; ++i) {
+            rootAttrs.emplace_back(ATTR_NAMES[i], "");
+        }
+        std::stringstream ss;
+        ss << "[" << mergeBounds.left_ << "," << mergeBounds.top_ << "]"
+           << "[" << mergeBounds.right_ << "," << mergeBounds.bottom_ << "]";
+        SetDumpAttr(rootAttrs, ATTR_NAMES[UiAttr::BOUNDS], ss.str());
+        StreamNode(rootAttrs, context, [&option, &windows, &context]() {
+            for (const auto &window : windows) {
+                StreamWindow(option, window, context);
+            }
+        });
+    }
+
+    /**Node of a layout keyed by its hashcode, the root is an array of windows if they are listed.*/
+    struct LayoutNode {
+        const json *node_ = nullptr;
+        vector<string> children_;
+    };
+
+    static const string LAYOUT_ROOT_KEY = "";
+
+    static const json &GetLayoutChildren(const json &node)
+    {
+        static const json empty = json::array();
+        if (node.is_array()) {
+            return node;
+        }
+        auto find = node.find("children");
+        return (find != node.end() && find->is_array()) ? *find : empty;
+    }
+
+    static const json &GetLayoutMember(const json &node, const char *name)
+    {
+        static const json null = nullptr;
+        if (!node.is_object()) {
+            return null;
+        }
+        auto find = node.find(name);
+        return find != node.end() ? *find : null;
+    }
+
+    static bool FlattenLayout(const json &layout, unordered_map<string, LayoutNode> &nodes, ApiCallErr &error)
+    {
+        vector<pair<string, const json *>> stack = {{LAYOUT_ROOT_KEY, &layout}};
+        while (!stack.empty()) {
+            auto [key, node] = move(stack.back());
+            stack.pop_back();
+            auto &flatNode = nodes[key];
+            flatNode.node_ = node;
+            for (const auto &child : GetLayoutChildren(*node)) {
+                const auto &hashcode = GetJsonAttr(GetLayoutMember(child, "attributes"),
+                    ATTR_NAMES[UiAttr::HASHCODE].data());
+                if (hashcode.empty() || nodes.find(hashcode) != nodes.end()) {
+                    error = ApiCallErr(ERR_INVALID_INPUT, "Node without unique hashcode: " + hashcode);
+                    return false;
+                }
+                // reserve the key so that a duplicated one is found before its node is visited
+                nodes.emplace(hashcode, LayoutNode());
+                flatNode.children_.emplace_back(hashcode);
+                stack.emplace_back(hashcode, &child);
+            }
+        }
+        return true;
+    }
+
+    static void DiffLayoutNode(const json &base, const json &node, json &change)
+    {
+        const auto &baseAttrs = GetLayoutMember(base, "attributes");
+        const auto &attrs = GetLayoutMember(node, "attributes");
+        for (auto attr = attrs.cbegin(); attrs.is_object() && attr != attrs.cend(); ++attr) {
+            auto find = baseAttrs.find(attr.key());
+            if (find == baseAttrs.end() || *find != attr.value()) {
+                change["attributes"][attr.key()] = attr.value();
+            }
+        }
+        for (auto attr = baseAttrs.cbegin(); baseAttrs.is_object() && attr != baseAttrs.cend(); ++attr) {
+            if (attrs.find(attr.key()) == attrs.end()) {
+                change["removedAttributes"].emplace_back(attr.key());
+            }
+        }
+        const auto &extraAttrs = GetLayoutMember(node, "extraAttrs");
+        if (extraAttrs != GetLayoutMember(base, "extraAttrs")) {
+            // null means the extraAttrs is removed
+            change["extraAttrs"] = extraAttrs;
+        }
+    }
+
+    void DumpHandler::DiffLayout(const json &base, const json &layout, json &diff, ApiCallErr &error)
+    {
+        unordered_map<string, LayoutNode> baseNodes;
+        unordered_map<string, LayoutNode> nodes;
+        if (!FlattenLayout(base, baseNodes, error) || !FlattenLayout(layout, nodes, error)) {
+            return;
+        }
+        auto added = json::object();
+        auto changed = json::object();
+        auto removed = json::array();
+        for (const auto &[key, node] : nodes) {
+            auto find = baseNodes.find(key);
+            if (find == baseNodes.end()) {
+                auto &addedNode = added[key];
+                addedNode["attributes"] = GetLayoutMember(*node.node_, "attributes");
+                const auto &extraAttrs = GetLayoutMember(*node.node_, "extraAttrs");
+                if (!extraAttrs.is_null()) {
+                    addedNode["extraAttrs"] = extraAttrs;
+                }
+                addedNode["children"] = node.children_;
+                continue;
+            }
+            auto change = json::object();
+            DiffLayoutNode(*find->second.node_, *node.node_, change);
+            if (node.children_ != find->second.children_) {
+                change["children"] = node.children_;
+            }
+            if (!change.empty()) {
+                changed[key] = move(change);
+            }
+        }
+        vector<string> removedKeys;
+        for (const auto &[key, node] : baseNodes) {
+            if (nodes.find(key) == nodes.end()) {
+                removedKeys.emplace_back(key);
+            }
+        }
+        sort(removedKeys.begin(), removedKeys.end());
+        diff = json::object();
+        diff["list"] = layout.is_array();
+        diff["added"] = move(added);
+        diff["changed"] = move(changed);
+        diff["removed"] = move(removedKeys);
+    }
+
+    void DumpHandler::DiffLayoutWithLast(json &last, const json &layout, json &out)
+    {
+        auto error = ApiCallErr(NO_ERROR);
+        json diff;
+        if (!last.is_null()) {
+            DiffLayout(last, layout, diff, error);
+        }
+        out = json::object();
+        out["diff"] = !last.is_null() && error.code_ == NO_ERROR;
+        out["layout"] = out["diff"].get<bool>() ? move(diff) : layout;
+        last = layout;
+    }
+
+    /**Node of a layout being rebuilt, the extraAttrs is null if there is none.*/
+    struct RebuiltNode {
+        json attributes_;
+        json extraAttrs_;
+        vector<string> children_;
+    };
+
+    static bool ApplyNodeChange(RebuiltNode &node, const json &change)
+    {
+        const auto &attrs = GetLayoutMember(change, "attributes");
+        for (auto attr = attrs.cbegin(); attrs.is_object() && attr != attrs.cend(); ++attr) {
+            node.attributes_[attr.key()] = attr.value();
+        }
+        const auto &removedAttrs = GetLayoutMember(change, "removedAttributes");
+        for (auto name = removedAttrs.cbegin(); removedAttrs.is_array() && name != removedAttrs.cend(); ++name) {
+            if (!name->is_string() || !node.attributes_.is_object()) {
+                return false;
+            }
+            node.attributes_.erase(name->get<string>());
+        }
+        if (change.contains("extraAttrs")) {
+            node.extraAttrs_ = change.at("extraAttrs");
+        }
+        const auto &children = GetLayoutMember(change, "children");
+        if (children.is_array()) {
+            node.children_.clear();
+            for (const auto &child : children) {
+                if (!child.is_string()) {
+                    return false;
+                }
+                node.children_.emplace_back(child.get<string>());
+            }
+        }
+        return true;
+    }
+
+    static bool BuildLayoutNode(unordered_map<string, RebuiltNode> &nodes, const string &key, json &out)
+    {
+        auto find = nodes.find(key);
+        // each node is moved out once, so a node referred twice or a loop is rejected
+        if (find == nodes.end() || find->second.attributes_.is_discarded()) {
+            return false;
+        }
+        auto node = move(find->second);
+        find->second.attributes_ = json(json::value_t::discarded);
+        auto children = json::array();
+        for (const auto &childKey : node.children_) {
+            auto child = json();
+            if (!BuildLayoutNode(nodes, childKey, child)) {
+                return false;
+            }
+            children.emplace_back(move(child));
+        }
+        if (key == LAYOUT_ROOT_KEY && node.attributes_.is_null()) {
+            out = move(children);
+            return true;
+        }
+        out["attributes"] = move(node.attributes_);
+        out["children"] = move(children);
+        if (!node.extraAttrs_.is_null()) {
+            out["extraAttrs"] = move(node.extraAttrs_);
+        }
+        return true;
+    }
+
+    static bool ApplyLayoutChanges(unordered_map<string, RebuiltNode> &nodes, const json &diff)
+    {
+        const auto &removed = GetLayoutMember(diff, "removed");
+        const auto &added = GetLayoutMember(diff, "added");
+        const auto &changed = GetLayoutMember(diff, "changed");
+        if (!removed.is_array() || !added.is_object() || !changed.is_object()) {
+            return false;
+        }
+        for (const auto &key : removed) {
+            if (!key.is_string() || nodes.erase(key.get<string>()) == 0) {
+                return false;
+            }
+        }
+        for (auto node = added.cbegin(); node != added.cend(); ++node) {
+            RebuiltNode rebuilt;
+            rebuilt.attributes_ = GetLayoutMember(node.value(), "attributes");
+            rebuilt.extraAttrs_ = GetLayoutMember(node.value(), "extraAttrs");
+            if (!ApplyNodeChange(rebuilt, json {{"children", GetLayoutMember(node.value(), "children")}})) {
+                return false;
+            }
+            nodes[node.key()] = move(rebuilt);
+        }
+        for (auto change = changed.cbegin(); change != changed.cend(); ++change) {
+            auto find = nodes.find(change.key());
+            if (find == nodes.end() || !ApplyNodeChange(find->second, change.value())) {
+                return false;
+            }
+        }
+        if (diff.value("list", false)) {
+            nodes[LAYOUT_ROOT_KEY].attributes_ = nullptr;
+        }
+        return true;
+    }
+
+    void DumpHandler::ApplyLayoutDiff(const json &base, const json &diff, json &layout, ApiCallErr &error)
+    {
+        unordered_map<string, LayoutNode> baseNodes;
+        if (!FlattenLayout(base, baseNodes, error)) {
+            return;
+        }
+        unordered_map<string, RebuiltNode> nodes;
+        for (const auto &[key, node] : baseNodes) {
+            auto &rebuilt = nodes[key];
+            rebuilt.attributes_ = GetLayoutMember(*node.node_, "attributes");
+            rebuilt.extraAttrs_ = GetLayoutMember(*node.node_, "extraAttrs");
+            rebuilt.children_ = node.children_;
+        }
+        layout = json();
+        if (!ApplyLayoutChanges(nodes, diff) || !BuildLayoutNode(nodes, LAYOUT_ROOT_KEY, layout)) {
+            error = ApiCallErr(ERR_INVALID_INPUT, "The layout diff does not apply to the base layout");
+            layout = nullptr;
+        }
     }
-} // namespace OHOS::uitest
\ No newline at end of file
+} // namespace OHOS::uitest
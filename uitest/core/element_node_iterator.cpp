@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unordered_map>
+#include "element_node_iterator.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    void ElementNodeIndex::Build(size_t count, const function<int64_t(size_t)> &idOf,
+        const function<int32_t(size_t)> &childCountOf, const function<int64_t(size_t, int32_t)> &childIdOf)
+    {
+        firstChild_.assign(count, NO_NODE);
+        childCount_.assign(count, 0);
+        visitedParent_.assign(count, NO_NODE);
+        visitedDepth_.assign(count, 0);
+        visitRound_.assign(count, 0);
+        invisibleRound_.assign(count, 0);
+        round_ = 1;
+        visitedCount_ = 0;
+        vector<int64_t> ids(count);
+        unordered_map<int64_t, int32_t> positions;
+        positions.reserve(count);
+        for (size_t index = 0; index < count; index++) {
+            ids[index] = idOf(index);
+            // keep the first position of duplicated ids
+            positions.emplace(ids[index], static_cast<int32_t>(index));
+        }
+        for (size_t index = 0; index < count; index++) {
+            const auto declared = childCountOf(index);
+            if (declared <= 0) {
+                continue;
+            }
+            const auto firstId = childIdOf(index, 0);
+            auto find = positions.find(firstId);
+            if (find == positions.end()) {
+                continue;
+            }
+            auto first = static_cast<size_t>(find->second);
+            if (first <= index) {
+                // the id is duplicated, the child is the first one after its parent
+                first = index + 1;
+                while (first < count && ids[first] != firstId) {
+                    first++;
+                }
+                if (first >= count) {
+                    continue;
+                }
+            }
+            int32_t located = 1;
+            while (located < declared && first + located < count) {
+                const auto expectId = childIdOf(index, located);
+                if (ids[first + located] != expectId) {
+                    LOG_E("Node error, except: %{public}s, actual is %{public}s", to_string(expectId).data(),
+                          to_string(ids[first + located]).data());
+                    break;
+                }
+                located++;
+            }
+            firstChild_[index] = static_cast<int32_t>(first);
+            childCount_[index] = located;
+        }
+    }
+
+    size_t ElementNodeIndex::Size() const
+    {
+        return firstChild_.size();
+    }
+
+    int32_t ElementNodeIndex::GetChildCount(int32_t index) const
+    {
+        if (index < 0 || static_cast<size_t>(index) >= childCount_.size()) {
+            return 0;
+        }
+        return childCount_[index];
+    }
+
+    int32_t ElementNodeIndex::GetFirstChild(int32_t index) const
+    {
+        if (index < 0 || static_cast<size_t>(index) >= firstChild_.size()) {
+            return NO_NODE;
+        }
+        return firstChild_[index];
+    }
+
+    int32_t ElementNodeIndex::GetChildSlot(int32_t parent, int32_t child) const
+    {
+        const auto first = GetFirstChild(parent);
+        if (first == NO_NODE || child < first || child - first >= childCount_[parent]) {
+            return NO_NODE;
+        }
+        return child - first;
+    }
+
+    void ElementNodeIndex::ClearVisit()
+    {
+        visitedCount_ = 0;
+        round_++;
+        if (round_ == 0) {
+            fill(visitRound_.begin(), visitRound_.end(), 0);
+            fill(invisibleRound_.begin(), invisibleRound_.end(), 0);
+            round_ = 1;
+        }
+    }
+
+    void ElementNodeIndex::MarkVisited(int32_t index, int32_t parent)
+    {
+        if (index < 0 || static_cast<size_t>(index) >= visitRound_.size()) {
+            return;
+        }
+        if (visitRound_[index] != round_) {
+            visitRound_[index] = round_;
+            visitedParent_[index] = parent;
+            visitedDepth_[index] = IsVisited(parent) ? visitedDepth_[parent] + 1 : 0;
+            visitedCount_++;
+        }
+        invisibleRound_[index] = 0;
+    }
+
+    void ElementNodeIndex::MarkInvisible(int32_t index)
+    {
+        if (index < 0 || static_cast<size_t>(index) >= invisibleRound_.size()) {
+            return;
+        }
+        invisibleRound_[index] = round_;
+    }
+
+    bool ElementNodeIndex::IsVisited(int32_t index) const
+    {
+        return index >= 0 && static_cast<size_t>(index) < visitRound_.size() && visitRound_[index] == round_;
+    }
+
+    bool ElementNodeIndex::IsVisitedAndVisible(int32_t index) const
+    {
+        return IsVisited(index) && invisibleRound_[index] != round_;
+    }
+
+    int32_t ElementNodeIndex::GetVisitedParent(int32_t index) const
+    {
+        return IsVisited(index) ? visitedParent_[index] : NO_NODE;
+    }
+
+    int32_t ElementNodeIndex::GetVisitedDepth(int32_t index) const
+    {
+        return IsVisited(index) ? visitedDepth_[index] : 0;
+    }
+
+    size_t ElementNodeIndex::GetVisitedCount() const
+    {
+        return visitedCount_;
+    }
+} // namespace OHOS::uitest
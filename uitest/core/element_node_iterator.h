@@ -16,9 +16,62 @@
 #ifndef ELEMENT_NODE_ITERATOR_H
 #define ELEMENT_NODE_ITERATOR_H
 
+#include <functional>
 #include "ui_model.h"
 
 namespace OHOS::uitest {
+    /**Flat index of the nodes batch of one window, built once when the batch arrives. The children of one node
+     * are contiguous in the batch, the first one is located by accessibility id. The visit marks are kept along,
+     * so that each traversal step and the traversal reset are O(1).*/
+    class ElementNodeIndex {
+    public:
+        static constexpr int32_t NO_NODE = -1;
+
+        /**Build the index, idOf(index) gives the accessibility id, childIdOf(index, slot) the declared children.*/
+        void Build(size_t count, const std::function<int64_t(size_t)> &idOf,
+            const std::function<int32_t(size_t)> &childCountOf,
+            const std::function<int64_t(size_t, int32_t)> &childIdOf);
+
+        size_t Size() const;
+
+        /**Count of the children located in the batch, which may be less than the declared one.*/
+        int32_t GetChildCount(int32_t index) const;
+
+        int32_t GetFirstChild(int32_t index) const;
+
+        /**Slot of the child among the children of the parent, NO_NODE if it's not a child of the parent.*/
+        int32_t GetChildSlot(int32_t parent, int32_t child) const;
+
+        void ClearVisit();
+
+        /**Mark the node visited and visible, the parent of a visited node is kept.*/
+        void MarkVisited(int32_t index, int32_t parent);
+
+        void MarkInvisible(int32_t index);
+
+        bool IsVisited(int32_t index) const;
+
+        bool IsVisitedAndVisible(int32_t index) const;
+
+        /**Parent recorded when visiting the node, NO_NODE for the root.*/
+        int32_t GetVisitedParent(int32_t index) const;
+
+        /**Depth of the visited node, 0 for the root.*/
+        int32_t GetVisitedDepth(int32_t index) const;
+
+        size_t GetVisitedCount() const;
+
+    private:
+        std::vector<int32_t> firstChild_;
+        std::vector<int32_t> childCount_;
+        std::vector<int32_t> visitedParent_;
+        std::vector<int32_t> visitedDepth_;
+        std::vector<uint32_t> visitRound_;
+        std::vector<uint32_t> invisibleRound_;
+        uint32_t round_ = 1;
+        size_t visitedCount_ = 0;
+    };
+
     class ElementNodeIterator {
     public:
         ElementNodeIterator() = default;
@@ -37,10 +90,11 @@ namespace OHOS::uitest {
         int currentIndex_ = -1;
         int topIndex_ = 0;
         int lastCurrentIndex_ = -1;
-        std::map<int, int> elementToParentIndexMap_;
-        std::set<int> visitAndVisibleIndexSet_;
-        std::map<int, Rect> elementIndexToRectMap_;
-        std::map<int, std::string> elementIndexToHierarch_;
+        ElementNodeIndex nodeIndex_;
+        // hierarchy of the visited nodes, indexed by node position
+        std::vector<std::string> nodeHierarchies_;
+        // attribute values of the widgets wrapped from this snapshot
+        std::shared_ptr<AttrStringPool> attrPool_ = std::make_shared<AttrStringPool>();
     };
 } // namespace OHOS::uitest
 
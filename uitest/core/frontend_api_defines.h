@@ -292,6 +292,22 @@ namespace OHOS::uitest {
         sizeof(KEY_OPTIONS_PROPERTIES) / sizeof(FrontEndJsonPropDef),
     };
 
+    /** BatchStep jsonObject definition, the "this" and "args" are checked when the step is called.*/
+    constexpr FrontEndJsonPropDef BATCH_STEP_PROPERTIES[] = {
+        {"api", "string", true},
+        {"this", "any", false}, // the caller, defaults to the driver executing the batch
+        {"args", "[any]", false},
+    };
+    constexpr FrontEndJsonDef BATCH_STEP_DEF = {
+        "BatchStep",
+        BATCH_STEP_PROPERTIES,
+        sizeof(BATCH_STEP_PROPERTIES) / sizeof(FrontEndJsonPropDef),
+    };
+
+    /** Reference to the result of a former batch step, like {"$step": 0} or {"$step": 0, "$index": 1}.*/
+    constexpr std::string_view BATCH_STEP_REF = "$step";
+    constexpr std::string_view BATCH_STEP_REF_INDEX = "$index";
+
     /** By class definition. deprecated since api 9*/
     constexpr FrontendMethodDef BY_METHODS[] = {
         {"By.id", "(int):By", false, true},
@@ -398,6 +414,9 @@ namespace OHOS::uitest {
         {"Driver.findComponent", "(On):Component", false, false},
         {"Driver.findWindow", "(WindowFilter):UiWindow", false, false},
         {"Driver.findComponents", "(On):[Component]", false, false},
+        {"Driver.findComponentsBatch", "([On]):[[Component]]", false, false, true},
+        {"Driver.findComponentAt", "(Point):Component", false, false, true},
+        {"Driver.executeBatch", "([BatchStep]):[any]", false, false, true},
         {"Driver.waitForComponent", "(On,int):Component", false, false},
         {"Driver.screenCap", "(int,int?):bool", false, false},            // fliePath as fileDescription.
         {"Driver.screenCapture", "(int, Rect?):bool", false, false}, // fliePath as fileDescription.
@@ -556,18 +575,19 @@ namespace OHOS::uitest {
     };
 
     /** List all the frontend data-type definitions.*/
-    const auto FRONTEND_CLASS_DEFS = {&BY_DEF, &UI_DRIVER_DEF, &UI_COMPONENT_DEF, &ON_DEF,
+    constexpr auto FRONTEND_CLASS_DEFS = {&BY_DEF, &UI_DRIVER_DEF, &UI_COMPONENT_DEF, &ON_DEF,
                                       &DRIVER_DEF, &COMPONENT_DEF, &UI_WINDOW_DEF, &POINTER_MATRIX_DEF,
                                       &UI_EVENT_OBSERVER_DEF};
     const auto FRONTEND_ENUMERATOR_DEFS = {&MATCH_PATTERN_DEF, &WINDOW_MODE_DEF, &RESIZE_DIRECTION_DEF,
                                            &DISPLAY_ROTATION_DEF, &MOUSE_BUTTON_DEF, &UI_DIRECTION_DEF,
                                            &WINDOW_CHANGE_TYPE_DEF, &COMPONENT_EVENT_TYPE_DEF,
                                            &PEN_KEY_DEF, &PEN_MODE_DEF, &PEN_KEY_OPERATION_DEF};
-    const auto FRONTEND_JSON_DEFS = {&RECT_DEF, &POINT_DEF, &WINDOW_FILTER_DEF, &UI_ELEMENT_INFO_DEF,
+    constexpr auto FRONTEND_JSON_DEFS = {&RECT_DEF, &POINT_DEF, &WINDOW_FILTER_DEF, &UI_ELEMENT_INFO_DEF,
                                      &TOUCH_PAD_SWIPE_OPTIONS_DEF, &INPUTTEXT_MODE_DEF,
                                      &WINDOW_CHANGE_OPTIONS_DEF,
                                      &COMPONENT_EVENT_OPTIONS_DEF,
-                                     &TOUCH_OPTIONS_DEF, &KEY_OPTIONS_DEF, &PEN_KEY_OPERATION_OPTIONS_DEF};
+                                     &TOUCH_OPTIONS_DEF, &KEY_OPTIONS_DEF, &PEN_KEY_OPERATION_OPTIONS_DEF,
+                                     &BATCH_STEP_DEF};
     /** The allowed in/out data type scope of frontend apis.*/
     const std::initializer_list<std::string_view> DATA_TYPE_SCOPE = {
         "int",
@@ -594,6 +614,7 @@ namespace OHOS::uitest {
         TOUCH_OPTIONS_DEF.name_,
         KEY_OPTIONS_DEF.name_,
         PEN_KEY_OPERATION_OPTIONS_DEF.name_,
+        BATCH_STEP_DEF.name_,
     };
 } // namespace OHOS::uitest
 
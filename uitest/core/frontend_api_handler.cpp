@@ -23,6 +23,8 @@
 #include "window_operator.h"
 #include "ui_controller.h"
 #include "frontend_api_handler.h"
+#include "frontend_api_tables.h"
+#include "backend_object_table.h"
 
 namespace OHOS::uitest {
     using namespace std;
@@ -198,95 +200,7 @@ namespace OHOS::uitest {
         map<string, int> refCountMap_;
     };
 
-    struct ApiMethod {
-        string_view apiId_ = "";
-        vector<string> paramTypes_;
-        size_t defaultArgCount_ = 0;
-        bool convertError_ = false;
-    };
-    /** API argument type list map.*/
-    static multimap<string, ApiMethod> sApiArgTypesMap;
-
-    static void ParseMethodSignature(string_view signature, vector<string> &types, size_t &defArg)
-    {
-        int charIndex = 0;
-        constexpr size_t BUF_LEN = 32;
-        char buf[BUF_LEN] = {0};
-        size_t tokenLen = 0;
-        size_t defArgCount = 0;
-        string token;
-        for (char ch : signature) {
-            if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) {
-                buf[tokenLen++] = ch;
-            } else if (ch == '?') {
-                defArgCount++;
-            } else if (ch == ',' || ch == '?' || ch == ')') {
-                if (tokenLen > 0) {
-                    token = string_view(buf, tokenLen);
-                    DCHECK(find(DATA_TYPE_SCOPE.begin(), DATA_TYPE_SCOPE.end(), token) != DATA_TYPE_SCOPE.end());
-                    types.emplace_back(token);
-                }
-                tokenLen = 0; // consume token and reset buffer
-                if (ch == ')') {
-                    // add return value type to the end of types.
-                    string retType = string(signature.substr(charIndex + 2));
-                    types.emplace_back(retType);
-                    break; // end parsing
-                }
-            }
-            charIndex++;
-        }
-        defArg = defArgCount;
-    }
-
-    /** Parse frontend method definitions to collect type information.*/
-    static void ParseFrontendMethodsSignature()
-    {
-        for (auto classDef : FRONTEND_CLASS_DEFS) {
-            LOG_D("parse class %{public}s", string(classDef->name_).c_str());
-            if (classDef->methods_ == nullptr || classDef->methodCount_ <= 0) {
-                continue;
-            }
-            for (size_t idx = 0; idx < classDef->methodCount_; idx++) {
-                auto methodDef = classDef->methods_[idx];
-                auto paramTypes = vector<string>();
-                size_t hasDefaultArg = 0;
-                ParseMethodSignature(methodDef.signature_, paramTypes, hasDefaultArg);
-                ApiMethod method {methodDef.name_, paramTypes, hasDefaultArg, methodDef.convertError_};
-                sApiArgTypesMap.insert(make_pair(string(methodDef.name_), method));
-            }
-        }
-    }
-
-    static void ParseExtensionMethodsSignature()
-    {
-        auto paramTypesForGetAllProperties = vector<string>();
-        paramTypesForGetAllProperties.push_back("");
-        string getAllProperties = "Component.getAllProperties";
-        ApiMethod methodForGetAllProperties{getAllProperties, paramTypesForGetAllProperties, 0, false};
-        sApiArgTypesMap.insert(make_pair(getAllProperties, methodForGetAllProperties));
-
-        auto paramTypesForAamsWorkMode = vector<string>();
-        paramTypesForAamsWorkMode.push_back("int");
-        paramTypesForAamsWorkMode.push_back("");
-        string setAamsWorkMode = "Driver.SetAamsWorkMode";
-        ApiMethod methodForAamsWorkMode {setAamsWorkMode, paramTypesForAamsWorkMode, 0, false};
-        sApiArgTypesMap.insert(make_pair(setAamsWorkMode, methodForAamsWorkMode));
-
-        auto paramTypesForCloseAamsEvent = vector<string>();
-        paramTypesForCloseAamsEvent.push_back("");
-        string closeAamsEvent = "Driver.CloseAamsEvent";
-        ApiMethod methodForCloseAamsEvent{closeAamsEvent, paramTypesForCloseAamsEvent, 0, false};
-        sApiArgTypesMap.insert(make_pair(closeAamsEvent, methodForCloseAamsEvent));
-
-        auto paramTypesForOpenAamsEvent = vector<string>();
-        paramTypesForOpenAamsEvent.push_back("");
-        string openAamsEvent = "Driver.OpenAamsEvent";
-        ApiMethod methodForOpenAamsEvent{openAamsEvent, paramTypesForOpenAamsEvent, 0, false};
-        sApiArgTypesMap.insert(make_pair(openAamsEvent, methodForOpenAamsEvent));
-    }
-
-    static string GetClassName(const string &apiName, char splitter)
+    static string_view GetClassName(string_view apiName, char splitter)
     {
         auto classNameLen = apiName.find(splitter);
         if (classNameLen == std::string::npos) {
@@ -295,7 +209,7 @@ namespace OHOS::uitest {
         return apiName.substr(0, classNameLen);
     }
 
-    static string CheckAndDoApiMapping(string_view apiName, char splitter, const map<string, string> &apiMap)
+    static string CheckAndDoApiMapping(string_view apiName, char splitter, const ApiNameMap &apiMap)
     {
         string output = string(apiName);
         auto classNameLen = output.find(splitter);
@@ -319,6 +233,7 @@ namespace OHOS::uitest {
 
     FrontendApiServer::FrontendApiServer()
     {
+        apiHandlers_.resize(FRONTEND_METHOD_COUNT);
         old2NewApiMap_["By"] = "On";
         old2NewApiMap_["UiDriver"] = "Driver";
         old2NewApiMap_["UiComponent"] = "Component";
@@ -353,13 +268,12 @@ namespace OHOS::uitest {
     string FrontendApiServer::ApiMapPre(ApiCallInfo &inModifier) const
     {
         // 0. add convert error label
-        const auto find = sApiArgTypesMap.find(inModifier.apiId_);
-        if (find != sApiArgTypesMap.end()) {
-            inModifier.convertError_ = find->second.convertError_;
+        const auto method = FindFrontendApi(inModifier.apiId_);
+        if (method != NO_API_METHOD) {
+            inModifier.convertError_ = FRONTEND_API_TABLES.methods_[method].convertError_;
         }
         // 1. map method name
-        const string &className = GetClassName(inModifier.apiId_, '.');
-        const auto result = old2NewApiMap_.find(className);
+        const auto result = old2NewApiMap_.find(GetClassName(inModifier.apiId_, '.'));
         if (result == old2NewApiMap_.end()) {
             auto iter = old2NewApiMap_.find(inModifier.apiId_);
             if (iter != old2NewApiMap_.end()) {
@@ -369,6 +283,7 @@ namespace OHOS::uitest {
             }
             return "";
         }
+        const string &className = result->first;
         string oldApiName = inModifier.apiId_;
         inModifier.apiId_ = CheckAndDoApiMapping(inModifier.apiId_, '.', old2NewApiMap_);
         LOG_D("Modify call name to %{public}s", inModifier.apiId_.c_str());
@@ -379,19 +294,19 @@ namespace OHOS::uitest {
         }
         // 3. map parameters
         // find method signature of old api
-        if (find == sApiArgTypesMap.end()) {
+        if (method == NO_API_METHOD) {
             return oldApiName;
         }
-        const auto &argTypes = find->second.paramTypes_;
+        const auto &signature = FRONTEND_API_TABLES.methods_[method];
         size_t argCount = inModifier.paramList_.size();
-        if (argTypes.size() - 1 < argCount) {
+        if (signature.maxArgc_ < argCount) {
             // parameter number invalid
             return oldApiName;
         }
         for (size_t i = 0; i < argCount; i++) {
             auto &argItem = inModifier.paramList_.at(i);
-            const string &argType = argTypes.at(i);
-            if (argType != "string" && argItem.type() == value_t::string) {
+            const auto &validator = FRONTEND_API_TABLES.args_[signature.argStart_ + i];
+            if ((validator.array_ || validator.type_ != "string") && argItem.type() == value_t::string) {
                 argItem = CheckAndDoApiMapping(argItem.get<string>(), '#', old2NewApiMap_);
             }
         }
@@ -416,11 +331,11 @@ namespace OHOS::uitest {
         // 1. error code conversion
         ErrCodeMapping(out.exception_);
         // 2. ret value conversion
-        const auto find = sApiArgTypesMap.find(oldApiName);
-        if (find == sApiArgTypesMap.end()) {
+        const auto method = FindFrontendApi(oldApiName);
+        if (method == NO_API_METHOD) {
             return;
         }
-        string &retType = find->second.paramTypes_.back();
+        const auto retType = FRONTEND_API_TABLES.methods_[method].returnType_;
         if ((retType == "string") || (retType == "[string]")) {
             return;
         }
@@ -446,7 +361,22 @@ namespace OHOS::uitest {
         if (handler == nullptr) {
             return;
         }
-        handlers_.insert(make_pair(apiId, handler));
+        const auto method = FindFrontendApi(apiId);
+        if (method == NO_API_METHOD) {
+            handlers_.insert(make_pair(apiId, handler));
+        } else if (apiHandlers_[method] == nullptr) {
+            apiHandlers_[method] = move(handler);
+        }
+    }
+
+    const ApiInvokeHandler *FrontendApiServer::FindHandler(string_view apiId) const
+    {
+        const auto method = FindFrontendApi(apiId);
+        if (method != NO_API_METHOD) {
+            return apiHandlers_[method] == nullptr ? nullptr : &apiHandlers_[method];
+        }
+        const auto find = handlers_.find(apiId);
+        return find == handlers_.end() ? nullptr : &find->second;
     }
 
     void FrontendApiServer::SetCallbackHandler(ApiInvokeHandler handler)
@@ -466,12 +396,20 @@ namespace OHOS::uitest {
     bool FrontendApiServer::HasHandlerFor(std::string_view apiId) const
     {
         string apiIdstr = CheckAndDoApiMapping(apiId, '.', old2NewApiMap_);
-        return handlers_.find(apiIdstr) != handlers_.end();
+        return FindHandler(apiIdstr) != nullptr;
     }
 
     void FrontendApiServer::RemoveHandler(string_view apiId)
     {
-        handlers_.erase(string(apiId));
+        const auto method = FindFrontendApi(apiId);
+        if (method != NO_API_METHOD) {
+            apiHandlers_[method] = nullptr;
+            return;
+        }
+        const auto find = handlers_.find(apiId);
+        if (find != handlers_.end()) {
+            handlers_.erase(find);
+        }
     }
 
     void FrontendApiServer::AddCommonPreprocessor(string_view name, ApiInvokeHandler processor)
@@ -487,48 +425,74 @@ namespace OHOS::uitest {
         commonPreprocessors_.erase(string(name));
     }
 
+    bool FrontendApiServer::IsOldApi(string_view apiId) const
+    {
+        return old2NewApiMap_.find(GetClassName(apiId, '.')) != old2NewApiMap_.end() ||
+            old2NewApiMap_.find(apiId) != old2NewApiMap_.end();
+    }
+
+    /** Backend objects cache.*/
+    static BackendObjectTable sBackendObjects;
+
     void FrontendApiServer::Call(const ApiCallInfo &in, ApiReplyInfo &out) const
     {
         LOG_I("Begin to invoke api '%{public}s', '%{public}s'", in.apiId_.data(), in.paramList_.dump().data());
-        auto call = in;
-        // initialize method signature
-        if (sApiArgTypesMap.empty()) {
-            ParseFrontendMethodsSignature();
-            ParseExtensionMethodsSignature();
-        }
-        string oldApiName = ApiMapPre(call);
-        out.convertError_ = call.convertError_;
-        auto find = handlers_.find(call.apiId_);
-        if (find == handlers_.end()) {
-            out.exception_ = ApiCallErr(ERR_INTERNAL, "No handler found for api '" + call.apiId_ + "'");
+        // the reading calls run along with each other, the others run alone in the order of arrival
+        ApiCallTurn turn(scheduler_, GetApiAccess(in.apiId_));
+        BackendObjectCall objectsInUse(sBackendObjects);
+        CallInTurn(in, out);
+    }
+
+    void FrontendApiServer::CallInTurn(const ApiCallInfo &in, ApiReplyInfo &out) const
+    {
+        // only the calls of old apis are rewritten, the others are dispatched without copying
+        const ApiCallInfo *call = &in;
+        ApiCallInfo mapped;
+        string oldApiName;
+        if (IsOldApi(in.apiId_)) {
+            mapped = in;
+            oldApiName = ApiMapPre(mapped);
+            out.convertError_ = mapped.convertError_;
+            call = &mapped;
+        } else {
+            const auto method = FindFrontendApi(in.apiId_);
+            out.convertError_ = method == NO_API_METHOD ? in.convertError_ :
+                FRONTEND_API_TABLES.methods_[method].convertError_;
+        }
+        const auto handler = FindHandler(call->apiId_);
+        if (handler == nullptr) {
+            out.exception_ = ApiCallErr(ERR_INTERNAL, "No handler found for api '" + call->apiId_ + "'");
             return;
         }
+        const auto handled = Dispatch(*call, *handler, out);
+        if (oldApiName.length() > 0) {
+            ApiMapPost(oldApiName, out);
+        }
+        if (handled && out.convertError_ && out.exception_.code_ == ERR_INVALID_INPUT) {
+            out.exception_.code_ = ERR_INVALID_PARAM; // 401 to 17000007
+        }
+    }
+
+    bool FrontendApiServer::Dispatch(const ApiCallInfo &call, const ApiInvokeHandler &handler, ApiReplyInfo &out) const
+    {
         try {
             for (auto &[name, processor] : commonPreprocessors_) {
                 processor(call, out);
                 if (out.exception_.code_ != NO_ERROR) {
                     out.exception_.message_ = "(PreProcessing: " + name + ")" + out.exception_.message_;
-                    if (oldApiName.length() > 0) {
-                        ApiMapPost(oldApiName, out);
-                    }
-                    return; // error during pre-processing, abort
+                    return false; // error during pre-processing, abort
                 }
             }
         } catch (std::exception &ex) {
             out.exception_ = ApiCallErr(ERR_INTERNAL, "Preprocessor failed: " + string(ex.what()));
         }
         try {
-            find->second(call, out);
+            handler(call, out);
         } catch (std::exception &ex) {
             // catch possible json-parsing error
             out.exception_ = ApiCallErr(ERR_INTERNAL, "Handler failed: " + string(ex.what()));
         }
-        if (oldApiName.length() > 0) {
-            ApiMapPost(oldApiName, out);
-        }
-        if (out.convertError_ && out.exception_.code_ == ERR_INVALID_INPUT) {
-            out.exception_.code_ = ERR_INVALID_PARAM; // 401 to 17000007
-        }
+        return true;
     }
 
     void ApiTransact(const ApiCallInfo &in, ApiReplyInfo &out)
@@ -537,11 +501,6 @@ namespace OHOS::uitest {
         FrontendApiServer::Get().Call(in, out);
     }
 
-    /** Backend objects cache.*/
-    static map<string, unique_ptr<BackendClass>> sBackendObjects;
-    /** UiDriver binding map.*/
-    static map<string, string> sDriverBindingMap;
-
 
 #define CHECK_CALL_ARG(condition, code, message, error) \
     if (!(condition)) {                                 \
@@ -556,92 +515,140 @@ namespace OHOS::uitest {
         }
     }
 
+    static void CheckCallArgType(const ApiArgValidator &validator, const json &value, bool isDefAgc,
+        ApiCallErr &error);
+
+    /** Check if the object of the reference is living, the stale one is released or evicted.*/
+    static void CheckObjectRef(string_view ref, ApiCallErr &error)
+    {
+        if (sBackendObjects.Find(ref) != nullptr) {
+            return;
+        }
+        if (ref.find(COMPONENT_DEF.name_) == 0) {
+            error = ApiCallErr(ERR_COMPONENT_LOST, "Bad object ref, the component is released or evicted");
+        } else {
+            error = ApiCallErr(ERR_INTERNAL, "Bad object ref");
+        }
+    }
+
+    /** Check the json object against the properties of its definition, without copying it.*/
+    static void CheckJsonArgProps(const ApiArgValidator &validator, const json &value, ApiCallErr &error)
+    {
+        const auto jsonDef = *(FRONTEND_JSON_DEFS.begin() + validator.jsonIndex_);
+        const auto propValidators = FRONTEND_API_TABLES.jsonProps_.data() +
+            FRONTEND_API_TABLES.jsonPropStarts_[validator.jsonIndex_];
+        size_t matchedCount = 0;
+        for (size_t idx = 0; idx < jsonDef->propCount_; idx++) {
+            auto def = jsonDef->props_ + idx;
+            const auto propName = string(def->name_);
+            const auto find = value.find(propName);
+            if (find == value.end()) {
+                CHECK_CALL_ARG(!(def->required_), ERR_INVALID_INPUT, "Missing property " + propName, error);
+                continue;
+            }
+            matchedCount++;
+            // check json property value type recursive
+            CheckCallArgType(propValidators[idx], *find, !def->required_, error);
+            if (error.code_ != NO_ERROR) {
+                error.message_ = "Illegal value of property '" + propName + "': " + error.message_;
+                return;
+            }
+        }
+        // any property not matched is illegal
+        CHECK_CALL_ARG(matchedCount == value.size(), ERR_INVALID_INPUT,
+            "Illegal property of " + string(validator.type_), error);
+    }
+
+    /** Check if the json value represents and illegal data of the pre-resolved type, array type excluded.*/
+    static void CheckCallArgValue(const ApiArgValidator &validator, const json &value, ApiCallErr &error)
+    {
+        const auto type = value.type();
+        const auto isInteger = type == value_t::number_integer || type == value_t::number_unsigned;
+        switch (validator.kind_) {
+            case ARG_INT:
+                CHECK_CALL_ARG(isInteger && (type == value_t::number_unsigned || value.get<int64_t>() >= 0),
+                    ERR_INVALID_INPUT, "Expect integer which cannot be less than 0", error);
+                break;
+            case ARG_SIGNED_INT:
+                CHECK_CALL_ARG(isInteger, ERR_INVALID_INPUT, "Expect signedInt", error);
+                break;
+            case ARG_FLOAT:
+                CHECK_CALL_ARG(isInteger || type == value_t::number_float, ERR_INVALID_INPUT, "Expect float", error);
+                break;
+            case ARG_BOOL:
+                CHECK_CALL_ARG(type == value_t::boolean, ERR_INVALID_INPUT, "Expect boolean", error);
+                break;
+            case ARG_STRING:
+                CHECK_CALL_ARG(type == value_t::string, ERR_INVALID_INPUT, "Expect string", error);
+                break;
+            case ARG_OBJECT_REF:
+                CHECK_CALL_ARG(type == value_t::string, ERR_INVALID_INPUT, "Expect " + string(validator.type_), error);
+                CheckObjectRef(value.get_ref<const string &>(), error);
+                break;
+            case ARG_JSON_OBJECT:
+                CHECK_CALL_ARG(type == value_t::object, ERR_INVALID_INPUT, "Expect " + string(validator.type_), error);
+                CheckJsonArgProps(validator, value, error);
+                break;
+            case ARG_ANY:
+                break;
+            default:
+                CHECK_CALL_ARG(false, ERR_INTERNAL, "Unknown target type " + string(validator.type_), error);
+        }
+    }
+
     /** Check if the json value represents and illegal data of expected type.*/
-    static void CheckCallArgType(string_view expect, const json &value, bool isDefAgc, ApiCallErr &error)
+    static void CheckCallArgType(const ApiArgValidator &validator, const json &value, bool isDefAgc,
+        ApiCallErr &error)
     {
         const auto type = value.type();
         if (isDefAgc && type == value_t::null) {
             return;
         }
-        const auto isInteger = type == value_t::number_integer || type == value_t::number_unsigned;
-        auto begin0 = FRONTEND_CLASS_DEFS.begin();
-        auto end0 = FRONTEND_CLASS_DEFS.end();
-        auto begin1 = FRONTEND_JSON_DEFS.begin();
-        auto end1 = FRONTEND_JSON_DEFS.end();
-        auto find0 = find_if(begin0, end0, [&expect](const FrontEndClassDef *def) { return def->name_ == expect; });
-        auto find1 = find_if(begin1, end1, [&expect](const FrontEndJsonDef *def) { return def->name_ == expect; });
-        if (expect == "int") {
-            CHECK_CALL_ARG(isInteger && atoi(value.dump().c_str()) >= 0, ERR_INVALID_INPUT,
-                "Expect integer which cannot be less than 0", error);
-        } else if (expect == "signedInt") {
-            CHECK_CALL_ARG(isInteger, ERR_INVALID_INPUT, "Expect signedInt", error);
-        } else if (expect == "float") {
-            CHECK_CALL_ARG(isInteger || type == value_t::number_float, ERR_INVALID_INPUT, "Expect float", error);
-        } else if (expect == "bool") {
-            CHECK_CALL_ARG(type == value_t::boolean, ERR_INVALID_INPUT, "Expect boolean", error);
-        } else if (expect == "string") {
-            CHECK_CALL_ARG(type == value_t::string, ERR_INVALID_INPUT, "Expect string", error);
-        } else if (find0 != end0) {
-            CHECK_CALL_ARG(type == value_t::string, ERR_INVALID_INPUT, "Expect " + string(expect), error);
-            const auto findRef = sBackendObjects.find(value.get<string>());
-            CHECK_CALL_ARG(findRef != sBackendObjects.end(), ERR_INTERNAL, "Bad object ref", error);
-        } else if (find1 != end1) {
-            CHECK_CALL_ARG(type == value_t::object, ERR_INVALID_INPUT, "Expect " + string(expect), error);
-            auto copy = value;
-            for (size_t idx = 0; idx < (*find1)->propCount_; idx++) {
-                auto def = (*find1)->props_ + idx;
-                const auto propName = string(def->name_);
-                if (!value.contains(propName)) {
-                    CHECK_CALL_ARG(!(def->required_), ERR_INVALID_INPUT, "Missing property " + propName, error);
-                    continue;
-                }
-                copy.erase(propName);
-                // check json property value type recursive
-                CheckCallArgType(def->type_, value[propName], !def->required_, error);
-                if (error.code_ != NO_ERROR) {
-                    error.message_ = "Illegal value of property '" + propName + "': " + error.message_;
-                    return;
-                }
+        if (!validator.array_) {
+            CheckCallArgValue(validator, value, error);
+            return;
+        }
+        CHECK_CALL_ARG(type == value_t::array, ERR_INVALID_INPUT, "Expect array", error);
+        for (size_t idx = 0; idx < value.size(); idx++) {
+            CheckCallArgValue(validator, value.at(idx), error);
+            if (error.code_ != NO_ERROR) {
+                error.message_ = "Illegal element " + to_string(idx) + ": " + error.message_;
+                return;
             }
-            CHECK_CALL_ARG(copy.empty(), ERR_INVALID_INPUT, "Illegal property of " + string(expect), error);
-        } else {
-            CHECK_CALL_ARG(false, ERR_INTERNAL, "Unknown target type " + string(expect), error);
         }
     }
 
     /** Checks ApiCallInfo data, deliver exception and abort invocation if check fails.*/
     static void APiCallInfoChecker(const ApiCallInfo &in, ApiReplyInfo &out)
     {
-        auto count = sApiArgTypesMap.count(in.apiId_);
         // return nullptr by default
         out.resultValue_ = nullptr;
-        auto find = sApiArgTypesMap.find(in.apiId_);
-        size_t index = 0;
-        while (index < count) {
-            if (find == sApiArgTypesMap.end()) {
+        if (BackendObjectTable::IsObjectRef(in.callerObjRef_)) {
+            CheckObjectRef(in.callerObjRef_, out.exception_);
+            if (out.exception_.code_ != NO_ERROR) {
+                out.exception_.message_ = "Check caller failed: " + out.exception_.message_;
                 return;
             }
-            out.convertError_ = find->second.convertError_;
-            bool checkArgNum = false;
-            bool checkArgType = true;
+        }
+        // try the overloads in the order of definition
+        for (auto method = FindFrontendApi(in.apiId_); method != NO_API_METHOD;) {
+            const auto &signature = FRONTEND_API_TABLES.methods_[method];
+            method = signature.nextOverload_;
+            out.convertError_ = signature.convertError_;
             out.exception_ = {NO_ERROR, "No Error"};
-            auto &types = find->second.paramTypes_;
-            auto argSupportDefault = find->second.defaultArgCount_;
-            // check argument count.(last item of "types" is return value type)
-            auto maxArgc = types.size() - 1;
-            auto minArgc = maxArgc - argSupportDefault;
-            auto argc = in.paramList_.size();
-            checkArgNum = argc <= maxArgc && argc >= minArgc;
-            if (!checkArgNum) {
+            // check argument count
+            const auto maxArgc = signature.maxArgc_;
+            const auto minArgc = maxArgc - signature.defaultArgCount_;
+            const auto argc = in.paramList_.size();
+            if (argc > maxArgc || argc < minArgc) {
                 out.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Illegal argument count");
-                ++find;
-                ++index;
                 continue;
             }
             // check argument type
+            bool checkArgType = true;
             for (size_t idx = 0; idx < argc; idx++) {
-                auto isDefArg = (idx >= minArgc) ? true : false;
-                CheckCallArgType(types.at(idx), in.paramList_.at(idx), isDefArg, out.exception_);
+                const auto &validator = FRONTEND_API_TABLES.args_[signature.argStart_ + idx];
+                CheckCallArgType(validator, in.paramList_.at(idx), idx >= minArgc, out.exception_);
                 if (out.exception_.code_ != NO_ERROR) {
                     out.exception_.message_ = "Check arg" + to_string(idx) + " failed: " + out.exception_.message_;
                     checkArgType = false;
@@ -651,8 +658,6 @@ namespace OHOS::uitest {
             if (checkArgType) {
                 return;
             }
-            ++find;
-            ++index;
         }
         ConvertError(out);
     }
@@ -660,64 +665,60 @@ namespace OHOS::uitest {
     /** Store the backend object and return the reference-id.*/
     static string StoreBackendObject(unique_ptr<BackendClass> ptr, string_view ownerRef = "")
     {
-        static map<string, uint32_t> sObjectCounts;
         DCHECK(ptr != nullptr);
-        const auto typeName = string(ptr->GetFrontendClassDef().name_);
-        auto find = sObjectCounts.find(typeName);
-        uint32_t index = 0;
-        if (find != sObjectCounts.end()) {
-            index = find->second;
-        }
-        auto ref = typeName + "#" + to_string(index);
-        sObjectCounts[typeName] = index + 1;
-        sBackendObjects[ref] = move(ptr);
-        if (!ownerRef.empty()) {
-            DCHECK(sBackendObjects.find(string(ownerRef)) != sBackendObjects.end());
-            sDriverBindingMap[ref] = ownerRef;
-        }
-        return ref;
+        DCHECK(ownerRef.empty() || sBackendObjects.Find(ownerRef) != nullptr);
+        return sBackendObjects.Store(move(ptr), ownerRef);
     }
 
     /** Retrieve the stored backend object by reference-id.*/
     template <typename T, typename = enable_if<is_base_of_v<BackendClass, T>>>
     static T &GetBackendObject(string_view ref)
     {
-        auto find = sBackendObjects.find(string(ref));
-        DCHECK(find != sBackendObjects.end() && find->second != nullptr);
-        return *(reinterpret_cast<T *>(find->second.get()));
+        auto object = sBackendObjects.Find(ref);
+        DCHECK(object != nullptr);
+        return *(reinterpret_cast<T *>(object));
     }
 
     static UiDriver &GetBoundUiDriver(string_view ref)
     {
-        auto find0 = sDriverBindingMap.find(string(ref));
-        DCHECK(find0 != sDriverBindingMap.end());
-        auto find1 = sBackendObjects.find(find0->second);
-        DCHECK(find1 != sBackendObjects.end() && find1->second != nullptr);
-        return *(reinterpret_cast<UiDriver *>(find1->second.get()));
+        auto driver = sBackendObjects.FindOwner(ref);
+        DCHECK(driver != nullptr);
+        return *(reinterpret_cast<UiDriver *>(driver));
     }
 
-    /** Delete stored backend objects.*/
+    /** Delete stored backend objects, along with the objects bound to them.*/
     static void BackendObjectsCleaner(const ApiCallInfo &in, ApiReplyInfo &out)
     {
         stringstream ss("Deleted objects[");
         DCHECK(in.paramList_.type() == value_t::array);
         for (const auto &item : in.paramList_) {
             DCHECK(item.type() == value_t::string); // must be objRef
-            const auto ref = item.get<string>();
-            auto findBinding = sDriverBindingMap.find(ref);
-            if (findBinding != sDriverBindingMap.end()) {
-                sDriverBindingMap.erase(findBinding);
-            }
-            auto findObject = sBackendObjects.find(ref);
-            if (findObject == sBackendObjects.end()) {
+            const auto &ref = item.get_ref<const string &>();
+            const auto count = sBackendObjects.Release(ref);
+            if (count == 0) {
                 LOG_W("No such object living: %{public}s", ref.c_str());
                 continue;
             }
-            sBackendObjects.erase(findObject);
-            ss << ref << ",";
+            ss << ref << "(" << count << "),";
         }
         ss << "]";
-        LOG_D("%{public}s", ss.str().c_str());
+        LOG_D("%{public}s, living %{public}zu", ss.str().c_str(), sBackendObjects.GetLivingCount());
+    }
+
+    /** The component getters share the ui snapshot, the ones retrieving from the updated ui take turns.*/
+    static mutex sWidgetRetrieveMutex;
+
+    /** Read the stored component if the ui has not changed since it was taken, otherwise retrieve it from the updated
+     * ui in the retrieve turn, which keeps the retrieved widget valid until it's unlocked.*/
+    static const Widget *ReadComponent(string_view ref, unique_lock<mutex> &retrieveTurn, ApiCallErr &error)
+    {
+        auto &image = GetBackendObject<Widget>(ref);
+        auto &driver = GetBoundUiDriver(ref);
+        if (driver.IsWidgetCurrent(image)) {
+            return &image;
+        }
+        retrieveTurn.lock();
+        return driver.RetrieveWidget(image, error);
     }
 
     template <typename T> static T ReadCallArg(const ApiCallInfo &in, size_t index)
@@ -847,8 +848,7 @@ namespace OHOS::uitest {
                 *selector = GetBackendObject<WidgetSelector>(in.callerObjRef_);
             }
             auto backendRef = ReadCallArg<string>(in, INDEX_ZERO);
-            auto findObj = sBackendObjects.find(backendRef);
-            if (findObj == sBackendObjects.end() || findObj->second == nullptr) {
+            if (sBackendObjects.Find(backendRef) == nullptr) {
                 out.exception_ = ApiCallErr(ERR_INVALID_PARAM, "Invalid component parameter");
                 return;
             }
@@ -921,6 +921,55 @@ namespace OHOS::uitest {
         server.AddHandler("Driver.findComponents", genericFindWidgetHandler);
         server.AddHandler("Driver.waitForComponent", genericFindWidgetHandler);
         server.AddHandler("Driver.assertComponentExist", genericFindWidgetHandler);
+        auto findWidgetsBatchHandler = [](const ApiCallInfo &in, ApiReplyInfo &out) {
+            const auto driverRef = in.callerObjRef_;
+            auto &driver = GetBackendObject<UiDriver>(driverRef);
+            vector<const WidgetSelector *> selectors;
+            for (const auto &selectorRef : in.paramList_.at(INDEX_ZERO)) {
+                auto &selector = GetBackendObject<WidgetSelector>(selectorRef.get<string>());
+                selector.SetWantMulti(true);
+                selectors.emplace_back(&selector);
+            }
+            vector<vector<unique_ptr<Widget>>> recv;
+            driver.FindWidgetsBatch(selectors, recv, out.exception_);
+            if (out.exception_.code_ != NO_ERROR) {
+                LOG_W("findWidgetsBatchHandler has error: %{public}s", out.exception_.message_.c_str());
+                return;
+            }
+            // return widget array of each selector, maybe empty
+            out.resultValue_ = json::array();
+            for (auto &widgets : recv) {
+                auto result = json::array();
+                for (auto &ptr : widgets) {
+                    result.emplace_back(StoreBackendObject(move(ptr), driverRef));
+                }
+                out.resultValue_.emplace_back(move(result));
+            }
+        };
+        server.AddHandler("Driver.findComponentsBatch", findWidgetsBatchHandler);
+        auto findWidgetAtHandler = [](const ApiCallInfo &in, ApiReplyInfo &out) {
+            const auto driverRef = in.callerObjRef_;
+            auto &driver = GetBackendObject<UiDriver>(driverRef);
+            auto pointJson = ReadCallArg<json>(in, INDEX_ZERO);
+            const auto displayId = ReadArgFromJson<int32_t>(pointJson, "displayId", UNASSIGNED);
+            if (!driver.CheckDisplayExist(displayId)) {
+                out.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Invalid display id.");
+                return;
+            }
+            const Point point(pointJson["x"].get<int32_t>(), pointJson["y"].get<int32_t>(), displayId);
+            auto widget = driver.FindWidgetAt(point, out.exception_);
+            if (out.exception_.code_ != NO_ERROR) {
+                LOG_W("findWidgetAtHandler has error: %{public}s", out.exception_.message_.c_str());
+                return;
+            }
+            // return the top-most component at the point or null
+            if (widget == nullptr) {
+                out.resultValue_ = nullptr;
+            } else {
+                out.resultValue_ = StoreBackendObject(move(widget), driverRef);
+            }
+        };
+        server.AddHandler("Driver.findComponentAt", findWidgetAtHandler);
     }
 
     static void RegisterUiDriverWindowFinder()
@@ -991,6 +1040,154 @@ namespace OHOS::uitest {
         server.AddHandler("Driver.delayMs", delay);
     }
 
+    /** Replace the references to the results of the former batch steps with the results, recursively.*/
+    static void ResolveBatchStepRefs(json &value, const json &results, ApiCallErr &error)
+    {
+        if (value.type() == value_t::array) {
+            for (auto &item : value) {
+                ResolveBatchStepRefs(item, results, error);
+                if (error.code_ != NO_ERROR) {
+                    return;
+                }
+            }
+            return;
+        }
+        if (value.type() != value_t::object) {
+            return;
+        }
+        const auto step = value.find(BATCH_STEP_REF);
+        if (step == value.end()) {
+            for (auto &[key, item] : value.items()) {
+                ResolveBatchStepRefs(item, results, error);
+                if (error.code_ != NO_ERROR) {
+                    return;
+                }
+            }
+            return;
+        }
+        CHECK_CALL_ARG(step->is_number_integer() && step->get<int64_t>() >= 0 &&
+            step->get<size_t>() < results.size(), ERR_INVALID_INPUT, "Illegal step reference " + value.dump(), error);
+        auto result = results.at(step->get<size_t>());
+        const auto index = value.find(BATCH_STEP_REF_INDEX);
+        if (index != value.end()) {
+            CHECK_CALL_ARG(index->is_number_integer() && index->get<int64_t>() >= 0 && result.is_array() &&
+                index->get<size_t>() < result.size(), ERR_INVALID_INPUT, "Illegal step reference " + value.dump(),
+                error);
+            result = result.at(index->get<size_t>());
+        }
+        value = move(result);
+    }
+
+    /** Collect the backend object references in the result of a step, which the step created.*/
+    static void CollectBatchStepObjects(string_view apiId, const json &result, vector<string> &refs)
+    {
+        const auto method = FindFrontendApi(apiId);
+        if (method == NO_API_METHOD) {
+            return;
+        }
+        auto type = FRONTEND_API_TABLES.methods_[method].returnType_;
+        while (type.length() > TWO && type.front() == '[' && type.back() == ']') {
+            type = type.substr(1, type.length() - TWO);
+        }
+        if (ResolveArgType(type, false).kind_ != ARG_OBJECT_REF) {
+            return;
+        }
+        if (result.type() == value_t::string) {
+            refs.emplace_back(result.get<string>());
+        } else if (result.type() == value_t::array) {
+            for (const auto &item : result) {
+                CollectBatchStepObjects(apiId, item, refs);
+            }
+        }
+    }
+
+    /** Check the shape of all the steps before running any, as the argument checking may be skipped.*/
+    static void CheckBatchSteps(const json &steps, ApiCallErr &error)
+    {
+        CHECK_CALL_ARG(steps.type() == value_t::array, ERR_INVALID_INPUT, "Illegal steps " + steps.dump(), error);
+        for (size_t index = 0; index < steps.size(); index++) {
+            const auto &step = steps.at(index);
+            const auto legal = step.type() == value_t::object && step.contains("api") &&
+                step["api"].type() == value_t::string &&
+                (!step.contains("args") || step["args"].type() == value_t::array);
+            CHECK_CALL_ARG(legal, ERR_INVALID_INPUT, "Illegal step " + to_string(index) + ": " + step.dump(), error);
+        }
+    }
+
+    /** Releases the backend objects created by the batch steps unless the batch is done, on any way out.*/
+    class BatchObjectsReleaser {
+    public:
+        ~BatchObjectsReleaser()
+        {
+            for (const auto &ref : refs_) {
+                sBackendObjects.Release(ref);
+            }
+        }
+
+        void Done()
+        {
+            refs_.clear();
+        }
+
+        vector<string> refs_;
+    };
+
+    /** Run a step of the batch with the references to the former results resolved.*/
+    static void RunBatchStep(const ApiCallInfo &batch, const json &step, const json &results, ApiCallInfo &call,
+        ApiReplyInfo &reply)
+    {
+        call.apiId_ = step["api"].get<string>();
+        if (call.apiId_ == batch.apiId_) {
+            reply.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Nested batch is not allowed");
+            return;
+        }
+        auto caller = step.contains("this") ? step["this"] : json(batch.callerObjRef_);
+        ResolveBatchStepRefs(caller, results, reply.exception_);
+        if (reply.exception_.code_ != NO_ERROR) {
+            return;
+        }
+        if (caller.type() != value_t::string) {
+            reply.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Illegal caller " + caller.dump());
+            return;
+        }
+        call.callerObjRef_ = caller.get<string>();
+        call.paramList_ = step.contains("args") ? step["args"] : json::array();
+        ResolveBatchStepRefs(call.paramList_, results, reply.exception_);
+        if (reply.exception_.code_ != NO_ERROR) {
+            return;
+        }
+        FrontendApiServer::Get().CallInTurn(call, reply);
+    }
+
+    static void RegisterUiDriverBatchExecutor()
+    {
+        // run the steps in the turn of the batch, stop at the first error and release the objects created by the steps
+        auto executeBatch = [](const ApiCallInfo &in, ApiReplyInfo &out) {
+            const auto &steps = in.paramList_.at(INDEX_ZERO);
+            CheckBatchSteps(steps, out.exception_);
+            if (out.exception_.code_ != NO_ERROR) {
+                return;
+            }
+            auto results = json::array();
+            BatchObjectsReleaser created;
+            for (size_t index = 0; index < steps.size(); index++) {
+                auto call = ApiCallInfo();
+                auto reply = ApiReplyInfo();
+                RunBatchStep(in, steps.at(index), results, call, reply);
+                if (reply.exception_.code_ != NO_ERROR) {
+                    out.exception_ = ApiCallErr(reply.exception_.code_, "Step " + to_string(index) + " (" +
+                        call.apiId_ + ") failed: " + reply.exception_.message_);
+                    return;
+                }
+                CollectBatchStepObjects(call.apiId_, reply.resultValue_, created.refs_);
+                results.emplace_back(move(reply.resultValue_));
+            }
+            created.Done();
+            out.resultValue_ = move(results);
+        };
+        FrontendApiServer::Get().AddHandler("Driver.executeBatch", executeBatch);
+    }
+
     static void RegisterUiDriverScreenCapMethods()
     {
         auto &server = FrontendApiServer::Get();
@@ -1034,15 +1231,14 @@ namespace OHOS::uitest {
             DumpOption option;
             option.fd = fd;
             option.displayId_ = displayId;
-            nlohmann::json layoutJson;
             ApiCallErr err(NO_ERROR);
-            driver.DumpUiHierarchy(layoutJson, option, err);
+            JsonStreamWriter writer(fd);
+            driver.DumpUiHierarchy(writer, option, err);
             if (err.code_ != NO_ERROR) {
                 out.exception_ = err;
                 return;
             }
-            string layoutStr = layoutJson.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
-            if (write(fd, layoutStr.c_str(), layoutStr.length()) == -1) {
+            if (!writer.Flush()) {
                 out.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Failed to write to file descriptor");
                 return;
             }
@@ -2034,9 +2230,8 @@ namespace OHOS::uitest {
     static void GenericComponentAttrGetter(const ApiCallInfo &in, ApiReplyInfo &out)
     {
         constexpr auto attrName = ATTR_NAMES[kAttr];
-        auto &image = GetBackendObject<Widget>(in.callerObjRef_);
-        auto &driver = GetBoundUiDriver(in.callerObjRef_);
-        auto snapshot = driver.RetrieveWidget(image, out.exception_);
+        unique_lock<mutex> retrieveTurn(sWidgetRetrieveMutex, defer_lock);
+        auto snapshot = ReadComponent(in.callerObjRef_, retrieveTurn, out.exception_);
         if (out.exception_.code_ != NO_ERROR) {
             out.resultValue_ = nullptr; // exception, return null
             return;
@@ -2080,9 +2275,8 @@ static void RegisterExtensionHandler()
 {
     auto &server = FrontendApiServer::Get();
     auto genericOperationHandler = [](const ApiCallInfo &in, ApiReplyInfo &out) {
-        auto &image = GetBackendObject<Widget>(in.callerObjRef_);
-        auto &driver = GetBoundUiDriver(in.callerObjRef_);
-        auto snapshot = driver.RetrieveWidget(image, out.exception_);
+        unique_lock<mutex> retrieveTurn(sWidgetRetrieveMutex, defer_lock);
+        auto snapshot = ReadComponent(in.callerObjRef_, retrieveTurn, out.exception_);
         if (out.exception_.code_ != NO_ERROR || snapshot == nullptr) {
             out.resultValue_ = nullptr; // exception, return null
             return;
@@ -2122,6 +2316,15 @@ static void RegisterExtensionHandler()
         driver.OpenAamsEvent();
     };
     server.AddHandler("Driver.OpenAamsEvent", genericOpenAamsEventHandler);
+    auto genericInvalidateUiSnapshotHandler = [](const ApiCallInfo &in, [[maybe_unused]] ApiReplyInfo &out) {
+        auto &driver = GetBackendObject<UiDriver>(in.callerObjRef_);
+        driver.InvalidateUiSnapshot();
+    };
+    server.AddHandler("Driver.InvalidateUiSnapshot", genericInvalidateUiSnapshotHandler);
+    auto genericSetWidgetMemoryLimitHandler = [](const ApiCallInfo &in, [[maybe_unused]] ApiReplyInfo &out) {
+        sBackendObjects.SetWidgetMemoryLimit(ReadCallArg<uint32_t>(in, INDEX_ZERO));
+    };
+    server.AddHandler("Driver.SetWidgetMemoryLimit", genericSetWidgetMemoryLimitHandler);
 }
 
     static void RegisterUiComponentAttrGetters()
@@ -2196,7 +2399,7 @@ static void RegisterExtensionHandler()
                 }
                 auto res = wOp.ScrollFindWidget(selector, vertical, out.exception_);
                 if (res != nullptr) {
-                    out.resultValue_ = StoreBackendObject(move(res), sDriverBindingMap.find(in.callerObjRef_)->second);
+                    out.resultValue_ = StoreBackendObject(move(res), sBackendObjects.GetOwnerRef(in.callerObjRef_));
                 }
             }
         };
@@ -2494,6 +2697,7 @@ static void RegisterExtensionHandler()
         RegisterUiDriverComponentFinders();
         RegisterUiDriverWindowFinder();
         RegisterUiDriverMiscMethods();
+        RegisterUiDriverBatchExecutor();
         RegisterUiDriverScreenCapMethods();
         RegisterUiDriverDumpLayoutMethods();
         RegisterUiDriverKeyOperation();
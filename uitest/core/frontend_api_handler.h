@@ -22,6 +22,8 @@
 #include <set>
 #include <functional>
 #include <list>
+#include <vector>
+#include "api_call_scheduler.h"
 #include "common_utilities_hpp.h"
 #include "frontend_api_defines.h"
 #include "nlohmann/json.hpp"
@@ -36,6 +38,9 @@ namespace OHOS::uitest {
     /**Prototype of function that handles ExternAPI invocation request.*/
     using ApiInvokeHandler = std::function<void(const ApiCallInfo& in, ApiReplyInfo& out)>;
 
+    /**Mapping of api names, which can be looked up by string_view.*/
+    using ApiNameMap = std::map<std::string, std::string, std::less<>>;
+
     /**Server that accepts and handles api invocation request.*/
     class FrontendApiServer {
     public:
@@ -71,6 +76,12 @@ namespace OHOS::uitest {
          * */
         void Call(const ApiCallInfo& in, ApiReplyInfo& out) const;
 
+        /**
+         * Handle api invocation request within the turn of an ongoing call, used by the apis made of other calls.
+         *
+         * */
+        void CallInTurn(const ApiCallInfo& in, ApiReplyInfo& out) const;
+
         /**
          * Set handler to handle api callback from server.
          *
@@ -97,16 +108,26 @@ namespace OHOS::uitest {
         void ApiMapPost(const std::string &oldApiName, ApiReplyInfo &out) const;
         /** convert old api call to new api call*/
         std::string ApiMapPre(ApiCallInfo &inModifier) const;
+        /** check if the api call needs to be converted by ApiMapPre*/
+        bool IsOldApi(std::string_view apiId) const;
+        /** run the pre-processors and the handler, returns false if aborted by a pre-processor*/
+        bool Dispatch(const ApiCallInfo &call, const ApiInvokeHandler &handler, ApiReplyInfo &out) const;
+        /** find the registered handler of the api, returns nullptr if none*/
+        const ApiInvokeHandler *FindHandler(std::string_view apiId) const;
         /** Command apiCall pre-processors before it's dispatched to target handler.*/
         std::map<std::string, ApiInvokeHandler> commonPreprocessors_;
-        /** Registered api handlers.*/
-        std::map<std::string, ApiInvokeHandler> handlers_;
+        /** Registered handlers of the frontend apis, indexed by the api method in FRONTEND_API_TABLES.*/
+        std::vector<ApiInvokeHandler> apiHandlers_;
+        /** Registered handlers of the other apis.*/
+        std::map<std::string, ApiInvokeHandler, std::less<>> handlers_;
         /** mapping classes of old API to classes of new API*/
-        std::map<std::string, std::string> old2NewApiMap_;
+        ApiNameMap old2NewApiMap_;
         /** mapping classes of new API to classes of old API*/
-        std::map<std::string, std::string> new2OldApiMap_;
+        ApiNameMap new2OldApiMap_;
         // function used for callback
         ApiInvokeHandler callbackHandler_ = nullptr;
+        /** turns of the calls, the reading ones run concurrently*/
+        mutable ApiCallScheduler scheduler_;
     };
 }
 
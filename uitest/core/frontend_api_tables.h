@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FRONTEND_API_TABLES_H
+#define FRONTEND_API_TABLES_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include "api_call_scheduler.h"
+#include "common_utilities_hpp.h"
+#include "frontend_api_defines.h"
+
+namespace OHOS::uitest {
+    /**Methods handled by the server but not exported to the frontend.*/
+    constexpr FrontendMethodDef EXTENSION_METHOD_DEFS[] = {
+        {"Component.getAllProperties", "():", false, false},
+        {"Driver.SetAamsWorkMode", "(int):", false, false},
+        {"Driver.CloseAamsEvent", "():", false, false},
+        {"Driver.OpenAamsEvent", "():", false, false},
+        {"Driver.InvalidateUiSnapshot", "():", false, false},
+        {"Driver.SetWidgetMemoryLimit", "(int):", false, false},
+    };
+
+    /**How an argument is validated, resolved from its type name.*/
+    enum ApiArgKind : uint8_t {
+        ARG_UNKNOWN = 0,
+        ARG_INT,
+        ARG_SIGNED_INT,
+        ARG_FLOAT,
+        ARG_BOOL,
+        ARG_STRING,
+        ARG_OBJECT_REF,
+        ARG_JSON_OBJECT,
+        // any json value, checked by the handler consuming it
+        ARG_ANY,
+    };
+
+    /**Pre-resolved validator of an api argument or a json property.*/
+    struct ApiArgValidator {
+        // type name, the element type name for an array type "[type]"
+        std::string_view type_;
+        ApiArgKind kind_ = ARG_UNKNOWN;
+        bool array_ = false;
+        // index of the json definition in FRONTEND_JSON_DEFS if kind_ is ARG_JSON_OBJECT
+        size_t jsonIndex_ = 0;
+    };
+
+    constexpr size_t NO_API_METHOD = SIZE_MAX;
+    constexpr size_t MAX_API_ARGS = 8;
+
+    /**Pre-parsed signature of an api method.*/
+    struct ApiMethodSignature {
+        std::string_view apiId_;
+        std::string_view returnType_;
+        // validators of the arguments are FRONTEND_API_TABLES.args_[argStart_, argStart_ + maxArgc_)
+        size_t argStart_ = 0;
+        size_t maxArgc_ = 0;
+        size_t defaultArgCount_ = 0;
+        bool convertError_ = false;
+        // next overload of the same api, or NO_API_METHOD
+        size_t nextOverload_ = NO_API_METHOD;
+        ApiAccess access_ = API_MUTATING;
+    };
+
+    /**Tokens of a method signature "(type,[type],type?):returnType".*/
+    struct ParsedSignature {
+        std::array<std::string_view, MAX_API_ARGS> types_ {};
+        std::array<bool, MAX_API_ARGS> arrays_ {};
+        size_t argc_ = 0;
+        size_t defaultArgCount_ = 0;
+        std::string_view returnType_;
+    };
+
+    constexpr ParsedSignature ParseSignature(std::string_view signature)
+    {
+        ParsedSignature parsed;
+        size_t tokenStart = 0;
+        size_t tokenLen = 0;
+        bool isArray = false;
+        // iterate the chars rather than subscripting them, which is cheaper at compile time
+        size_t index = 0;
+        for (const char ch : signature) {
+            if ((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z')) {
+                tokenStart = tokenLen == 0 ? index : tokenStart;
+                tokenLen++;
+            } else if (ch == '[') {
+                isArray = true;
+            } else if (ch == '?') {
+                parsed.defaultArgCount_++;
+            } else if (ch == ',' || ch == ')') {
+                if (tokenLen > 0 && parsed.argc_ < MAX_API_ARGS) {
+                    parsed.types_[parsed.argc_] = signature.substr(tokenStart, tokenLen);
+                    parsed.arrays_[parsed.argc_] = isArray;
+                    parsed.argc_++;
+                }
+                isArray = false;
+                tokenLen = 0;
+                if (ch == ')') {
+                    // skip the "):"
+                    parsed.returnType_ = index + TWO <= signature.length() ? signature.substr(index + TWO) : "";
+                    break;
+                }
+            }
+            index++;
+        }
+        return parsed;
+    }
+
+    /**Tell if the api id starts with the prefix, comparing in place is much cheaper than substr at compile time.*/
+    constexpr bool ApiIdStartsWith(std::string_view apiId, std::string_view prefix)
+    {
+        if (apiId.length() < prefix.length()) {
+            return false;
+        }
+        for (size_t index = 0; index < prefix.length(); index++) {
+            if (apiId[index] != prefix[index]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**Classify the api by its name: the selector builders and the queries, getters and dumps are reading ones.*/
+    constexpr ApiAccess ClassifyApiAccess(std::string_view apiId)
+    {
+        constexpr std::string_view pureClasses[] = {"On", "By"};
+        constexpr std::string_view pureMethods[] = {"delayMs"};
+        // the attribute getters of the components read the stored widgets
+        constexpr std::string_view widgetClasses[] = {"Component", "UiComponent"};
+        constexpr std::string_view readPrefixes[] = {"get", "is", "find", "wait", "dump", "screenCap", "assert"};
+        // these ones perform the input to check the component
+        constexpr std::string_view mutatingPrefix = "isComponentPresentWhen";
+        const auto pos = apiId.find('.');
+        if (pos == std::string_view::npos) {
+            return API_MUTATING;
+        }
+        const auto className = std::string_view(apiId.data(), pos);
+        const auto method = std::string_view(apiId.data() + pos + 1, apiId.length() - pos - 1);
+        for (const auto pure : pureClasses) {
+            if (className == pure) {
+                return API_READ_PURE;
+            }
+        }
+        for (const auto pure : pureMethods) {
+            if (method == pure) {
+                return API_READ_PURE;
+            }
+        }
+        if (ApiIdStartsWith(method, mutatingPrefix)) {
+            return API_MUTATING;
+        }
+        for (const auto prefix : readPrefixes) {
+            if (!ApiIdStartsWith(method, prefix)) {
+                continue;
+            }
+            const bool getter = prefix == "get" || prefix == "is";
+            for (const auto widgetClass : widgetClasses) {
+                if (getter && className == widgetClass) {
+                    return API_READ_WIDGET;
+                }
+            }
+            return API_READ_SNAPSHOT;
+        }
+        return API_MUTATING;
+    }
+
+    constexpr size_t GetFrontendMethodCount()
+    {
+        size_t count = sizeof(EXTENSION_METHOD_DEFS) / sizeof(FrontendMethodDef);
+        for (auto classDef : FRONTEND_CLASS_DEFS) {
+            count += classDef->methodCount_;
+        }
+        return count;
+    }
+
+    /**Get the method by its index, methods of FRONTEND_CLASS_DEFS come first, then EXTENSION_METHOD_DEFS.*/
+    constexpr const FrontendMethodDef &GetFrontendMethod(size_t index)
+    {
+        for (auto classDef : FRONTEND_CLASS_DEFS) {
+            if (index < classDef->methodCount_) {
+                return classDef->methods_[index];
+            }
+            index -= classDef->methodCount_;
+        }
+        return EXTENSION_METHOD_DEFS[index];
+    }
+
+    constexpr size_t GetFrontendArgCount()
+    {
+        size_t count = 0;
+        for (size_t index = 0; index < GetFrontendMethodCount(); index++) {
+            count += ParseSignature(GetFrontendMethod(index).signature_).argc_;
+        }
+        return count;
+    }
+
+    constexpr size_t GetJsonPropCount()
+    {
+        size_t count = 0;
+        for (auto jsonDef : FRONTEND_JSON_DEFS) {
+            count += jsonDef->propCount_;
+        }
+        return count;
+    }
+
+    constexpr size_t GetHashSize(size_t keyCount)
+    {
+        size_t size = 1;
+        while (size < keyCount) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    /**FNV-1a hash of the api id.*/
+    constexpr uint64_t HashApiId(std::string_view apiId)
+    {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char ch : apiId) {
+            hash = (hash ^ static_cast<uint8_t>(ch)) * 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    constexpr size_t GetApiHashSlot(uint64_t hash, uint16_t seed, size_t slotCount)
+    {
+        auto mixed = (hash ^ (seed * 0x9e3779b97f4a7c15ULL)) * 0xff51afd7ed558ccdULL;
+        return static_cast<size_t>(mixed >> 32) & (slotCount - 1);
+    }
+
+    constexpr size_t FRONTEND_METHOD_COUNT = GetFrontendMethodCount();
+    constexpr size_t FRONTEND_ARG_COUNT = GetFrontendArgCount();
+    constexpr size_t FRONTEND_JSON_PROP_COUNT = GetJsonPropCount();
+    constexpr size_t FRONTEND_JSON_DEF_COUNT = FRONTEND_JSON_DEFS.size();
+    // the perfect hash places each api into one slot of a half-filled table, by the seed of the bucket of the api
+    constexpr size_t API_HASH_SLOTS = GetHashSize(FRONTEND_METHOD_COUNT * TWO);
+    constexpr size_t API_HASH_BUCKETS = GetHashSize(FRONTEND_METHOD_COUNT / TWO + 1);
+    static_assert(FRONTEND_METHOD_COUNT < UINT16_MAX, "Too many frontend methods");
+
+    /**Dispatch and validation tables of all the frontend apis, built at compile time.*/
+    struct FrontendApiTables {
+        std::array<ApiMethodSignature, FRONTEND_METHOD_COUNT> methods_ {};
+        std::array<ApiArgValidator, FRONTEND_ARG_COUNT> args_ {};
+        // validators of the properties of FRONTEND_JSON_DEFS[i] start at jsonProps_[jsonPropStarts_[i]]
+        std::array<ApiArgValidator, FRONTEND_JSON_PROP_COUNT> jsonProps_ {};
+        std::array<size_t, FRONTEND_JSON_DEF_COUNT> jsonPropStarts_ {};
+        std::array<uint16_t, API_HASH_BUCKETS> hashSeeds_ {};
+        // index of the first overload plus one, 0 for an empty slot
+        std::array<uint16_t, API_HASH_SLOTS> hashSlots_ {};
+        bool hashBuilt_ = false;
+    };
+
+    constexpr ApiArgValidator ResolveArgType(std::string_view type, bool isArray)
+    {
+        ApiArgValidator validator;
+        validator.type_ = type;
+        validator.array_ = isArray;
+        if (type == "int") {
+            validator.kind_ = ARG_INT;
+        } else if (type == "signedInt") {
+            validator.kind_ = ARG_SIGNED_INT;
+        } else if (type == "float") {
+            validator.kind_ = ARG_FLOAT;
+        } else if (type == "bool") {
+            validator.kind_ = ARG_BOOL;
+        } else if (type == "string") {
+            validator.kind_ = ARG_STRING;
+        } else if (type == "any") {
+            validator.kind_ = ARG_ANY;
+        }
+        if (validator.kind_ != ARG_UNKNOWN) {
+            return validator;
+        }
+        for (auto classDef : FRONTEND_CLASS_DEFS) {
+            if (classDef->name_ == type) {
+                validator.kind_ = ARG_OBJECT_REF;
+                return validator;
+            }
+        }
+        size_t jsonIndex = 0;
+        for (auto jsonDef : FRONTEND_JSON_DEFS) {
+            if (jsonDef->name_ == type) {
+                validator.kind_ = ARG_JSON_OBJECT;
+                validator.jsonIndex_ = jsonIndex;
+                return validator;
+            }
+            jsonIndex++;
+        }
+        return validator;
+    }
+
+    /**Chain the overloads after the first one in the order of definition, then find a seed for each bucket which
+     * places all its apis into empty slots, the larger buckets go first. Only the first overloads are hashed.*/
+    constexpr bool BuildApiHash(FrontendApiTables &tables, const std::array<uint64_t, FRONTEND_METHOD_COUNT> &hashes)
+    {
+        constexpr uint16_t maxSeed = UINT16_MAX;
+        // group the apis by bucket once in the order of definition, the apis of bucket i are
+        // bucketKeys[bucketStarts[i], bucketEnds[i])
+        std::array<size_t, API_HASH_BUCKETS + 1> bucketStarts {};
+        for (size_t index = 0; index < FRONTEND_METHOD_COUNT; index++) {
+            bucketStarts[(static_cast<size_t>(hashes[index]) & (API_HASH_BUCKETS - 1)) + 1]++;
+        }
+        for (size_t bucket = 0; bucket < API_HASH_BUCKETS; bucket++) {
+            bucketStarts[bucket + 1] += bucketStarts[bucket];
+        }
+        std::array<size_t, FRONTEND_METHOD_COUNT> bucketKeys {};
+        std::array<size_t, API_HASH_BUCKETS> bucketEnds {};
+        for (size_t bucket = 0; bucket < API_HASH_BUCKETS; bucket++) {
+            bucketEnds[bucket] = bucketStarts[bucket];
+        }
+        for (size_t index = 0; index < FRONTEND_METHOD_COUNT; index++) {
+            bucketKeys[bucketEnds[static_cast<size_t>(hashes[index]) & (API_HASH_BUCKETS - 1)]++] = index;
+        }
+        // overloads share the bucket of the first one, chain them and keep only the first ones in the bucket
+        std::array<size_t, FRONTEND_METHOD_COUNT> lastOverloads {};
+        size_t maxBucketSize = 0;
+        for (size_t bucket = 0; bucket < API_HASH_BUCKETS; bucket++) {
+            auto firstEnd = bucketStarts[bucket];
+            for (auto key = bucketStarts[bucket]; key < bucketEnds[bucket]; key++) {
+                const auto index = bucketKeys[key];
+                auto first = bucketStarts[bucket];
+                while (first < firstEnd && (hashes[bucketKeys[first]] != hashes[index] ||
+                    tables.methods_[bucketKeys[first]].apiId_ != tables.methods_[index].apiId_)) {
+                    first++;
+                }
+                if (first == firstEnd) {
+                    lastOverloads[index] = index;
+                    bucketKeys[firstEnd++] = index;
+                    continue;
+                }
+                auto &last = lastOverloads[bucketKeys[first]];
+                tables.methods_[last].nextOverload_ = index;
+                last = index;
+            }
+            bucketEnds[bucket] = firstEnd;
+            const auto size = firstEnd - bucketStarts[bucket];
+            maxBucketSize = size > maxBucketSize ? size : maxBucketSize;
+        }
+        for (auto size = maxBucketSize; size > 0; size--) {
+            for (size_t bucket = 0; bucket < API_HASH_BUCKETS; bucket++) {
+                const auto keyStart = bucketStarts[bucket];
+                const auto keyEnd = bucketEnds[bucket];
+                if (keyEnd - keyStart != size) {
+                    continue;
+                }
+                bool placed = false;
+                for (uint16_t seed = 1; seed < maxSeed && !placed; seed++) {
+                    auto key = keyStart;
+                    for (; key < keyEnd; key++) {
+                        auto &slot = tables.hashSlots_[GetApiHashSlot(hashes[bucketKeys[key]], seed, API_HASH_SLOTS)];
+                        if (slot != 0) {
+                            break;
+                        }
+                        slot = static_cast<uint16_t>(bucketKeys[key] + 1);
+                    }
+                    placed = key == keyEnd;
+                    tables.hashSeeds_[bucket] = seed;
+                    // roll back the slots filled by this seed
+                    for (auto filled = keyStart; !placed && filled < key; filled++) {
+                        tables.hashSlots_[GetApiHashSlot(hashes[bucketKeys[filled]], seed, API_HASH_SLOTS)] = 0;
+                    }
+                }
+                if (!placed) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr FrontendApiTables BuildFrontendApiTables()
+    {
+        FrontendApiTables tables;
+        size_t propIndex = 0;
+        size_t jsonIndex = 0;
+        for (auto jsonDef : FRONTEND_JSON_DEFS) {
+            tables.jsonPropStarts_[jsonIndex++] = propIndex;
+            for (size_t index = 0; index < jsonDef->propCount_; index++) {
+                auto type = jsonDef->props_[index].type_;
+                const bool isArray = type.length() > TWO && type.front() == '[' && type.back() == ']';
+                type = isArray ? type.substr(1, type.length() - TWO) : type;
+                tables.jsonProps_[propIndex++] = ResolveArgType(type, isArray);
+            }
+        }
+        std::array<uint64_t, FRONTEND_METHOD_COUNT> hashes {};
+        size_t argIndex = 0;
+        for (size_t index = 0; index < FRONTEND_METHOD_COUNT; index++) {
+            const auto &methodDef = GetFrontendMethod(index);
+            const auto parsed = ParseSignature(methodDef.signature_);
+            auto &method = tables.methods_[index];
+            method.apiId_ = methodDef.name_;
+            method.returnType_ = parsed.returnType_;
+            method.argStart_ = argIndex;
+            method.maxArgc_ = parsed.argc_;
+            method.defaultArgCount_ = parsed.defaultArgCount_;
+            method.convertError_ = methodDef.convertError_;
+            method.access_ = ClassifyApiAccess(methodDef.name_);
+            for (size_t arg = 0; arg < parsed.argc_; arg++) {
+                tables.args_[argIndex++] = ResolveArgType(parsed.types_[arg], parsed.arrays_[arg]);
+            }
+            hashes[index] = HashApiId(methodDef.name_);
+        }
+        tables.hashBuilt_ = BuildApiHash(tables, hashes);
+        return tables;
+    }
+
+    constexpr FrontendApiTables FRONTEND_API_TABLES = BuildFrontendApiTables();
+    static_assert(FRONTEND_API_TABLES.hashBuilt_, "No perfect hash found for the frontend apis");
+
+    /**Find the first overload of the api, returns NO_API_METHOD if it is not a frontend api.*/
+    constexpr size_t FindFrontendApi(std::string_view apiId)
+    {
+        const auto hash = HashApiId(apiId);
+        const auto seed = FRONTEND_API_TABLES.hashSeeds_[static_cast<size_t>(hash) & (API_HASH_BUCKETS - 1)];
+        const auto slot = FRONTEND_API_TABLES.hashSlots_[GetApiHashSlot(hash, seed, API_HASH_SLOTS)];
+        if (slot == 0 || FRONTEND_API_TABLES.methods_[slot - 1].apiId_ != apiId) {
+            return NO_API_METHOD;
+        }
+        return slot - 1;
+    }
+
+    /**Get the access of the api, the ones which are not frontend apis are taken as mutating.*/
+    constexpr ApiAccess GetApiAccess(std::string_view apiId)
+    {
+        const auto method = FindFrontendApi(apiId);
+        return method == NO_API_METHOD ? API_MUTATING : FRONTEND_API_TABLES.methods_[method].access_;
+    }
+} // namespace OHOS::uitest
+
+#endif
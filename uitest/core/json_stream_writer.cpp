@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "nlohmann/json.hpp"
+#include "common_utilities_hpp.h"
+#include "json_stream_writer.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+    using namespace nlohmann;
+
+    static constexpr unsigned char MIN_PRINTABLE_CHAR = 0x20;
+    static constexpr unsigned char MIN_NON_ASCII_CHAR = 0x80;
+
+    /**Tells if the string is written as is, otherwise it is escaped or replaced by the serializer of nlohmann.*/
+    static bool IsPlainString(string_view value)
+    {
+        for (auto ch : value) {
+            const auto code = static_cast<unsigned char>(ch);
+            if (code < MIN_PRINTABLE_CHAR || code >= MIN_NON_ASCII_CHAR || ch == '"' || ch == '\\') {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    JsonStreamWriter::JsonStreamWriter(int32_t fd, size_t bufferSize) : fd_(fd), bufferSize_(bufferSize)
+    {
+        buffer_.reserve(bufferSize_);
+    }
+
+    JsonStreamWriter::~JsonStreamWriter()
+    {
+        Flush();
+    }
+
+    void JsonStreamWriter::BeginValue()
+    {
+        if (afterKey_) {
+            afterKey_ = false;
+        } else if (!emptyScopes_.empty()) {
+            if (!emptyScopes_.back()) {
+                buffer_.push_back(',');
+            }
+            emptyScopes_.back() = false;
+        }
+    }
+
+    void JsonStreamWriter::BeginObject()
+    {
+        BeginValue();
+        buffer_.push_back('{');
+        emptyScopes_.push_back(true);
+    }
+
+    void JsonStreamWriter::EndObject()
+    {
+        buffer_.push_back('}');
+        emptyScopes_.pop_back();
+        if (buffer_.size() >= bufferSize_) {
+            Flush();
+        }
+    }
+
+    void JsonStreamWriter::BeginArray()
+    {
+        BeginValue();
+        buffer_.push_back('[');
+        emptyScopes_.push_back(true);
+    }
+
+    void JsonStreamWriter::EndArray()
+    {
+        buffer_.push_back(']');
+        emptyScopes_.pop_back();
+    }
+
+    void JsonStreamWriter::Key(string_view key)
+    {
+        String(key);
+        buffer_.push_back(':');
+        afterKey_ = true;
+    }
+
+    void JsonStreamWriter::String(string_view value)
+    {
+        BeginValue();
+        if (IsPlainString(value)) {
+            buffer_.push_back('"');
+            buffer_.append(value);
+            buffer_.push_back('"');
+            return;
+        }
+        detail::serializer<json> serializer(detail::output_adapter<char>(buffer_), ' ',
+            detail::error_handler_t::replace);
+        serializer.dump(json(value), false, false, 0);
+    }
+
+    bool JsonStreamWriter::Flush()
+    {
+        size_t offset = 0;
+        while (good_ && offset < buffer_.size()) {
+            auto written = write(fd_, buffer_.data() + offset, buffer_.size() - offset);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                LOG_E("Write json to fd failed, errno: %{public}s", strerror(errno));
+                good_ = false;
+                break;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        flushedSize_ += buffer_.size();
+        buffer_.clear();
+        return good_;
+    }
+} // namespace OHOS::uitest
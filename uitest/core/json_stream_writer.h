@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JSON_STREAM_WRITER_H
+#define JSON_STREAM_WRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace OHOS::uitest {
+    /**Writes compact json to a file descriptor through a buffer as the values are produced, without building the
+     * json tree. The output is identical to nlohmann::json::dump(-1, ' ', false, error_handler_t::replace) of the
+     * same tree, the caller is responsible to write the object keys in the sorted order as nlohmann does.*/
+    class JsonStreamWriter {
+    public:
+        static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+        explicit JsonStreamWriter(int32_t fd, size_t bufferSize = DEFAULT_BUFFER_SIZE);
+
+        /**Flush the buffered content.*/
+        ~JsonStreamWriter();
+
+        void BeginObject();
+
+        void EndObject();
+
+        void BeginArray();
+
+        void EndArray();
+
+        void Key(std::string_view key);
+
+        void String(std::string_view value);
+
+        /**Write the content buffered so far to the file descriptor, returns false if any write failed.*/
+        bool Flush();
+
+        /**Tells if all the writes succeeded so far.*/
+        bool IsGood() const
+        {
+            return good_;
+        }
+
+        /**Bytes of the json produced so far, including the buffered ones.*/
+        size_t GetSize() const
+        {
+            return flushedSize_ + buffer_.size();
+        }
+
+    private:
+        void BeginValue();
+        int32_t fd_;
+        size_t bufferSize_;
+        std::string buffer_;
+        // whether the innermost object or array has no element yet
+        std::vector<bool> emptyScopes_;
+        bool afterKey_ = false;
+        bool good_ = true;
+        size_t flushedSize_ = 0;
+    };
+} // namespace OHOS::uitest
+
+#endif
@@ -35,40 +35,263 @@ namespace OHOS::uitest {
         return true;
     }
 
-    bool RectAlgorithm::ComputeMaxVisibleRegion(const Rect &origRect, const vector<Rect> &overlays, Rect &out)
+    /**Tells if the candidate is a better visible region than the current best one. The larger area wins, the ties
+     * prefer the lower one and then the left one.*/
+    static bool IsBetterRegion(const Rect &candidate, int64_t area, const Rect &best, int64_t bestArea)
     {
-        vector<Rect> result;
-        vector<Rect> current = {origRect};
-        for (auto obstacle : overlays) {
-            vector<Rect> next;
-            for (auto rect : current) {
-                Rect intersection(0, 0, 0, 0) ;
-                if (!RectAlgorithm::ComputeIntersection(rect, obstacle, intersection)) {
-                    next.push_back(rect);
-                    continue;
-                }
-                if (intersection.bottom_ < rect.bottom_) {
-                    next.push_back(Rect(rect.left_, rect.right_, intersection.bottom_, rect.bottom_));
+        if (area != bestArea) {
+            return area > bestArea;
+        }
+        if (candidate.bottom_ != best.bottom_) {
+            return candidate.bottom_ > best.bottom_;
+        }
+        if (candidate.left_ != best.left_) {
+            return candidate.left_ < best.left_;
+        }
+        return candidate.top_ < best.top_;
+    }
+
+    /**Find the best rectangle with the bottom on the band bottom in the histogram of the visible heights of the
+     * columns, heights[columns] is the sentinel of height 0.*/
+    static void SweepHistogram(const int32_t *xs, size_t columns, const vector<int64_t> &heights, int32_t bandBottom,
+        vector<size_t> &stack, Rect &best, int64_t &bestArea)
+    {
+        stack.clear();
+        for (size_t column = 0; column <= columns; column++) {
+            while (!stack.empty() && heights[stack.back()] >= heights[column]) {
+                const auto height = heights[stack.back()];
+                stack.pop_back();
+                const auto left = stack.empty() ? 0 : stack.back() + 1;
+                const Rect candidate(xs[left], xs[column], bandBottom - height, bandBottom);
+                const auto area = height * (xs[column] - xs[left]);
+                if (height > 0 && IsBetterRegion(candidate, area, best, bestArea)) {
+                    best = candidate;
+                    bestArea = area;
                 }
-                if (rect.top_ < intersection.top_) {
-                    next.push_back(Rect(rect.left_, rect.right_, rect.top_, intersection.top_));
+            }
+            stack.emplace_back(column);
+        }
+    }
+
+    /**Append the sorted distinct coordinates of the edges along one axis to the vector.*/
+    static void CollectCoordinates(const Rect &origRect, const vector<Rect> &overlays, bool horizontal,
+        vector<int32_t> &out)
+    {
+        const auto begin = out.size();
+        out.emplace_back(horizontal ? origRect.left_ : origRect.top_);
+        out.emplace_back(horizontal ? origRect.right_ : origRect.bottom_);
+        for (const auto &overlay : overlays) {
+            out.emplace_back(horizontal ? overlay.left_ : overlay.top_);
+            out.emplace_back(horizontal ? overlay.right_ : overlay.bottom_);
+        }
+        sort(out.begin() + begin, out.end());
+        out.erase(unique(out.begin() + begin, out.end()), out.end());
+    }
+
+    bool RectAlgorithm::ComputeMaxVisibleRegion(const Rect &origRect, const vector<Rect> &overlays, Rect &out)
+    {
+        out = Rect(0, 0, 0, 0);
+        if (!origRect.IsValid()) {
+            return false;
+        }
+        vector<Rect> clipped;
+        for (const auto &overlay : overlays) {
+            Rect intersection(0, 0, 0, 0);
+            if (RectAlgorithm::ComputeIntersection(origRect, overlay, intersection)) {
+                clipped.emplace_back(intersection);
+            }
+        }
+        if (clipped.empty()) {
+            out = origRect;
+            return true;
+        }
+        // the edges of the largest visible rectangle are on the edges of the rectangles, so the region is split into
+        // the grid by them. Each y-band is swept with the heights of visible cells ending at it, like a histogram.
+        vector<int32_t> coordinates;
+        coordinates.reserve((clipped.size() + 1) * INDEX_FOUR);
+        CollectCoordinates(origRect, clipped, true, coordinates);
+        const size_t columns = coordinates.size() - 1;
+        CollectCoordinates(origRect, clipped, false, coordinates);
+        const auto xs = coordinates.data();
+        const auto ys = xs + columns + 1;
+        const size_t bands = coordinates.size() - columns - INDEX_TWO;
+        // the cover changes at the column edges, then the visible heights and the extra sentinel column of height 0
+        vector<int64_t> covers(columns + 1, 0);
+        vector<int64_t> heights(columns + 1, 0);
+        vector<size_t> stack;
+        stack.reserve(columns + 1);
+        int64_t bestArea = 0;
+        for (size_t band = 0; band < bands; band++) {
+            const auto bandTop = ys[band];
+            const auto bandBottom = ys[band + 1];
+            fill(covers.begin(), covers.end(), 0);
+            for (const auto &overlay : clipped) {
+                if (overlay.top_ <= bandTop && overlay.bottom_ >= bandBottom) {
+                    covers[lower_bound(xs, xs + columns, overlay.left_) - xs]++;
+                    covers[lower_bound(xs, xs + columns + 1, overlay.right_) - xs]--;
                 }
-                if (rect.left_ < intersection.left_) {
-                    next.push_back(Rect(rect.left_, intersection.left_, rect.top_, rect.bottom_));
+            }
+            int64_t cover = 0;
+            for (size_t column = 0; column < columns; column++) {
+                cover += covers[column];
+                heights[column] = cover > 0 ? 0 : heights[column] + bandBottom - bandTop;
+            }
+            SweepHistogram(xs, columns, heights, bandBottom, stack, out, bestArea);
+        }
+        if (bestArea > 0) {
+            out.displayId_ = origRect.displayId_;
+        }
+        return bestArea > 0;
+    }
+
+    void VisibleRegion::Reset(const Rect &bounds, const vector<Rect> &overlays)
+    {
+        bounds_ = bounds;
+        occluded_ = false;
+        bandEdges_.clear();
+        spanStarts_.clear();
+        spanLefts_.clear();
+        spanRights_.clear();
+        if (!bounds.IsValid()) {
+            return;
+        }
+        vector<Rect> clipped;
+        for (const auto &overlay : overlays) {
+            Rect intersection(0, 0, 0, 0);
+            if (RectAlgorithm::ComputeIntersection(bounds, overlay, intersection)) {
+                clipped.emplace_back(intersection);
+            }
+        }
+        occluded_ = !clipped.empty();
+        vector<int32_t> ys;
+        CollectCoordinates(bounds, clipped, false, ys);
+        // the spans of each band are the bounds minus the overlays covering it, equal adjacent bands are merged
+        vector<pair<int32_t, int32_t>> covers;
+        vector<int32_t> spans;
+        vector<int32_t> lastSpans;
+        bandEdges_.emplace_back(ys.front());
+        spanStarts_.emplace_back(0);
+        for (size_t band = 0; band + 1 < ys.size(); band++) {
+            covers.clear();
+            for (const auto &overlay : clipped) {
+                if (overlay.top_ <= ys[band] && overlay.bottom_ >= ys[band + 1]) {
+                    covers.emplace_back(overlay.left_, overlay.right_);
                 }
-                if (intersection.right_ < rect.right_) {
-                    next.push_back(Rect(intersection.right_, rect.right_, rect.top_, rect.bottom_));
+            }
+            sort(covers.begin(), covers.end());
+            spans.clear();
+            auto left = bounds.left_;
+            for (const auto &[coverLeft, coverRight] : covers) {
+                if (coverLeft > left) {
+                    spans.emplace_back(left);
+                    spans.emplace_back(coverLeft);
                 }
+                left = max(left, coverRight);
+            }
+            if (left < bounds.right_) {
+                spans.emplace_back(left);
+                spans.emplace_back(bounds.right_);
+            }
+            if (band > 0 && spans == lastSpans) {
+                bandEdges_.back() = ys[band + 1];
+                continue;
+            }
+            for (size_t index = 0; index < spans.size(); index += INDEX_TWO) {
+                spanLefts_.emplace_back(spans[index]);
+                spanRights_.emplace_back(spans[index + 1]);
+            }
+            bandEdges_.emplace_back(ys[band + 1]);
+            spanStarts_.emplace_back(spanLefts_.size());
+            swap(spans, lastSpans);
+        }
+    }
+
+    void VisibleRegion::ComputeMaxVisibleRects(RectArrays &rects) const
+    {
+        Rect out(0, 0, 0, 0);
+        for (size_t index = 0; index < rects.Size(); index++) {
+            ComputeMaxVisibleRect(rects.Get(index), out);
+            rects.left_[index] = out.left_;
+            rects.right_[index] = out.right_;
+            rects.top_[index] = out.top_;
+            rects.bottom_[index] = out.bottom_;
+        }
+    }
+
+    bool VisibleRegion::ComputeMaxVisibleRect(const Rect &rect, Rect &out) const
+    {
+        out = Rect(0, 0, 0, 0);
+        Rect clip(0, 0, 0, 0);
+        if (!rect.IsValid() || bandEdges_.empty() || !RectAlgorithm::ComputeIntersection(rect, bounds_, clip)) {
+            return false;
+        }
+        const auto firstBand = static_cast<size_t>(upper_bound(bandEdges_.begin(), bandEdges_.end(), clip.top_) -
+            bandEdges_.begin() - 1);
+        size_t endBand = firstBand;
+        // the common cases are decided by the span overlapping the left edge in each band
+        bool covered = true;
+        bool visible = false;
+        for (; endBand + 1 < bandEdges_.size() && bandEdges_[endBand] < clip.bottom_; endBand++) {
+            auto span = spanStarts_[endBand];
+            const auto spanEnd = spanStarts_[endBand + 1];
+            while (span < spanEnd && spanRights_[span] <= clip.left_) {
+                span++;
+            }
+            const bool overlapped = span < spanEnd && spanLefts_[span] < clip.right_;
+            visible = visible || overlapped;
+            covered = covered && overlapped && spanLefts_[span] <= clip.left_ && spanRights_[span] >= clip.right_;
+        }
+        if (covered) {
+            out = clip;
+            out.displayId_ = rect.displayId_;
+            return true;
+        }
+        if (!visible) {
+            return false;
+        }
+        // sweep the bands in the rect like RectAlgorithm::ComputeMaxVisibleRegion, on the grid of the span edges
+        auto &xs = xs_;
+        xs.clear();
+        xs.emplace_back(clip.left_);
+        xs.emplace_back(clip.right_);
+        for (auto span = spanStarts_[firstBand]; span < spanStarts_[endBand]; span++) {
+            if (spanLefts_[span] > clip.left_ && spanLefts_[span] < clip.right_) {
+                xs.emplace_back(spanLefts_[span]);
+            }
+            if (spanRights_[span] > clip.left_ && spanRights_[span] < clip.right_) {
+                xs.emplace_back(spanRights_[span]);
             }
-            current = next;
         }
-        Rect maxRect(0, 0, 0, 0);
-        for (auto rect : current) {
-            if (rect.IsValid() && rect.GetArea() > maxRect.GetArea()) {
-                maxRect = rect;
+        sort(xs.begin(), xs.end());
+        xs.erase(unique(xs.begin(), xs.end()), xs.end());
+        const size_t columns = xs.size() - 1;
+        auto &covers = covers_;
+        auto &heights = heights_;
+        covers.assign(columns + 1, 0);
+        heights.assign(columns + 1, 0);
+        int64_t bestArea = 0;
+        for (auto band = firstBand; band < endBand; band++) {
+            const auto bandTop = max(bandEdges_[band], clip.top_);
+            const auto bandBottom = min(bandEdges_[band + 1], clip.bottom_);
+            fill(covers.begin(), covers.end(), 0);
+            for (auto span = spanStarts_[band]; span < spanStarts_[band + 1]; span++) {
+                const auto left = max(spanLefts_[span], clip.left_);
+                const auto right = min(spanRights_[span], clip.right_);
+                if (left < right) {
+                    covers[lower_bound(xs.begin(), xs.end(), left) - xs.begin()]++;
+                    covers[lower_bound(xs.begin(), xs.end(), right) - xs.begin()]--;
+                }
+            }
+            int64_t cover = 0;
+            for (size_t column = 0; column < columns; column++) {
+                cover += covers[column];
+                heights[column] = cover > 0 ? heights[column] + bandBottom - bandTop : 0;
             }
+            SweepHistogram(xs.data(), columns, heights, bandBottom, stack_, out, bestArea);
+        }
+        if (bestArea > 0) {
+            out.displayId_ = rect.displayId_;
         }
-        out = maxRect;
-        return out.GetArea() > 0;
+        return bestArea > 0;
     }
 } // namespace OHOS::uitest
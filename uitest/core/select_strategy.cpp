@@ -13,9 +13,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include "select_strategy.h"
 namespace OHOS::uitest {
     constexpr int32_t MAX_TRAVEL_TIMES = 20000;
+    // streaming select keeps no visited node, only an abnormal node batch is bounded
+    constexpr int32_t MAX_STREAM_TRAVEL_TIMES = 1000000;
     void SelectStrategy::RegisterAnchorMatch(const WidgetMatchModel &matchModel)
     {
         anchorMatch_.emplace_back(matchModel);
@@ -34,7 +37,7 @@ namespace OHOS::uitest {
     void SelectStrategy::SetAndCalcSelectWindowRect(const Rect &windowBounds, const std::vector<Rect> &windowBoundsVec)
     {
         windowBounds_ = windowBounds;
-        overplayWindowBoundsVec_ = windowBoundsVec;
+        visibleRegion_.Reset(windowBounds, windowBoundsVec);
     }
 
     SelectStrategy::~SelectStrategy()
@@ -57,26 +60,22 @@ namespace OHOS::uitest {
         }
         widget.SetBounds(visibleRect);
 
-        // calc bounds with its cliper
-        auto hier = widget.GetAttr(UiAttr::HIERARCHY);
-        while (WidgetHierarchyBuilder::GetParentWidgetHierarchy(hier) != "") {
-            std::string parentHie = WidgetHierarchyBuilder::GetParentWidgetHierarchy(hier);
-            auto find = clipers_.find(parentHie);
-            if (find != clipers_.end()) {
-                if (!RectAlgorithm::ComputeIntersection(widget.GetBounds(), find->second, visibleRect)) {
-                    widget.SetBounds(noneZone);
-                    return;
-                }
-                widget.SetBounds(visibleRect);
+        // calc bounds with the clip of its ancestors
+        const auto parentClip = FindParentClip(widget);
+        if (parentClip != nullptr && parentClip->clipped_) {
+            const auto &clip = *parentClip;
+            if (clip.empty_ || !RectAlgorithm::ComputeIntersection(widget.GetBounds(), clip.rect_, visibleRect)) {
+                widget.SetBounds(noneZone);
+                return;
             }
-            hier = parentHie;
+            widget.SetBounds(visibleRect);
         }
 
         // calc bounds with overplay windows
-        if (overplayWindowBoundsVec_.size() == 0) {
+        if (!visibleRegion_.IsOccluded()) {
             return;
         }
-        if (!RectAlgorithm::ComputeMaxVisibleRegion(widget.GetBounds(), overplayWindowBoundsVec_, visibleRect)) {
+        if (!visibleRegion_.ComputeMaxVisibleRect(widget.GetBounds(), visibleRect)) {
             LOG_D("widget %{public}s is hide by overplays, widget info is %{public}s",
                   widget.GetAttr(UiAttr::ACCESSIBILITY_ID).data(), widget.ToStr().data());
             widget.SetBounds(noneZone);
@@ -103,6 +102,9 @@ namespace OHOS::uitest {
             case StrategyEnum::COMPLEX:
                 strategy = "COMPLEX";
                 break;
+            case StrategyEnum::PLAN:
+                strategy = "PLAN";
+                break;
             default:
                 LOG_I("Error StrategyType, use plain");
                 strategy = "PLAIN";
@@ -141,9 +143,49 @@ namespace OHOS::uitest {
         } else {
             widget.SetAttr(UiAttr::VISIBLE, "true");
         }
-        if (widget.GetAttr(UiAttr::CLIP) == "true") {
-            clipers_.insert(make_pair(widget.GetAttr(UiAttr::HIERARCHY), widget.GetOrigBounds()));
+        RecordNodeClip(widget);
+    }
+
+    const SelectStrategy::NodeClip *SelectStrategy::FindParentClip(const Widget &widget) const
+    {
+        // nodes come in DFS order, so the parent is the latest node recorded one level above
+        const auto parentIndex = widget.GetParentNodeIndex();
+        const auto depth = widget.GetDepth();
+        if (parentIndex < 0 || depth <= 0 || static_cast<size_t>(depth) > clipChain_.size()) {
+            return nullptr;
         }
+        const auto &clip = clipChain_[depth - 1];
+        return clip.nodeIndex_ == parentIndex ? &clip : nullptr;
+    }
+
+    void SelectStrategy::RecordNodeClip(const Widget &widget)
+    {
+        const auto index = widget.GetNodeIndex();
+        const auto depth = widget.GetDepth();
+        if (index < 0 || depth < 0) {
+            return;
+        }
+        // inherit the clip of the ancestors, then narrow it with its own bounds
+        NodeClip clip;
+        const auto parentClip = FindParentClip(widget);
+        if (parentClip != nullptr) {
+            clip = *parentClip;
+        }
+        clip.nodeIndex_ = index;
+        if (widget.GetBoolAttr(UiAttr::CLIP) && !clip.empty_) {
+            Rect merged{0, 0, 0, 0};
+            if (!clip.clipped_) {
+                clip.rect_ = widget.GetOrigBounds();
+            } else if (RectAlgorithm::ComputeIntersection(clip.rect_, widget.GetOrigBounds(), merged)) {
+                clip.rect_ = merged;
+            } else {
+                clip.empty_ = true;
+            }
+            clip.clipped_ = true;
+        }
+        // drop the entries of the subtree left behind, only the ancestor chain is kept
+        clipChain_.resize(depth);
+        clipChain_.emplace_back(clip);
     }
 
     class AfterSelectorStrategy : public SelectStrategy {
@@ -156,6 +198,7 @@ namespace OHOS::uitest {
                         const DumpOption &option) override
         {
             elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
             SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
             while (true) {
                 Widget anchorWidget{"test"};
@@ -164,13 +207,13 @@ namespace OHOS::uitest {
                 }
                 anchorWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 anchorWidget.SetDisplayId(window.displayId_);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
                 }
                 RefreshWidgetBounds(anchorWidget, window);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     continue;
                 }
@@ -208,7 +251,7 @@ namespace OHOS::uitest {
                 myselfWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 myselfWidget.SetDisplayId(window.displayId_);
                 RefreshWidgetBounds(myselfWidget, window);
-                if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!myselfWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", myselfWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
@@ -254,6 +297,7 @@ namespace OHOS::uitest {
                         const DumpOption &option) override
         {
             elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
             SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
             while (true) {
                 Widget anchorWidget{"anchorWidget"};
@@ -262,13 +306,13 @@ namespace OHOS::uitest {
                 }
                 anchorWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 anchorWidget.SetDisplayId(window.displayId_);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
                 }
                 RefreshWidgetBounds(anchorWidget, window);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     continue;
                 }
@@ -335,6 +379,7 @@ namespace OHOS::uitest {
                         const DumpOption &option) override
         {
             elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
             SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
             while (true) {
                 Widget anchorWidget{"withInWidget"};
@@ -343,13 +388,13 @@ namespace OHOS::uitest {
                 }
                 anchorWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 anchorWidget.SetDisplayId(window.displayId_);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
                 }
                 RefreshWidgetBounds(anchorWidget, window);
-                if (anchorWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!anchorWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", anchorWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     continue;
                 }
@@ -392,7 +437,7 @@ namespace OHOS::uitest {
                 myselfWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 myselfWidget.SetDisplayId(window.displayId_);
                 RefreshWidgetBounds(myselfWidget, window);
-                if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!myselfWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", myselfWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
@@ -439,6 +484,7 @@ namespace OHOS::uitest {
                         const DumpOption &option) override
         {
             elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
             if (!option.notMergeWindow_) {
                 SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
             } else {
@@ -452,7 +498,7 @@ namespace OHOS::uitest {
                 myselfWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 myselfWidget.SetDisplayId(window.displayId_);
                 if (!option.listWindows_) {
-                    if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                    if (!myselfWidget.IsVisible()) {
                         LOG_D("Widget %{public}s is invisible", myselfWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                         elementNodeRef.RemoveInvisibleWidget();
                         continue;
@@ -465,7 +511,7 @@ namespace OHOS::uitest {
                     visitWidgets.clear();
                     return;
                 }
-                if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!myselfWidget.IsVisible()) {
                     continue;
                 }
                 std::reference_wrapper<Widget const> tempWidget = visitWidgets.back();
@@ -503,6 +549,7 @@ namespace OHOS::uitest {
                         const DumpOption &option) override
         {
             elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
             SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
             std::vector<int> fakeTargetWidgets;
             while (true) {
@@ -512,13 +559,13 @@ namespace OHOS::uitest {
                 }
                 myselfWidget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
                 myselfWidget.SetDisplayId(window.displayId_);
-                if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!myselfWidget.IsVisible()) {
                     LOG_D("Widget %{public}s is invisible", myselfWidget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
                     elementNodeRef.RemoveInvisibleWidget();
                     continue;
                 }
                 RefreshWidgetBounds(myselfWidget, window);
-                if (myselfWidget.GetAttr(UiAttr::VISIBLE) == "false") {
+                if (!myselfWidget.IsVisible()) {
                     continue;
                 }
                 visitWidgets.emplace_back(move(myselfWidget));
@@ -697,6 +744,272 @@ namespace OHOS::uitest {
         std::vector<std::vector<WidgetMatchModel>> multiWithInAnchorMatcher;
     };
 
+    class PlanSelectorStrategy : public SelectStrategy {
+    public:
+        explicit PlanSelectorStrategy(std::vector<std::shared_ptr<const SelectPlan>> plans)
+        {
+            for (auto &plan : plans) {
+                wantMulti_ = wantMulti_ || plan->wantMulti_;
+                states_.emplace_back();
+                states_.back().plan_ = move(plan);
+            }
+        }
+
+        void LocateNode(const Window &window,
+                        ElementNodeIterator &elementNodeRef,
+                        std::vector<Widget> &visitWidgets,
+                        std::vector<int> &targetWidgets,
+                        const DumpOption &option) override
+        {
+            std::vector<std::vector<int>> planTargets;
+            LocateNodes(window, elementNodeRef, visitWidgets, planTargets, option);
+            for (const auto &targets : planTargets) {
+                targetWidgets.insert(targetWidgets.end(), targets.begin(), targets.end());
+            }
+        }
+
+        // streaming select, only the candidates are kept in visitWidgets, the others are dropped once matched
+        void LocateNodes(const Window &window,
+                         ElementNodeIterator &elementNodeRef,
+                         std::vector<Widget> &visitWidgets,
+                         std::vector<std::vector<int>> &targetWidgets,
+                         [[maybe_unused]] const DumpOption &option) override
+        {
+            elementNodeRef.ClearDFSNext();
+            clipChain_.clear();
+            SetAndCalcSelectWindowRect(window.bounds_, window.invisibleBoundsVec_);
+            if (targetWidgets.size() < states_.size()) {
+                targetWidgets.resize(states_.size());
+            }
+            std::vector<size_t> targetCounts;
+            for (size_t plan = 0; plan < states_.size(); plan++) {
+                ResetState(states_[plan]);
+                targetCounts.emplace_back(targetWidgets[plan].size());
+            }
+            const auto visitCount = visitWidgets.size();
+            auto pending = states_.size();
+            int32_t travelTimes = 0;
+            int32_t visibleOrder = 0;
+            // the plans taking the current node as a candidate
+            std::vector<size_t> takers;
+            while (pending > 0) {
+                Widget widget{"planWidget"};
+                if (!elementNodeRef.DFSNext(widget, window.id_)) {
+                    break;
+                }
+                if (++travelTimes > MAX_STREAM_TRAVEL_TIMES) {
+                    LOG_E("ElementInfos obtained from AAMS is abnormal, traversal node failed");
+                    visitWidgets.erase(visitWidgets.begin() + visitCount, visitWidgets.end());
+                    for (size_t plan = 0; plan < states_.size(); plan++) {
+                        targetWidgets[plan].resize(targetCounts[plan]);
+                    }
+                    return;
+                }
+                widget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(window.id_));
+                widget.SetDisplayId(window.displayId_);
+                for (auto &state : states_) {
+                    InheritParentMarks(state, widget);
+                }
+                if (!widget.IsVisible()) {
+                    LOG_D("Widget %{public}s is invisible", widget.GetAttr(UiAttr::ACCESSIBILITY_ID).data());
+                    elementNodeRef.RemoveInvisibleWidget();
+                    continue;
+                }
+                RefreshWidgetBounds(widget, window);
+                if (!widget.IsVisible()) {
+                    if (IsClippedOut(widget)) {
+                        // none of the descendants can be visible, so none of them matches
+                        elementNodeRef.RemoveInvisibleWidget();
+                    }
+                    continue;
+                }
+                const auto order = visibleOrder++;
+                takers.clear();
+                for (size_t plan = 0; plan < states_.size(); plan++) {
+                    auto &state = states_[plan];
+                    if (state.settled_) {
+                        continue;
+                    }
+                    const bool candidate = IsCandidate(state, widget);
+                    MatchAnchors(state, widget, order);
+                    // a later candidate can not be selected before the first one in single mode
+                    if (candidate && (state.plan_->wantMulti_ || state.candidates_.empty())) {
+                        takers.emplace_back(plan);
+                    }
+                }
+                if (!takers.empty()) {
+                    visitWidgets.emplace_back(move(widget));
+                    for (auto plan : takers) {
+                        states_[plan].candidates_.emplace_back(order, visitWidgets.size() - 1);
+                    }
+                }
+                for (size_t plan = 0; plan < states_.size(); plan++) {
+                    auto &state = states_[plan];
+                    if (!state.settled_ && !state.plan_->wantMulti_ && !state.candidates_.empty() &&
+                        IsBeforeRearAnchors(state, state.candidates_.front().first)) {
+                        targetWidgets[plan].emplace_back(state.candidates_.front().second);
+                        state.settled_ = true;
+                        pending--;
+                    }
+                }
+                if (visitWidgets.size() - visitCount >= static_cast<size_t>(MAX_TRAVEL_TIMES)) {
+                    LOG_W("Too many candidates, stop selecting at %{public}d nodes", travelTimes);
+                    break;
+                }
+            }
+            for (size_t plan = 0; plan < states_.size(); plan++) {
+                const auto &state = states_[plan];
+                if (state.settled_) {
+                    continue;
+                }
+                for (const auto &[order, index] : state.candidates_) {
+                    if (!IsBeforeRearAnchors(state, order)) {
+                        continue;
+                    }
+                    targetWidgets[plan].emplace_back(index);
+                    if (!state.plan_->wantMulti_) {
+                        break;
+                    }
+                }
+            }
+            LOG_D("Select by %{public}zu plans, %{public}zu candidates kept of %{public}d nodes", states_.size(),
+                  visitWidgets.size() - visitCount, travelTimes);
+        }
+
+        StrategyEnum GetStrategyType() const override
+        {
+            return StrategyEnum::PLAN;
+        }
+
+        ~PlanSelectorStrategy() override = default;
+
+    private:
+        struct PlanState {
+            std::shared_ptr<const SelectPlan> plan_;
+            bool settled_ = false;
+            size_t frontPending_ = 0;
+            std::vector<bool> frontMatched_;
+            std::vector<int32_t> rearLastOrder_;
+            // node position and parent marks of each depth on the current ancestor chain
+            std::vector<int32_t> markNodes_;
+            std::vector<uint8_t> markChain_;
+            // visible order and position in visitWidgets of each candidate
+            std::vector<std::pair<int32_t, int>> candidates_;
+        };
+
+        static void ResetState(PlanState &state)
+        {
+            state.settled_ = false;
+            state.frontPending_ = state.plan_->frontMatchers_.size();
+            state.frontMatched_.assign(state.plan_->frontMatchers_.size(), false);
+            state.rearLastOrder_.assign(state.plan_->rearMatchers_.size(), -1);
+            state.markNodes_.clear();
+            state.markChain_.clear();
+            state.candidates_.clear();
+        }
+
+        bool IsClippedOut(const Widget &widget) const
+        {
+            const auto depth = widget.GetDepth();
+            if (widget.GetNodeIndex() < 0 || depth < 0 || static_cast<size_t>(depth) >= clipChain_.size()) {
+                return false;
+            }
+            const auto &clip = clipChain_[depth];
+            return clip.nodeIndex_ == widget.GetNodeIndex() && clip.clipped_ &&
+                (clip.empty_ || clip.rect_.GetWidth() <= 0 || clip.rect_.GetHeight() <= 0);
+        }
+
+        // the parent locators matched by the ancestor chain, parentCount marks per depth
+        static void InheritParentMarks(PlanState &state, const Widget &widget)
+        {
+            const auto parentCount = state.plan_->parentMatchers_.size();
+            const auto nodeIndex = widget.GetNodeIndex();
+            const auto depth = widget.GetDepth();
+            if (state.settled_ || parentCount == 0 || nodeIndex < 0 || depth < 0) {
+                return;
+            }
+            // truncate to the node first, the parent one level above is kept
+            state.markNodes_.resize(depth + 1, -1);
+            state.markChain_.resize((depth + 1) * parentCount, 0);
+            const auto parentMarks = FindParentMarks(state, widget);
+            state.markNodes_[depth] = nodeIndex;
+            for (size_t locator = 0; locator < parentCount; locator++) {
+                state.markChain_[depth * parentCount + locator] = parentMarks != nullptr ? parentMarks[locator] : 0;
+            }
+        }
+
+        // marks of the parent if it is on the ancestor chain
+        static const uint8_t *FindParentMarks(const PlanState &state, const Widget &widget)
+        {
+            const auto parentIndex = widget.GetParentNodeIndex();
+            const auto depth = widget.GetDepth();
+            if (parentIndex < 0 || depth <= 0 || static_cast<size_t>(depth) > state.markNodes_.size() ||
+                state.markNodes_[depth - 1] != parentIndex) {
+                return nullptr;
+            }
+            return state.markChain_.data() + (depth - 1) * state.plan_->parentMatchers_.size();
+        }
+
+        static bool IsCandidate(const PlanState &state, const Widget &widget)
+        {
+            if (state.frontPending_ > 0 || !widget.MatchSelector(state.plan_->selfMatchers_)) {
+                return false;
+            }
+            const auto parentCount = state.plan_->parentMatchers_.size();
+            if (parentCount == 0) {
+                return true;
+            }
+            const auto parentMarks = FindParentMarks(state, widget);
+            if (parentMarks == nullptr) {
+                return false;
+            }
+            for (size_t locator = 0; locator < parentCount; locator++) {
+                if (parentMarks[locator] == 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static void MatchAnchors(PlanState &state, const Widget &widget, int32_t order)
+        {
+            const auto &plan = *state.plan_;
+            for (size_t locator = 0; locator < plan.frontMatchers_.size(); locator++) {
+                if (!state.frontMatched_[locator] && widget.MatchSelector(plan.frontMatchers_[locator])) {
+                    state.frontMatched_[locator] = true;
+                    state.frontPending_--;
+                }
+            }
+            for (size_t locator = 0; locator < plan.rearMatchers_.size(); locator++) {
+                if (widget.MatchSelector(plan.rearMatchers_[locator])) {
+                    state.rearLastOrder_[locator] = order;
+                }
+            }
+            const auto parentCount = plan.parentMatchers_.size();
+            const auto depth = widget.GetDepth();
+            if (parentCount == 0 || widget.GetNodeIndex() < 0 || depth < 0) {
+                return;
+            }
+            for (size_t locator = 0; locator < parentCount; locator++) {
+                if (widget.MatchSelector(plan.parentMatchers_[locator])) {
+                    state.markChain_[depth * parentCount + locator] = 1;
+                }
+            }
+        }
+
+        static bool IsBeforeRearAnchors(const PlanState &state, int32_t order)
+        {
+            for (auto rearOrder : state.rearLastOrder_) {
+                if (rearOrder <= order) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        std::vector<PlanState> states_;
+    };
+
     static std::unique_ptr<SelectStrategy> BuildComplexStrategy(const StrategyBuildParam &buildParam, bool isWantMulti)
     {
         std::unique_ptr<ComplexSelectorStrategy> selectStrategy = std::make_unique<ComplexSelectorStrategy>();
@@ -755,6 +1068,38 @@ namespace OHOS::uitest {
         return selectStrategy;
     }
 
+    std::shared_ptr<const SelectPlan> SelectStrategy::CompilePlan(const StrategyBuildParam &buildParam,
+                                                                  bool isWantMulti)
+    {
+        auto plan = std::make_shared<SelectPlan>();
+        plan->selfMatchers_ = buildParam.myselfMatcher;
+        plan->frontMatchers_ = buildParam.afterAnchorMatcherVec;
+        plan->rearMatchers_ = buildParam.beforeAnchorMatcherVec;
+        plan->parentMatchers_ = buildParam.withInAnchorMatcherVec;
+        plan->wantMulti_ = isWantMulti;
+        return plan;
+    }
+
+    std::unique_ptr<SelectStrategy> SelectStrategy::BuildPlanStrategy(std::shared_ptr<const SelectPlan> plan)
+    {
+        return BuildPlanStrategy(std::vector<std::shared_ptr<const SelectPlan>>{move(plan)});
+    }
+
+    std::unique_ptr<SelectStrategy> SelectStrategy::BuildPlanStrategy(
+        std::vector<std::shared_ptr<const SelectPlan>> plans)
+    {
+        return std::make_unique<PlanSelectorStrategy>(move(plans));
+    }
+
+    void SelectStrategy::LocateNodes(const Window &window, ElementNodeIterator &elementNodeRef,
+        vector<Widget> &visitWidgets, vector<vector<int>> &targetWidgets, const DumpOption &option)
+    {
+        if (targetWidgets.empty()) {
+            targetWidgets.resize(1);
+        }
+        LocateNode(window, elementNodeRef, visitWidgets, targetWidgets.front(), option);
+    }
+
     std::unique_ptr<SelectStrategy> SelectStrategy::BuildSelectStrategy(const StrategyBuildParam &buildParam,
                                                                         bool isWantMulti)
     {
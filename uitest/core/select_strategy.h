@@ -26,6 +26,7 @@ namespace OHOS::uitest {
         IS_AFTER,
         IS_BEFORE,
         COMPLEX,
+        PLAN,
     };
 
     struct StrategyBuildParam {
@@ -35,10 +36,24 @@ namespace OHOS::uitest {
         std::vector<std::vector<WidgetMatchModel>> withInAnchorMatcherVec;
     };
 
+    /**Locators of a selector compiled once, the self, front, rear and parent locators are evaluated together.*/
+    struct SelectPlan {
+        std::vector<WidgetMatchModel> selfMatchers_;
+        std::vector<std::vector<WidgetMatchModel>> frontMatchers_;
+        std::vector<std::vector<WidgetMatchModel>> rearMatchers_;
+        std::vector<std::vector<WidgetMatchModel>> parentMatchers_;
+        bool wantMulti_ = false;
+    };
+
     class SelectStrategy {
     public:
         SelectStrategy() = default;
         static unique_ptr<SelectStrategy> BuildSelectStrategy(const StrategyBuildParam &buildParam, bool isWantMulti);
+        static std::shared_ptr<const SelectPlan> CompilePlan(const StrategyBuildParam &buildParam, bool isWantMulti);
+        /**Build the strategy which selects by the plan in a single traversal.*/
+        static unique_ptr<SelectStrategy> BuildPlanStrategy(std::shared_ptr<const SelectPlan> plan);
+        /**Build the strategy which selects by all the plans in the same single traversal.*/
+        static unique_ptr<SelectStrategy> BuildPlanStrategy(std::vector<std::shared_ptr<const SelectPlan>> plans);
         virtual void SetAndCalcSelectWindowRect(const Rect &windowBounds, const std::vector<Rect> &windowBoundsVec);
         virtual std::string Describe() const;
         virtual void RegisterAnchorMatch(const WidgetMatchModel &matchModel);
@@ -47,17 +62,32 @@ namespace OHOS::uitest {
         virtual StrategyEnum GetStrategyType() const = 0;
         virtual void LocateNode(const Window &window, ElementNodeIterator &elementNodeRef,
             vector<Widget> &visitWidgets, vector<int> &targetWidgets, const DumpOption &option) = 0;
+        /**Locate the targets of each plan in one traversal, the targets of plan i are appended to targetWidgets[i].
+         * Strategies other than the plan one have a single target list.*/
+        virtual void LocateNodes(const Window &window, ElementNodeIterator &elementNodeRef,
+            vector<Widget> &visitWidgets, vector<vector<int>> &targetWidgets, const DumpOption &option);
         virtual ~SelectStrategy();
 
     protected:
         virtual void RefreshWidgetBounds(Widget &widget, const Window &window);
         virtual void CalcWidgetVisibleBounds(Widget &widget);
+        void RecordNodeClip(const Widget &widget);
         std::vector<WidgetMatchModel> anchorMatch_;
         std::vector<WidgetMatchModel> myselfMatch_;
         bool wantMulti_ = false;
         Rect windowBounds_{0, 0, 0, 0};
-        std::vector<Rect> overplayWindowBoundsVec_;
-        std::map<string, Rect> clipers_;
+        // the window bounds minus the overplay windows, built once per window
+        VisibleRegion visibleRegion_;
+        struct NodeClip {
+            int32_t nodeIndex_ = -1;
+            bool clipped_ = false;
+            bool empty_ = false;
+            Rect rect_{0, 0, 0, 0};
+        };
+        /**Clip of the parent node if it is on the current ancestor chain, otherwise nullptr.*/
+        const NodeClip *FindParentClip(const Widget &widget) const;
+        // clip applied to the children of each node on the current ancestor chain, indexed by the node depth
+        std::vector<NodeClip> clipChain_;
     };
 } // namespace OHOS::uitest
 
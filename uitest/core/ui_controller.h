@@ -17,10 +17,12 @@
 #define UI_CONTROLLER_H
 
 #include <list>
+#include <map>
 #include <string>
 #include <sstream>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
 #include "nlohmann/json.hpp"
 #include "ui_action.h"
@@ -100,11 +102,55 @@ namespace OHOS::uitest {
             return false;
         };
 
+        /**Fetch the nodes of the windows concurrently, iterators[i] receives the nodes of windows[i],
+         * or nullptr if that fetch failed.*/
+        virtual void GetWidgetsInWindows(const vector<const Window *> &windows,
+            vector<unique_ptr<ElementNodeIterator>> &iterators, AamsWorkMode mode)
+        {
+            iterators.clear();
+            iterators.resize(windows.size());
+            RunConcurrently(windows.size(), MAX_FETCH_WORKERS, [&](size_t index) {
+                if (!GetWidgetsInWindow(*windows[index], iterators[index], mode)) {
+                    iterators[index] = nullptr;
+                }
+            });
+        };
+
         virtual bool WaitForUiSteady(uint32_t idleThresholdMs, uint32_t timeoutSec) const
         {
             return false;
         };
 
+        /**
+         * Get the epoch of UI changes, which grows on every accessibility event that may change the UI.
+         * 0 means the events are not tracked, the UI snapshot must not be reused.
+         * */
+        virtual uint64_t GetUiEventEpoch() const
+        {
+            return 0;
+        };
+
+        /**Block until the UI event epoch moves away from the given one or timeout, returns whether it moved.*/
+        virtual bool WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs) const
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return GetUiEventEpoch() != epoch;
+        };
+
+        /**Get the count of the scroll end events in the window, 0 means the scroll events are not tracked.*/
+        virtual uint64_t GetScrollEndCount(int32_t windowId) const
+        {
+            return 0;
+        };
+
+        /**Block until a scroll in the window ends after the given count, returns false if no scroll starts in
+         * timeoutMs.*/
+        virtual bool WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+            return GetScrollEndCount(windowId) != count;
+        };
+
         virtual void InjectTouchEventSequence(const PointerMatrix& events) const {};
 
         virtual void InjectKeyEventSequence(const std::vector<KeyEvent>& events, int32_t displayId) const {};
@@ -176,6 +222,7 @@ namespace OHOS::uitest {
 
         virtual void RegisterUiEventListener(std::shared_ptr<UiEventListener> listener) const {};
 
+        /**Get the hidumper info of the window into a buffer allocated by new[], called concurrently for windows.*/
         virtual void GetHidumperInfo(std::string windowId, char **buf, size_t &len) {};
 
         virtual bool CheckDisplayExist(int32_t displayId) const
@@ -13,9 +13,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <future>
 #include <thread>
 #include <atomic>
+#include "api_call_scheduler.h"
 #include "ui_model.h"
 #include "ui_driver.h"
 
@@ -70,15 +72,51 @@ namespace OHOS::uitest {
         return true;
     }
 
+    bool UiDriver::IsUiSnapshotReusable(uint64_t epoch, int32_t targetDisplay, bool needAbilityInfo) const
+    {
+        if (epoch == 0 || epoch != snapshotEpoch_ || !eventObserverEnable_) {
+            return false;
+        }
+        if (snapshotDisplay_ != targetDisplay || snapshotMode_ != mode_) {
+            return false;
+        }
+        return snapshotWithAbilityInfo_ || !needAbilityInfo;
+    }
+
+    void UiDriver::InvalidateUiSnapshot()
+    {
+        snapshotEpoch_ = 0;
+    }
+
+    uint64_t UiDriver::GetScrollEndCount(int32_t windowId) const
+    {
+        return uiController_->GetScrollEndCount(windowId);
+    }
+
+    bool UiDriver::WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const
+    {
+        return uiController_->WaitForScrollEnd(windowId, count, timeoutMs);
+    }
+
     void UiDriver::UpdateUIWindows(ApiCallErr &error, int32_t targetDisplay,
         bool skipWaitForUiSteady, bool needAbilityInfo)
     {
         visitWidgets_.clear();
         targetWidgetsIndex_.clear();
-        displayToWindowCacheMap_.clear();
         if (!CheckStatus(true, error)) {
+            displayToWindowCacheMap_.clear();
+            InvalidateUiSnapshot();
+            return;
+        }
+        // read the epoch before fetching, so that events arriving during the fetch invalidate this snapshot
+        const auto epoch = uiController_->GetUiEventEpoch();
+        if (IsUiSnapshotReusable(epoch, targetDisplay, needAbilityInfo)) {
+            LOG_D("No ui event since last update, reuse the ui snapshot");
             return;
         }
+        displayToWindowCacheMap_.clear();
+        InvalidateUiSnapshot();
+        snapshotSeq_++;
         std::map<int32_t, vector<Window>> currentDisplayAndWindowCacheMap;
         uiController_->GetUiWindows(currentDisplayAndWindowCacheMap, targetDisplay,
             skipWaitForUiSteady, needAbilityInfo);
@@ -109,9 +147,37 @@ namespace OHOS::uitest {
             std::sort(windowCacheVec.begin(), windowCacheVec.end(), WindowCacheCompareGreater());
             displayToWindowCacheMap_.insert(make_pair(dm.first, move(windowCacheVec)));
         }
+        snapshotEpoch_ = epoch;
+        snapshotDisplay_ = targetDisplay;
+        snapshotWithAbilityInfo_ = needAbilityInfo;
+        snapshotMode_ = mode_;
     }
 
-    void UiDriver::DumpWindowsInfo(const DumpOption &option, Rect& mergeBounds, nlohmann::json& childDom)
+    void UiDriver::FetchWindowNodes(const vector<WindowCacheModel *> &winCaches)
+    {
+        vector<WindowCacheModel *> pending;
+        vector<const Window *> windows;
+        for (auto winCache : winCaches) {
+            if (winCache->widgetIterator_ == nullptr) {
+                pending.emplace_back(winCache);
+                windows.emplace_back(&winCache->window_);
+            }
+        }
+        if (windows.empty()) {
+            return;
+        }
+        vector<unique_ptr<ElementNodeIterator>> iterators;
+        uiController_->GetWidgetsInWindows(windows, iterators, mode_);
+        for (size_t index = 0; index < pending.size() && index < iterators.size(); index++) {
+            if (iterators[index] == nullptr) {
+                LOG_W("Get Widget from window[%{public}d] failed, skip the window", pending[index]->window_.id_);
+                continue;
+            }
+            pending[index]->widgetIterator_ = move(iterators[index]);
+        }
+    }
+
+    void UiDriver::LocateDumpWindows(const DumpOption &option, vector<DumpWindow> &windows, Rect &mergeBounds)
     {
         std::vector<WidgetMatchModel> emptyMatcher;
         StrategyBuildParam buildParam;
@@ -121,8 +187,8 @@ namespace OHOS::uitest {
         if (dm == displayToWindowCacheMap_.end()) {
             return;
         }
-        auto &windowCacheVec = dm->second;
-        for (auto &winCache : windowCacheVec) {
+        vector<WindowCacheModel *> winCaches;
+        for (auto &winCache : dm->second) {
             if (option.bundleName_ != "" && winCache.window_.bundleName_ != option.bundleName_) {
                 LOG_D("skip window(%{public}s), it is not target window %{public}s",
                     winCache.window_.bundleName_.data(), option.bundleName_.data());
@@ -133,30 +199,70 @@ namespace OHOS::uitest {
                     winCache.window_.id_, option.windowId_.data());
                 continue;
             }
+            // dump always fetches the latest nodes
+            winCache.widgetIterator_ = nullptr;
+            winCaches.emplace_back(&winCache);
+        }
+        FetchWindowNodes(winCaches);
+        for (auto winCachePtr : winCaches) {
+            auto &winCache = *winCachePtr;
             visitWidgets_.clear();
             targetWidgetsIndex_.clear();
-            if (!uiController_->GetWidgetsInWindow(winCache.window_, winCache.widgetIterator_, mode_)) {
-                LOG_W("Get Widget from window[%{public}d] failed, skip the window", winCache.window_.id_);
+            if (winCache.widgetIterator_ == nullptr) {
                 continue;
             }
             selectStrategy->LocateNode(winCache.window_, *winCache.widgetIterator_, visitWidgets_, targetWidgetsIndex_,
                                        option);
-            nlohmann::json child = nlohmann::json();
             if (visitWidgets_.empty()) {
                 LOG_E("Window %{public}s has no node, skip it", winCache.window_.bundleName_.data());
                 continue;
-            } else {
-                DumpHandler::DumpWindowInfoToJson(option, visitWidgets_, child);
             }
-            child["attributes"]["abilityName"] = winCache.window_.abilityName_;
-            child["attributes"]["bundleName"] = winCache.window_.bundleName_;
-            child["attributes"]["pagePath"] = winCache.window_.pagePath_;
-            childDom.emplace_back(child);
+            DumpWindow window;
+            window.window_ = &winCache.window_;
+            window.widgets_ = move(visitWidgets_);
+            windows.emplace_back(move(window));
             mergeBounds.left_ = std::min(mergeBounds.left_, winCache.window_.bounds_.left_);
             mergeBounds.top_ = std::min(mergeBounds.top_, winCache.window_.bounds_.top_);
             mergeBounds.right_ = std::max(mergeBounds.right_, winCache.window_.bounds_.right_);
             mergeBounds.bottom_ = std::max(mergeBounds.bottom_, winCache.window_.bounds_.bottom_);
         }
+        visitWidgets_.clear();
+    }
+
+    void UiDriver::DumpWindowsInfo(const DumpOption &option, Rect& mergeBounds, nlohmann::json& childDom)
+    {
+        vector<DumpWindow> windows;
+        LocateDumpWindows(option, windows, mergeBounds);
+        for (auto &window : windows) {
+            nlohmann::json child = nlohmann::json();
+            DumpHandler::DumpWindowInfoToJson(option, window.widgets_, child);
+            child["attributes"]["abilityName"] = window.window_->abilityName_;
+            child["attributes"]["bundleName"] = window.window_->bundleName_;
+            child["attributes"]["pagePath"] = window.window_->pagePath_;
+            childDom.emplace_back(child);
+        }
+    }
+
+    void UiDriver::GetHidumperInfos(int32_t displayId, map<int32_t, string_view> &elementTrees,
+        vector<unique_ptr<char[]>> &buffers)
+    {
+        auto dm = displayToWindowCacheMap_.find(displayId);
+        if (dm == displayToWindowCacheMap_.end()) {
+            return;
+        }
+        const auto &winCaches = dm->second;
+        vector<char *> results(winCaches.size(), nullptr);
+        vector<size_t> lens(winCaches.size(), 0);
+        RunConcurrently(winCaches.size(), MAX_FETCH_WORKERS, [this, &winCaches, &results, &lens](size_t index) {
+            uiController_->GetHidumperInfo(to_string(winCaches[index].window_.id_), &results[index], lens[index]);
+        });
+        for (size_t index = 0; index < winCaches.size(); index++) {
+            if (results[index] == nullptr) {
+                continue;
+            }
+            elementTrees.insert(make_pair(winCaches[index].window_.id_, string_view(results[index], lens[index])));
+            buffers.emplace_back(results[index]);
+        }
     }
 
     void UiDriver::DumpUiHierarchy(nlohmann::json &out, DumpOption &option, ApiCallErr &error)
@@ -166,8 +272,7 @@ namespace OHOS::uitest {
         if (error.code_ != NO_ERROR) {
             return;
         }
-        auto dm = displayToWindowCacheMap_.find(option.displayId_);
-        if (dm == displayToWindowCacheMap_.end()) {
+        if (displayToWindowCacheMap_.find(option.displayId_) == displayToWindowCacheMap_.end()) {
             LOG_E("Get windows id display %{public}d failed, dump error.", option.displayId_);
             error = ApiCallErr(ERR_INTERNAL, "Get window nodes failed");
             return;
@@ -191,26 +296,37 @@ namespace OHOS::uitest {
         }
         if (option.addExternAttr_) {
             map<int32_t, string_view> elementTrees;
-            vector<char *> buffers;
-            auto &windowCacheVec = dm->second;
-            for (auto &winCache : windowCacheVec) {
-                char *buffer = nullptr;
-                size_t len = 0;
-                uiController_->GetHidumperInfo(to_string(winCache.window_.id_), &buffer, len);
-                if (buffer == nullptr) {
-                    continue;
-                }
-                elementTrees.insert(make_pair(winCache.window_.id_, string_view(buffer, len)));
-                buffers.push_back(buffer);
-            }
-            DumpHandler::AddExtraAttrs(out, elementTrees, 0);
-            for (auto &buf : buffers) {
-                delete buf;
-            }
+            vector<unique_ptr<char[]>> buffers;
+            GetHidumperInfos(option.displayId_, elementTrees, buffers);
+            DumpHandler::AddExtraAttrs(out, elementTrees);
+        }
+    }
+
+    void UiDriver::DumpUiHierarchy(JsonStreamWriter &writer, DumpOption &option, ApiCallErr &error)
+    {
+        option.displayId_ = uiController_->GetValidDisplayId(option.displayId_);
+        UpdateUIWindows(error, option.displayId_, false, true);
+        if (error.code_ != NO_ERROR) {
+            return;
+        }
+        if (displayToWindowCacheMap_.find(option.displayId_) == displayToWindowCacheMap_.end()) {
+            LOG_E("Get windows id display %{public}d failed, dump error.", option.displayId_);
+            error = ApiCallErr(ERR_INTERNAL, "Get window nodes failed");
+            return;
+        }
+        vector<DumpWindow> windows;
+        Rect mergeBounds{0, 0, 0, 0};
+        LocateDumpWindows(option, windows, mergeBounds);
+        map<int32_t, string_view> elementTrees;
+        vector<unique_ptr<char[]>> buffers;
+        if (option.addExternAttr_) {
+            GetHidumperInfos(option.displayId_, elementTrees, buffers);
         }
+        DumpHandler::DumpLayoutToStream(option, mergeBounds, windows, option.addExternAttr_ ? &elementTrees : nullptr,
+            writer);
     }
 
-    static unique_ptr<Widget> CloneFreeWidget(const Widget &from, const string &selectDesc)
+    unique_ptr<Widget> UiDriver::CloneFreeWidget(const Widget &from, const string &selectDesc)
     {
         auto clone = from.Clone(from.GetHierarchy());
         clone->SetAttr(UiAttr::DUMMY_ATTRNAME_SELECTION, selectDesc + from.GetAttr(UiAttr::HASHCODE));
@@ -251,6 +367,12 @@ namespace OHOS::uitest {
         return "";
     }
 
+    bool UiDriver::IsWidgetCurrent(const Widget &widget) const
+    {
+        const auto epoch = widget.GetSnapshotEpoch();
+        return epoch != 0 && eventObserverEnable_ && epoch == uiController_->GetUiEventEpoch();
+    }
+
     const Widget *UiDriver::RetrieveWidget(const Widget &widget, ApiCallErr &err, bool updateUi)
     {
         if (updateUi) {
@@ -318,6 +440,7 @@ namespace OHOS::uitest {
         if (events.empty()) {
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->InjectKeyEventSequence(events, displayId);
     }
 
@@ -330,6 +453,7 @@ namespace OHOS::uitest {
             error = ApiCallErr(ERR_INVALID_INPUT, "Invalid display id.");
             return;
         }
+        InvalidateUiSnapshot();
         if (action.IsMouseKeyCombo()) {
             vector<MouseEvent> mouseEvents;
             action.ComputeMouseEvents(mouseEvents, opt);
@@ -346,10 +470,11 @@ namespace OHOS::uitest {
     }
 
     void UiDriver::FindWidgets(const WidgetSelector &selector, vector<unique_ptr<Widget>> &rev,
-        ApiCallErr &err, bool updateUi, bool skipWaitForUiSteady)
+        ApiCallErr &err, bool updateUi, bool skipWaitForUiSteady, const UiOpArgs &opt)
     {
-        UiOpArgs opt;
         if (!skipWaitForUiSteady) {
+            // let the other reads take the ui snapshot during the wait
+            ApiCallYield yield;
             uiController_->WaitForUiSteady(opt.uiSteadyThresholdMs_, opt.waitUiSteadyMaxMs_);
         }
         if (updateUi) {
@@ -362,28 +487,32 @@ namespace OHOS::uitest {
             targetWidgetsIndex_.clear();
         }
         auto appLocator = selector.GetAppLocator();
+        vector<WindowCacheModel *> winCaches;
         for (auto &dm : displayToWindowCacheMap_) {
-            auto &windowCacheVec = dm.second;
-            for (auto &curWinCache : windowCacheVec) {
-                if (appLocator != "" && curWinCache.window_.bundleName_ != appLocator) {
-                    continue;
-                }
-                if (curWinCache.widgetIterator_ == nullptr &&
-                    !uiController_->GetWidgetsInWindow(curWinCache.window_, curWinCache.widgetIterator_, mode_)) {
-                    continue;
-                }
-                selector.Select(curWinCache.window_, *curWinCache.widgetIterator_, visitWidgets_, targetWidgetsIndex_);
-                if (!selector.IsWantMulti() && !targetWidgetsIndex_.empty()) {
-                    break;
-                }
-                if (!selector.IsWantMulti()) {
-                    visitWidgets_.clear();
-                    targetWidgetsIndex_.clear();
+            for (auto &curWinCache : dm.second) {
+                if (appLocator == "" || curWinCache.window_.bundleName_ == appLocator) {
+                    winCaches.emplace_back(&curWinCache);
                 }
             }
+        }
+        for (size_t index = 0; index < winCaches.size(); index++) {
+            auto &curWinCache = *winCaches[index];
+            if (curWinCache.widgetIterator_ == nullptr) {
+                // the single target is mostly in the top window, fetch it alone first and then the rest together
+                const auto fetchEnd = (!selector.IsWantMulti() && index == 0) ? index + 1 : winCaches.size();
+                FetchWindowNodes(vector<WindowCacheModel *>(winCaches.begin() + index, winCaches.begin() + fetchEnd));
+            }
+            if (curWinCache.widgetIterator_ == nullptr) {
+                continue;
+            }
+            selector.Select(curWinCache.window_, *curWinCache.widgetIterator_, visitWidgets_, targetWidgetsIndex_);
             if (!selector.IsWantMulti() && !targetWidgetsIndex_.empty()) {
                 break;
             }
+            if (!selector.IsWantMulti()) {
+                visitWidgets_.clear();
+                targetWidgetsIndex_.clear();
+            }
         }
         if (targetWidgetsIndex_.empty()) {
             LOG_W("self node not found by %{public}s", selector.Describe().data());
@@ -393,26 +522,197 @@ namespace OHOS::uitest {
         uint32_t index = 0;
         for (auto targetIndex : targetWidgetsIndex_) {
             auto image = CloneFreeWidget(visitWidgets_[targetIndex], selector.Describe());
+            image->SetSnapshotEpoch(snapshotEpoch_);
             // at sometime, more than one widgets are found, add the node index to the description
             rev.emplace_back(move(image));
             index++;
         }
     }
 
+    void UiDriver::FindWidgetsBatch(const vector<const WidgetSelector *> &selectors,
+        vector<vector<unique_ptr<Widget>>> &rev, ApiCallErr &err)
+    {
+        rev.clear();
+        rev.resize(selectors.size());
+        vector<string> descriptions;
+        for (const auto selector : selectors) {
+            descriptions.emplace_back(selector->Describe());
+        }
+        VisitWidgetsBatch(selectors, [this, &rev, &descriptions](size_t index, const Widget &widget) {
+            rev[index].emplace_back(CloneFreeWidget(widget, descriptions[index]));
+            rev[index].back()->SetSnapshotEpoch(snapshotEpoch_);
+        }, err);
+    }
+
+    void UiDriver::VisitWidgetsBatch(const vector<const WidgetSelector *> &selectors,
+        const function<void(size_t, const Widget &)> &visitor, ApiCallErr &err, const UiOpArgs &opt)
+    {
+        if (selectors.empty()) {
+            return;
+        }
+        uiController_->WaitForUiSteady(opt.uiSteadyThresholdMs_, opt.waitUiSteadyMaxMs_);
+        // fetch all the displays if the selectors target different ones
+        auto targetDisplay = selectors.front()->GetDisplayLocator();
+        for (const auto selector : selectors) {
+            if (selector->GetDisplayLocator() != targetDisplay) {
+                targetDisplay = UNASSIGNED;
+                break;
+            }
+        }
+        UpdateUIWindows(err, targetDisplay, false);
+        if (err.code_ != NO_ERROR) {
+            return;
+        }
+        // the windows wanted by any selector are fetched together up front
+        vector<WindowCacheModel *> winCaches;
+        for (auto &dm : displayToWindowCacheMap_) {
+            for (auto &curWinCache : dm.second) {
+                auto wanted = [&dm, &curWinCache](const WidgetSelector *selector) {
+                    const auto appLocator = selector->GetAppLocator();
+                    const auto displayLocator = selector->GetDisplayLocator();
+                    return (appLocator == "" || curWinCache.window_.bundleName_ == appLocator) &&
+                        (displayLocator == UNASSIGNED || dm.first == displayLocator);
+                };
+                if (std::any_of(selectors.begin(), selectors.end(), wanted)) {
+                    winCaches.emplace_back(&curWinCache);
+                }
+            }
+        }
+        FetchWindowNodes(winCaches);
+        vector<vector<int>> targets(selectors.size());
+        vector<const WidgetSelector *> windowSelectors;
+        vector<size_t> windowSelectorIndexes;
+        vector<vector<int>> windowTargets;
+        for (auto &dm : displayToWindowCacheMap_) {
+            for (auto &curWinCache : dm.second) {
+                windowSelectors.clear();
+                windowSelectorIndexes.clear();
+                for (size_t index = 0; index < selectors.size(); index++) {
+                    const auto selector = selectors[index];
+                    const auto appLocator = selector->GetAppLocator();
+                    const auto displayLocator = selector->GetDisplayLocator();
+                    // the single target selectors are done once found, as FindWidgets does
+                    if ((!selector->IsWantMulti() && !targets[index].empty()) ||
+                        (appLocator != "" && curWinCache.window_.bundleName_ != appLocator) ||
+                        (displayLocator != UNASSIGNED && dm.first != displayLocator)) {
+                        continue;
+                    }
+                    windowSelectors.emplace_back(selector);
+                    windowSelectorIndexes.emplace_back(index);
+                }
+                if (windowSelectors.empty()) {
+                    continue;
+                }
+                if (curWinCache.widgetIterator_ == nullptr) {
+                    continue;
+                }
+                windowTargets.clear();
+                WidgetSelector::SelectBatch(windowSelectors, curWinCache.window_, *curWinCache.widgetIterator_,
+                    visitWidgets_, windowTargets);
+                for (size_t index = 0; index < windowSelectorIndexes.size(); index++) {
+                    auto &selectorTargets = targets[windowSelectorIndexes[index]];
+                    selectorTargets.insert(selectorTargets.end(), windowTargets[index].begin(),
+                        windowTargets[index].end());
+                }
+            }
+        }
+        for (size_t index = 0; index < selectors.size(); index++) {
+            for (auto targetIndex : targets[index]) {
+                visitor(index, visitWidgets_[targetIndex]);
+            }
+        }
+    }
+
+    void UiDriver::BuildSpatialIndexes()
+    {
+        spatialIndexes_.clear();
+        vector<WindowCacheModel *> winCaches;
+        for (auto &dm : displayToWindowCacheMap_) {
+            for (auto &curWinCache : dm.second) {
+                winCaches.emplace_back(&curWinCache);
+            }
+        }
+        FetchWindowNodes(winCaches);
+        WidgetSelector selector;
+        selector.SetWantMulti(true);
+        vector<int> targets;
+        for (auto winCache : winCaches) {
+            if (winCache->widgetIterator_ == nullptr) {
+                continue;
+            }
+            targets.clear();
+            selector.Select(winCache->window_, *winCache->widgetIterator_, visitWidgets_, targets);
+            auto &index = spatialIndexes_[winCache->window_.displayId_];
+            for (auto target : targets) {
+                index.Add(visitWidgets_[target], winCache->window_.windowLayer_);
+            }
+        }
+        for (auto &dm : spatialIndexes_) {
+            dm.second.Build();
+        }
+        spatialIndexSeq_ = snapshotSeq_;
+    }
+
+    unique_ptr<Widget> UiDriver::FindWidgetAt(const Point &point, ApiCallErr &err, const UiOpArgs &opt)
+    {
+        uiController_->WaitForUiSteady(opt.uiSteadyThresholdMs_, opt.waitUiSteadyMaxMs_);
+        UpdateUIWindows(err, point.displayId_);
+        if (err.code_ != NO_ERROR) {
+            return nullptr;
+        }
+        if (spatialIndexSeq_ != snapshotSeq_) {
+            BuildSpatialIndexes();
+        }
+        for (const auto &dm : spatialIndexes_) {
+            if (point.displayId_ != UNASSIGNED && dm.first != point.displayId_) {
+                continue;
+            }
+            const auto widget = dm.second.Find(point);
+            if (widget != nullptr) {
+                const auto desc = "{point=(" + to_string(point.px_) + "," + to_string(point.py_) + ")}";
+                auto image = CloneFreeWidget(*widget, desc);
+                image->SetSnapshotEpoch(snapshotEpoch_);
+                return image;
+            }
+        }
+        return nullptr;
+    }
+
     unique_ptr<Widget> UiDriver::WaitForWidget(const WidgetSelector &selector, const UiOpArgs &opt, ApiCallErr &err)
     {
         const uint32_t sliceMs = 20;
+        // re-evaluate at this rate even without ui events, in case some changes are not reported
+        const uint32_t fallbackPollMs = 500;
         const auto startMs = GetCurrentMillisecond();
         vector<unique_ptr<Widget>> receiver;
+        bool steadySinceLastFind = false;
         do {
-            FindWidgets(selector, receiver, err);
+            // take the epoch before finding, so the changes during finding still wake up the next wait
+            const auto epoch = uiController_->GetUiEventEpoch();
+            // an event may come in the middle of a transition, wait for ui steady unless no event came since then
+            FindWidgets(selector, receiver, err, true, steadySinceLastFind, opt);
             if (err.code_ != NO_ERROR) { // abort on error
                 return nullptr;
             }
             if (!receiver.empty()) {
                 return move(receiver.at(0));
             }
-            DelayMs(sliceMs);
+            const auto costMs = GetCurrentMillisecond() - startMs;
+            if (costMs >= opt.waitWidgetMaxMs_) {
+                break;
+            }
+            const auto leftMs = static_cast<uint32_t>(opt.waitWidgetMaxMs_ - costMs);
+            // let the other reads take the ui snapshot during the wait
+            ApiCallYield yield;
+            if (epoch == 0) {
+                // the ui events are not tracked, poll
+                DelayMs(std::min(sliceMs, leftMs));
+                steadySinceLastFind = false;
+            } else {
+                const auto waitMs = std::min(fallbackPollMs, leftMs);
+                const auto changed = uiController_->WaitForUiEvent(epoch, waitMs);
+                steadySinceLastFind = !changed && waitMs >= opt.uiSteadyThresholdMs_;
+            }
         } while (GetCurrentMillisecond() - startMs < opt.waitWidgetMaxMs_);
         return nullptr;
     }
@@ -441,6 +741,7 @@ namespace OHOS::uitest {
             return;
         }
         events.SetTouchPressure(opt.touchPressure_);
+        InvalidateUiSnapshot();
         uiController_->InjectTouchEventSequence(events);
     }
 
@@ -467,6 +768,7 @@ namespace OHOS::uitest {
                 if (events.empty()) {
                     return;
                 }
+                InvalidateUiSnapshot();
                 uiController_->InjectMouseEventSequence(events);
                 return;
             }
@@ -482,6 +784,7 @@ namespace OHOS::uitest {
             err = ApiCallErr(ERR_INVALID_INPUT, "Invalid display id.");
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->InjectMouseEventSequence(events);
     }
 
@@ -554,6 +857,7 @@ namespace OHOS::uitest {
         if (!CheckStatus(false, error)) {
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->SetDisplayRotation(rotation);
     }
 
@@ -683,6 +987,7 @@ namespace OHOS::uitest {
         if (events.empty()) {
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->InjectTouchPadEventSequence(events);
     }
 
@@ -712,6 +1017,7 @@ namespace OHOS::uitest {
             err = ApiCallErr(ERR_INVALID_INPUT, "Invalid display id.");
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->InjectTouchEventSequence(eventsInPen);
     }
 
@@ -733,6 +1039,7 @@ namespace OHOS::uitest {
             err = ApiCallErr(ERR_INVALID_PARAM, "Invalid display id.");
             return;
         }
+        InvalidateUiSnapshot();
         uiController_->InjectTouchEventSequence(events);
         return;
 #endif
@@ -768,12 +1075,14 @@ namespace OHOS::uitest {
     void UiDriver::CloseAamsEvent()
     {
         eventObserverEnable_ = false;
+        InvalidateUiSnapshot();
         return uiController_->CloseAamsEvent();
     }
 
     void UiDriver::OpenAamsEvent()
     {
         eventObserverEnable_ = true;
+        InvalidateUiSnapshot();
         return uiController_->OpenAamsEvent();
     }
 
@@ -782,8 +1091,9 @@ namespace OHOS::uitest {
         return eventObserverEnable_;
     }
 
-    void UiDriver::ChangeWindowMode(int32_t windowId, WindowMode mode) const
+    void UiDriver::ChangeWindowMode(int32_t windowId, WindowMode mode)
     {
+        InvalidateUiSnapshot();
         return uiController_->ChangeWindowMode(windowId, mode);
     }
 
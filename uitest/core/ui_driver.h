@@ -19,6 +19,8 @@
 #include "ui_controller.h"
 #include "ui_action.h"
 #include "widget_selector.h"
+#include "json_stream_writer.h"
+#include "widget_spatial_index.h"
 
 namespace OHOS::uitest {
     struct WindowCacheModel {
@@ -35,22 +37,54 @@ namespace OHOS::uitest {
         /**Find widgets with the given selector. Results are arranged in the receiver in <b>DFS</b> order.
          * @returns the widget object.
          **/
+        /**Find the widgets, waits for the UI steady by the thresholds in opt unless skipWaitForUiSteady.*/
         void FindWidgets(const WidgetSelector &select, vector<unique_ptr<Widget>> &rev,
-            ApiCallErr &err, bool updateUi = true, bool skipWaitForUiSteady = false);
+            ApiCallErr &err, bool updateUi = true, bool skipWaitForUiSteady = false, const UiOpArgs &opt = UiOpArgs());
+
+        /**Find widgets with each of the selectors on one UI snapshot, all selectors are evaluated in one traversal
+         * of each window. The widgets of selectors[i] are put in rev[i], in <b>DFS</b> order.*/
+        void FindWidgetsBatch(const vector<const WidgetSelector *> &selectors,
+            vector<vector<unique_ptr<Widget>>> &rev, ApiCallErr &err);
+
+        /**Clone the selected widget out of the UI snapshot, the selection is recorded on the clone.*/
+        static std::unique_ptr<Widget> CloneFreeWidget(const Widget &from, const std::string &selectDesc);
+
+        /**Select with each of the selectors on one UI snapshot like FindWidgetsBatch, but visit the selected widgets
+         * in place instead of cloning them. visitor receives the selector index and the widget.*/
+        void VisitWidgetsBatch(const vector<const WidgetSelector *> &selectors,
+            const std::function<void(size_t, const Widget &)> &visitor, ApiCallErr &err,
+            const UiOpArgs &opt = UiOpArgs());
+
+        /**Find the top-most visible widget at the point. The widgets are indexed once per UI snapshot, so lookups on
+         * an unchanged UI do not traverse the windows again. All the displays are looked up if the point has none.*/
+        std::unique_ptr<Widget> FindWidgetAt(const Point &point, ApiCallErr &err, const UiOpArgs &opt = UiOpArgs());
 
         /**Wait for the matching widget appear in the given timeout.*/
         std::unique_ptr<Widget> WaitForWidget(const WidgetSelector &select, const UiOpArgs &opt, ApiCallErr &err);
         /**Find window matching the given matcher.*/
         std::unique_ptr<Window> FindWindow(std::function<bool(const Window &)> matcher, ApiCallErr &err);
 
+        /**Tell if the widget is taken from the UI snapshot of the current UI, so it can be read without retrieving.*/
+        bool IsWidgetCurrent(const Widget &widget) const;
+
         /**Retrieve widget from updated UI.*/
         const Widget *RetrieveWidget(const Widget &widget, ApiCallErr &err, bool updateUi = true);
 
         /**Retrieve window from updated UI.*/
         Window *RetrieveWindow(const Window &window, ApiCallErr &err);
 
+        /**Drop the cached UI snapshot, the next query will fetch windows and nodes from the system again.*/
+        void InvalidateUiSnapshot();
+
         string GetHostApp(const Widget &widget);
 
+        /**Get the count of the scroll end events in the window, 0 means the scroll events are not tracked.*/
+        uint64_t GetScrollEndCount(int32_t windowId) const;
+
+        /**Wait until a scroll in the window ends after the given count, returns false if no scroll starts in
+         * timeoutMs.*/
+        bool WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const;
+
         /**Trigger the given key action. */
         void TriggerKey(const KeyAction &key, const UiOpArgs &opt, ApiCallErr &error, int32_t displayId = -1);
 
@@ -69,6 +103,10 @@ namespace OHOS::uitest {
 
         void DumpUiHierarchy(nlohmann::json &out, DumpOption &option, ApiCallErr &error);
 
+        /**Dump the UI hierarchy to the writer as the nodes are visited, without building the json tree. Nothing is
+         * written if it fails.*/
+        void DumpUiHierarchy(JsonStreamWriter &writer, DumpOption &option, ApiCallErr &error);
+
         const FrontEndClassDef &GetFrontendClassDef() const override
         {
             return DRIVER_DEF;
@@ -118,7 +156,7 @@ namespace OHOS::uitest {
 
         void OpenAamsEvent();
 
-        void ChangeWindowMode(int32_t windowId, WindowMode mode) const;
+        void ChangeWindowMode(int32_t windowId, WindowMode mode);
 
         bool GetEventObserverEnable() const;
 
@@ -158,7 +196,17 @@ namespace OHOS::uitest {
         // UI objects that are needed to be updated before each interaction and used in the interaction
         void UpdateUIWindows(ApiCallErr &error, int32_t targetDisplay = -1,
             bool skipWaitForUiSteady = false, bool needAbilityInfo = false);
+        bool IsUiSnapshotReusable(uint64_t epoch, int32_t targetDisplay, bool needAbilityInfo) const;
         void DumpWindowsInfo(const DumpOption &option, Rect &mergeBounds, nlohmann::json &childDom);
+        /**Locate the nodes of the windows to dump, the windows without any node are skipped.*/
+        void LocateDumpWindows(const DumpOption &option, vector<DumpWindow> &windows, Rect &mergeBounds);
+        /**Get the hidumper info of the windows in the display concurrently, which is kept in the buffers.*/
+        void GetHidumperInfos(int32_t displayId, map<int32_t, string_view> &elementTrees,
+            vector<unique_ptr<char[]>> &buffers);
+        /**Fetch the nodes of the windows which have none yet concurrently, the failed ones are left without nodes.*/
+        void FetchWindowNodes(const vector<WindowCacheModel *> &winCaches);
+        /**Index the visible widgets of all the windows in the snapshot by display.*/
+        void BuildSpatialIndexes();
         
         struct DisplayInfo {
             Point topLeft;
@@ -179,6 +227,15 @@ namespace OHOS::uitest {
         std::vector<int> targetWidgetsIndex_;
         static AamsWorkMode mode_;
         bool eventObserverEnable_ = true;
+        // ui event epoch at which displayToWindowCacheMap_ was fetched, 0 means there is no reusable snapshot
+        uint64_t snapshotEpoch_ = 0;
+        int32_t snapshotDisplay_ = -1;
+        bool snapshotWithAbilityInfo_ = false;
+        AamsWorkMode snapshotMode_ = AamsWorkMode::NORMAL;
+        // count of the snapshots fetched, which tells if the spatial indexes are built on the current one
+        uint64_t snapshotSeq_ = 0;
+        uint64_t spatialIndexSeq_ = 0;
+        std::map<int32_t, WidgetSpatialIndex> spatialIndexes_;
     };
 } // namespace OHOS::uitest
 
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common_utilities_hpp.h"
+#include "ui_idle_detector.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    void UiIdleDetector::OnUiEvent(uint64_t eventMillis)
+    {
+        lock_guard<mutex> locker(mtx_);
+        lastEventMillis_ = max(lastEventMillis_, eventMillis);
+    }
+
+    uint64_t UiIdleDetector::GetLastEventMillis()
+    {
+        lock_guard<mutex> locker(mtx_);
+        if (lastEventMillis_ == 0) {
+            lastEventMillis_ = GetCurrentMillisecond();
+        }
+        return lastEventMillis_;
+    }
+
+    bool UiIdleDetector::WaitIdle(uint32_t idleThresholdMs, uint32_t timeoutMs, uint64_t &idleLatencyMs)
+    {
+        unique_lock<mutex> locker(mtx_);
+        const auto startMs = GetCurrentMillisecond();
+        const auto deadlineMs = startMs + timeoutMs;
+        if (lastEventMillis_ == 0) {
+            lastEventMillis_ = startMs;
+        }
+        while (true) {
+            const auto currentMs = GetCurrentMillisecond();
+            const auto idleMs = lastEventMillis_ + idleThresholdMs;
+            if (currentMs >= idleMs) {
+                idleLatencyMs = currentMs - max(idleMs, startMs);
+                return true;
+            }
+            if (currentMs >= deadlineMs) {
+                idleLatencyMs = 0;
+                return false;
+            }
+            // no need to be notified, the events only postpone the idle moment which is checked on wake-up
+            cond_.wait_for(locker, chrono::milliseconds(min(idleMs, deadlineMs) - currentMs));
+        }
+    }
+} // namespace OHOS::uitest
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_IDLE_DETECTOR_H
+#define UI_IDLE_DETECTOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace OHOS::uitest {
+    /**Detects the UI idle by the timestamps of the UI events. Waiters sleep on a condition variable until the
+     * threshold elapses after the last event, an event arriving meanwhile only moves that moment later.*/
+    class UiIdleDetector {
+    public:
+        /**Record an UI event which happened at the given millisecond of GetCurrentMillisecond.*/
+        void OnUiEvent(uint64_t eventMillis);
+
+        uint64_t GetLastEventMillis();
+
+        /**Wait until no event comes in idleThresholdMs or timeoutMs elapses, returns whether the UI is idle.
+         * idleLatencyMs receives the time from the UI becoming idle to this wait returning.*/
+        bool WaitIdle(uint32_t idleThresholdMs, uint32_t timeoutMs, uint64_t &idleLatencyMs);
+
+    private:
+        std::mutex mtx_;
+        std::condition_variable cond_;
+        uint64_t lastEventMillis_ = 0;
+    };
+} // namespace OHOS::uitest
+
+#endif
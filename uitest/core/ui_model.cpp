@@ -14,6 +14,7 @@
  */
 
 #include <algorithm>
+#include <charconv>
 #include "ui_model.h"
 #include <regex.h>
 #include <iostream>
@@ -22,6 +23,64 @@ namespace OHOS::uitest {
     using namespace std;
     using namespace nlohmann;
 
+    static constexpr string_view TRUE_VALUE = "true";
+    static constexpr string_view FALSE_VALUE = "false";
+
+    // attributes that are kept as number when the value is an integer
+    static bool IsIntAttr(UiAttr attrId)
+    {
+        return attrId == UiAttr::ACCESSIBILITY_ID || attrId == UiAttr::HOST_WINDOW_ID ||
+            attrId == UiAttr::DISPLAY_ID || attrId == UiAttr::ZINDEX || attrId == UiAttr::UNIQUEID;
+    }
+
+    // long enough for the text of any int64 value with a terminating null char
+    static constexpr size_t INT_TEXT_SIZE = 24;
+
+    // write the text of the number into buffer with a terminating null char
+    static string_view FormatInt(int64_t value, char *begin, char *end)
+    {
+        auto result = to_chars(begin, end - 1, value);
+        *result.ptr = '\0';
+        return string_view(begin, result.ptr - begin);
+    }
+
+    // accept only the integers which can be restored exactly, values like "01" or "-0" are kept as string
+    static bool ParseInt(string_view text, int64_t &value)
+    {
+        if (text.empty()) {
+            return false;
+        }
+        auto result = from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec != errc() || result.ptr != text.data() + text.size()) {
+            return false;
+        }
+        char buffer[INT_TEXT_SIZE];
+        return FormatInt(value, buffer, buffer + INT_TEXT_SIZE) == text;
+    }
+
+    // format as "[left,top][right,bottom]" with a terminating null char
+    static string_view FormatRect(const Rect &rect, char *begin, char *end)
+    {
+        char *pos = begin;
+        *pos++ = '[';
+        pos = to_chars(pos, end, rect.left_).ptr;
+        *pos++ = ',';
+        pos = to_chars(pos, end, rect.top_).ptr;
+        *pos++ = ']';
+        *pos++ = '[';
+        pos = to_chars(pos, end, rect.right_).ptr;
+        *pos++ = ',';
+        pos = to_chars(pos, end, rect.bottom_).ptr;
+        *pos++ = ']';
+        *pos = '\0';
+        return string_view(begin, pos - begin);
+    }
+
+    const string *AttrStringPool::Intern(string &&value)
+    {
+        return &(*strings_.insert(move(value)).first);
+    }
+
     void Widget::SetBounds(const Rect &bounds)
     {
         bounds_ = bounds;
@@ -37,8 +96,9 @@ namespace OHOS::uitest {
     {
         stringstream os;
         os << "Widget{";
+        AttrBuffer buffer;
         for (int i = 0; i < UiAttr::MAX; i++) {
-            os << ATTR_NAMES[i] << "='" << attributeVec_[i] << "',";
+            os << ATTR_NAMES[i] << "='" << ViewAttr(static_cast<UiAttr>(i), buffer) << "',";
         }
         os << "}";
         return os.str();
@@ -49,29 +109,109 @@ namespace OHOS::uitest {
         auto clone = make_unique<Widget>(hierarchy);
         clone->bounds_ = this->bounds_;
         clone->displayId_ = this->displayId_;
-        clone->attributeVec_ = attributeVec_;
+        clone->attrCells_ = attrCells_;
+        clone->intAttrs_ = intAttrs_;
+        clone->boolAttrs_ = boolAttrs_;
+        clone->boolValues_ = boolValues_;
+        clone->attrPool_ = attrPool_;
+        // the clone may outlive the snapshot, give it a pool of its own
+        clone->SetAttrPool(make_shared<AttrStringPool>());
         return clone;
     }
 
     std::vector<std::string> Widget::GetAttrVec() const
     {
-        std::vector<std::string> retVec = attributeVec_;
-        if (attributeVec_[UiAttr::BOUNDS].empty()) {
-            stringstream boundStream;
-            boundStream << "[" << bounds_.left_ << "," << bounds_.top_ << "][" << bounds_.right_ << ","
-                        << bounds_.bottom_ << "]";
-            retVec[UiAttr::BOUNDS] = boundStream.str();
+        std::vector<std::string> retVec(UiAttr::MAX + 1);
+        for (int i = 0; i < UiAttr::MAX; i++) {
+            retVec[i] = GetAttr(static_cast<UiAttr>(i));
         }
         return retVec;
     }
 
+    void Widget::ClearAttr(UiAttr attrId)
+    {
+        intAttrs_.reset(attrId);
+        boolAttrs_.reset(attrId);
+        boolValues_.reset(attrId);
+        attrCells_[attrId].str_ = nullptr;
+    }
+
     void Widget::SetAttr(UiAttr attrId, string value)
     {
         if (attrId >= UiAttr::MAX) {
             LOG_E("Error attrId %{public}d, check it", attrId);
             return;
         }
-        attributeVec_[attrId] = value;
+        if (attrId == UiAttr::HIERARCHY) {
+            SetHierarchy(value);
+            return;
+        }
+        ClearAttr(attrId);
+        if (value.empty()) {
+            return;
+        }
+        if (value == TRUE_VALUE || value == FALSE_VALUE) {
+            boolAttrs_.set(attrId);
+            boolValues_.set(attrId, value == TRUE_VALUE);
+            return;
+        }
+        int64_t number = 0;
+        if (IsIntAttr(attrId) && ParseInt(value, number)) {
+            intAttrs_.set(attrId);
+            attrCells_[attrId].num_ = number;
+            return;
+        }
+        if (attrPool_ == nullptr) {
+            attrPool_ = make_shared<AttrStringPool>();
+        }
+        attrCells_[attrId].str_ = attrPool_->Intern(move(value));
+    }
+
+    void Widget::SetIntAttr(UiAttr attrId, int64_t value)
+    {
+        if (attrId >= UiAttr::MAX || attrId == UiAttr::HIERARCHY) {
+            SetAttr(attrId, to_string(value));
+            return;
+        }
+        ClearAttr(attrId);
+        intAttrs_.set(attrId);
+        attrCells_[attrId].num_ = value;
+    }
+
+    void Widget::SetAttrPool(shared_ptr<AttrStringPool> pool)
+    {
+        if (pool == nullptr || pool == attrPool_) {
+            return;
+        }
+        for (size_t index = 0; index < UiAttr::MAX; index++) {
+            if (!intAttrs_[index] && attrCells_[index].str_ != nullptr) {
+                attrCells_[index].str_ = pool->Intern(string(*attrCells_[index].str_));
+            }
+        }
+        attrPool_ = move(pool);
+    }
+
+    string_view Widget::ViewAttr(UiAttr attrId, AttrBuffer &buffer) const
+    {
+        if (attrId >= UiAttr::MAX) {
+            return "";
+        }
+        if (attrId == UiAttr::HIERARCHY) {
+            return hierarchy_;
+        }
+        if (boolAttrs_[attrId]) {
+            return boolValues_[attrId] ? TRUE_VALUE : FALSE_VALUE;
+        }
+        if (intAttrs_[attrId]) {
+            return FormatInt(attrCells_[attrId].num_, buffer.data(), buffer.data() + buffer.size());
+        }
+        if (attrCells_[attrId].str_ != nullptr) {
+            return *attrCells_[attrId].str_;
+        }
+        if (attrId == UiAttr::BOUNDS) {
+            return FormatRect(bounds_, buffer.data(), buffer.data() + buffer.size());
+        }
+        return "";
     }
 
     std::string Widget::GetAttr(UiAttr attrId) const
@@ -79,35 +219,114 @@ namespace OHOS::uitest {
         if (attrId >= UiAttr::MAX) {
             return "none";
         }
-        if (attrId == UiAttr::BOUNDS && attributeVec_[UiAttr::BOUNDS].empty()) {
-            stringstream boundStream;
-            boundStream << "[" << bounds_.left_ << "," << bounds_.top_ << "][" << bounds_.right_ << ","
-                        << bounds_.bottom_ << "]";
-            return boundStream.str();
+        AttrBuffer buffer;
+        return string(ViewAttr(attrId, buffer));
+    }
+
+    size_t Widget::GetMemoryBytes() const
+    {
+        size_t bytes = sizeof(Widget) + hierarchy_.capacity();
+        for (size_t attrId = 0; attrId < UiAttr::MAX; attrId++) {
+            // the pooled strings are shared with the other widgets of the snapshot, counted as if owned
+            if (!intAttrs_[attrId] && attrCells_[attrId].str_ != nullptr) {
+                bytes += sizeof(string) + attrCells_[attrId].str_->capacity();
+            }
         }
-        return attributeVec_[attrId];
+        return bytes;
     }
 
-    bool RegexMatchAttr(std::string_view value, std::string_view attrValue, int flags)
+    /**POSIX regular expression compiled once, freed along with the object.*/
+    class CompiledRegex {
+    public:
+        CompiledRegex(const string &pattern, int flags)
+        {
+            valid_ = regcomp(&regex_, pattern.c_str(), flags) == 0;
+            if (!valid_) {
+                LOG_W("Invalid regular expression: %{public}s", pattern.c_str());
+            }
+        }
+
+        ~CompiledRegex()
+        {
+            if (valid_) {
+                regfree(&regex_);
+            }
+        }
+
+        CompiledRegex(const CompiledRegex &) = delete;
+        CompiledRegex &operator=(const CompiledRegex &) = delete;
+
+        // the text must be null terminated
+        bool Match(const char *text) const
+        {
+            return valid_ && regexec(&regex_, text, 0, nullptr, 0) == 0;
+        }
+
+    private:
+        regex_t regex_;
+        bool valid_ = false;
+    };
+
+    RegexCache &RegexCache::Get()
     {
-        regex_t preg;
-        char *patternValue = const_cast<char*>(value.data());
-        char *patternReg = const_cast<char*>(attrValue.data());
-        if ((regcomp(&preg, patternValue, flags)) != 0) {
-            return false;
+        static RegexCache cache;
+        return cache;
+    }
+
+    shared_ptr<const CompiledRegex> RegexCache::Acquire(string_view pattern, int flags)
+    {
+        lock_guard<mutex> guard(mutex_);
+        auto find = index_.find(make_pair(flags, pattern));
+        if (find != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, find->second);
+            return find->second->second;
         }
-        if (regexec(&preg, patternReg, 0, nullptr, 0) != 0) {
-            return false;
+        auto key = make_pair(flags, string(pattern));
+        auto compiled = make_shared<const CompiledRegex>(key.second, flags);
+        compileCount_++;
+        entries_.emplace_front(key, compiled);
+        index_.emplace(move(key), entries_.begin());
+        if (entries_.size() > CAPACITY) {
+            // the evicted pattern is freed once no matching is using it
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
         }
-        return true;
+        return compiled;
+    }
+
+    bool RegexCache::Match(string_view pattern, int flags, const char *text)
+    {
+        return Acquire(pattern, flags)->Match(text);
+    }
+
+    size_t RegexCache::Size() const
+    {
+        lock_guard<mutex> guard(mutex_);
+        return entries_.size();
+    }
+
+    uint64_t RegexCache::GetCompileCount() const
+    {
+        lock_guard<mutex> guard(mutex_);
+        return compileCount_;
+    }
+
+    void RegexCache::Clear()
+    {
+        lock_guard<mutex> guard(mutex_);
+        index_.clear();
+        entries_.clear();
     }
-    
+
+
     bool Widget::MatchAttr(const WidgetMatchModel& matchModel) const
     {
         UiAttr attr = matchModel.attrName;
         std::string_view value = matchModel.attrValue;
         ValueMatchPattern pattern = matchModel.pattern;
-        std::string_view attrValue = attributeVec_[attr];
+        AttrBuffer buffer;
+        // the viewed value is always null terminated, which is required by regexec
+        std::string_view attrValue = ViewAttr(attr, buffer);
         switch (pattern) {
             case ValueMatchPattern::EQ:
                 return attrValue == value;
@@ -123,12 +342,12 @@ namespace OHOS::uitest {
             case ValueMatchPattern::REG_EXP:
                 {
                     auto flags = REG_EXTENDED;
-                    return RegexMatchAttr(value, attrValue, flags);
+                    return RegexCache::Get().Match(value, flags, attrValue.data());
                 }
             case ValueMatchPattern::REG_EXP_ICASE:
                 {
                     auto flags = REG_EXTENDED | REG_ICASE;
-                    return RegexMatchAttr(value, attrValue, flags);
+                    return RegexCache::Get().Match(value, flags, attrValue.data());
                 }
             default:
                 break;
@@ -149,26 +368,28 @@ namespace OHOS::uitest {
     void Widget::SetHierarchy(const std::string &hierarch)
     {
         hierarchy_ = hierarch;
-        attributeVec_[UiAttr::HIERARCHY] = hierarch;
     }
 
     void Widget::WrapperWidgetToJson(nlohmann::json &out, const std::string extendedAttrs)
+    {
+        vector<pair<string_view, string>> attrs;
+        WrapperWidgetToAttrs(attrs, extendedAttrs);
+        for (auto &[name, value] : attrs) {
+            out[name.data()] = move(value);
+        }
+    }
+
+    void Widget::WrapperWidgetToAttrs(vector<pair<string_view, string>> &out, const std::string &extendedAttrs) const
     {
         for (int i = 0; i < UiAttr::HIERARCHY + 1; ++i) {
-            if (i == UiAttr::BOUNDS && attributeVec_[UiAttr::BOUNDS].empty()) {
-                stringstream boundStream;
-                boundStream << "[" << bounds_.left_ << "," << bounds_.top_ << "][" << bounds_.right_ << ","
-                            << bounds_.bottom_ << "]";
-                attributeVec_[i] = boundStream.str();
-            }
-            out[ATTR_NAMES[i].data()] = attributeVec_[i];
+            out.emplace_back(ATTR_NAMES[i], GetAttr(static_cast<UiAttr>(i)));
         }
-        out[ATTR_NAMES[UiAttr::VISIBLE].data()] = attributeVec_[UiAttr::VISIBLE];
-        out[ATTR_NAMES[UiAttr::HASHCODE].data()] = attributeVec_[UiAttr::HASHCODE];
-        out[ATTR_NAMES[UiAttr::HINT].data()] = attributeVec_[UiAttr::HINT];
+        out.emplace_back(ATTR_NAMES[UiAttr::VISIBLE], GetAttr(UiAttr::VISIBLE));
+        out.emplace_back(ATTR_NAMES[UiAttr::HASHCODE], GetAttr(UiAttr::HASHCODE));
+        out.emplace_back(ATTR_NAMES[UiAttr::HINT], GetAttr(UiAttr::HINT));
         for (int i = UiAttr::UNIQUEID; i < UiAttr::HASHCODE; ++i) {
             if (extendedAttrs.find(ATTR_NAMES[i].data()) != std::string::npos) {
-                out[ATTR_NAMES[i].data()] = attributeVec_[i];
+                out.emplace_back(ATTR_NAMES[i], GetAttr(static_cast<UiAttr>(i)));
             }
         }
     }
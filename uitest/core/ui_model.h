@@ -16,8 +16,14 @@
 #ifndef UI_MODEL_H
 #define UI_MODEL_H
 
+#include <array>
+#include <bitset>
+#include <list>
+#include <mutex>
 #include <vector>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 #include "common_utilities_hpp.h"
 #include "frontend_api_handler.h"
 #include "nlohmann/json.hpp"
@@ -84,6 +90,8 @@ namespace OHOS::uitest {
         bool notMergeWindow_ = false;
         int32_t displayId_ = 0;
         string extendedAttrs_ = "";
+        // path of the previous layout to write the diff against, empty to write the full layout
+        string diffBasePath_ = "";
     };
 
     /**Supported UiComponent attribute names. Ordered by <code>UiAttr</code> definition.*/
@@ -210,6 +218,49 @@ namespace OHOS::uitest {
         ValueMatchPattern pattern;
     };
 
+    class CompiledRegex;
+
+    /**Bounded LRU cache of compiled regular expressions, shared by all the REG_EXP matchings.*/
+    class RegexCache {
+    public:
+        static constexpr size_t CAPACITY = 64;
+
+        static RegexCache &Get();
+
+        /**Get the compiled pattern, compile it if not cached. The returned object is freed with its last owner.*/
+        std::shared_ptr<const CompiledRegex> Acquire(std::string_view pattern, int flags);
+
+        /**Tells if the null terminated text matches the pattern, false is returned for invalid pattern.*/
+        bool Match(std::string_view pattern, int flags, const char *text);
+
+        size_t Size() const;
+
+        /**Count of the pattern compilations, for statistic.*/
+        uint64_t GetCompileCount() const;
+
+        void Clear();
+
+    private:
+        struct KeyLess {
+            using is_transparent = void;
+            template <typename KeyA, typename KeyB>
+            bool operator()(const KeyA &keyA, const KeyB &keyB) const
+            {
+                if (keyA.first != keyB.first) {
+                    return keyA.first < keyB.first;
+                }
+                return std::string_view(keyA.second) < std::string_view(keyB.second);
+            }
+        };
+        using Key = std::pair<int, std::string>;
+        using Entry = std::pair<Key, std::shared_ptr<const CompiledRegex>>;
+        mutable std::mutex mutex_;
+        // most recently used entry in the front
+        std::list<Entry> entries_;
+        std::map<Key, std::list<Entry>::iterator, KeyLess> index_;
+        uint64_t compileCount_ = 0;
+    };
+
     /**Algorithm of rectangle.*/
     class RectAlgorithm {
     public:
@@ -259,13 +310,86 @@ namespace OHOS::uitest {
         return false;
     }
 
+    /**Rectangles stored as the structure of arrays, for the batch computations over many of them.*/
+    struct RectArrays {
+        std::vector<int32_t> left_;
+        std::vector<int32_t> right_;
+        std::vector<int32_t> top_;
+        std::vector<int32_t> bottom_;
+
+        size_t Size() const
+        {
+            return left_.size();
+        }
+
+        void Add(const Rect &rect)
+        {
+            left_.emplace_back(rect.left_);
+            right_.emplace_back(rect.right_);
+            top_.emplace_back(rect.top_);
+            bottom_.emplace_back(rect.bottom_);
+        }
+
+        Rect Get(size_t index) const
+        {
+            return Rect(left_[index], right_[index], top_[index], bottom_[index]);
+        }
+    };
+
+    /**Visible region of a window, the window bounds minus the overlays, kept as y-bands of sorted disjoint x-spans.
+     * It is built once per window, then the largest visible rectangle of a rectangle inside the window bounds is
+     * the same as RectAlgorithm::ComputeMaxVisibleRegion of it with the overlays, without walking them again.
+     * The computations share the buffers of the region, it is not thread safe.*/
+    class VisibleRegion {
+    public:
+        void Reset(const Rect &bounds, const std::vector<Rect> &overlays);
+
+        /**Tells if any overlay covers part of the bounds.*/
+        bool IsOccluded() const
+        {
+            return occluded_;
+        }
+
+        /**Compute the largest visible rectangle in the rect, the part out of the bounds is invisible.*/
+        bool ComputeMaxVisibleRect(const Rect &rect, Rect &out) const;
+
+        /**Replace each rectangle with its largest visible rectangle, the invisible ones become (0, 0, 0, 0).*/
+        void ComputeMaxVisibleRects(RectArrays &rects) const;
+
+    private:
+        Rect bounds_{0, 0, 0, 0};
+        bool occluded_ = false;
+        // band i covers [bandEdges_[i], bandEdges_[i + 1]), its spans are [spanStarts_[i], spanStarts_[i + 1])
+        std::vector<int32_t> bandEdges_;
+        std::vector<size_t> spanStarts_;
+        std::vector<int32_t> spanLefts_;
+        std::vector<int32_t> spanRights_;
+        // buffers reused by the computations
+        mutable std::vector<int32_t> xs_;
+        mutable std::vector<int64_t> covers_;
+        mutable std::vector<int64_t> heights_;
+        mutable std::vector<size_t> stack_;
+    };
+
+    /**Pool of interned attribute values, shared by the widgets of one UI snapshot. It is not thread safe.*/
+    class AttrStringPool {
+    public:
+        /**Get the pooled copy of the value, which keeps valid in the lifetime of the pool.*/
+        const std::string *Intern(std::string &&value);
+
+        size_t Size() const
+        {
+            return strings_.size();
+        }
+
+    private:
+        std::unordered_set<std::string> strings_;
+    };
+
     class Widget : public BackendClass {
     public:
         // disable default constructor, copy constructor and assignment operator
-        explicit Widget(std::string_view hierarchy) : hierarchy_(hierarchy)
-        {
-            attributeVec_[UiAttr::HIERARCHY] = hierarchy;
-        };
+        explicit Widget(std::string_view hierarchy) : hierarchy_(hierarchy) {};
 
         ~Widget() override {}
 
@@ -294,10 +418,34 @@ namespace OHOS::uitest {
             return displayId_;
         }
 
+        /**Position of the node in the nodes batch of its window, -1 if it's not from a batch.*/
+        int32_t GetNodeIndex() const
+        {
+            return nodeIndex_;
+        }
+
+        /**Position of the parent node in the nodes batch, -1 for the root.*/
+        int32_t GetParentNodeIndex() const
+        {
+            return parentNodeIndex_;
+        }
+
+        int32_t GetDepth() const
+        {
+            return depth_;
+        }
+
+        void SetNodePosition(int32_t index, int32_t parentIndex, int32_t depth)
+        {
+            nodeIndex_ = index;
+            parentNodeIndex_ = parentIndex;
+            depth_ = depth;
+        }
+
         void SetDisplayId(const int32_t id)
         {
             displayId_ = id;
-            attributeVec_[UiAttr::DISPLAY_ID] = to_string(id);
+            SetIntAttr(UiAttr::DISPLAY_ID, id);
         }
 
         void SetBounds(const Rect &bounds);
@@ -312,13 +460,48 @@ namespace OHOS::uitest {
 
         bool IsVisible() const
         {
-            return GetAttr(UiAttr::VISIBLE) == "true";
+            return GetBoolAttr(UiAttr::VISIBLE);
+        }
+
+        /**Tells if the attribute value is "true", without building the string value.*/
+        bool GetBoolAttr(UiAttr attrId) const
+        {
+            return attrId < UiAttr::MAX && boolAttrs_[attrId] && boolValues_[attrId];
+        }
+
+        /**Get the attribute value stored as integer, returns false if it is not an integer.*/
+        bool GetIntAttr(UiAttr attrId, int64_t &value) const
+        {
+            if (attrId >= UiAttr::MAX || !intAttrs_[attrId]) {
+                return false;
+            }
+            value = attrCells_[attrId].num_;
+            return true;
         }
 
         void SetAttr(UiAttr attrId, string value);
 
+        void SetIntAttr(UiAttr attrId, int64_t value);
+
         std::string GetAttr(UiAttr attrId) const;
 
+        /**Estimate the bytes kept by this widget, its pooled attribute strings included.*/
+        size_t GetMemoryBytes() const;
+
+        /**Epoch of the ui snapshot the widget is taken from, 0 if it is unknown.*/
+        uint64_t GetSnapshotEpoch() const
+        {
+            return snapshotEpoch_;
+        }
+
+        void SetSnapshotEpoch(uint64_t epoch)
+        {
+            snapshotEpoch_ = epoch;
+        }
+
+        /**Share the given string pool, the string values already set are interned into it.*/
+        void SetAttrPool(std::shared_ptr<AttrStringPool> pool);
+
         bool MatchAttr(const WidgetMatchModel& matchModel) const;
 
         bool MatchSelector(const std::vector<WidgetMatchModel>& matchers) const;
@@ -326,12 +509,34 @@ namespace OHOS::uitest {
         void SetHierarchy(const std::string& hierarch);
 
         void WrapperWidgetToJson(nlohmann::json& out, const std::string extendedAttrs = "");
+
+        /**Collect the attributes dumped by WrapperWidgetToJson as name-value pairs, in no particular order.*/
+        void WrapperWidgetToAttrs(std::vector<std::pair<std::string_view, std::string>> &out,
+            const std::string &extendedAttrs = "") const;
     private:
+        // enough for the text of an int64 value or a bounds rect
+        static constexpr size_t ATTR_BUFFER_SIZE = 64;
+        using AttrBuffer = std::array<char, ATTR_BUFFER_SIZE>;
+        // value of an attribute, the active member is told by intAttrs_
+        union AttrCell {
+            const std::string *str_;
+            int64_t num_;
+        };
+        std::string_view ViewAttr(UiAttr attrId, AttrBuffer &buffer) const;
+        void ClearAttr(UiAttr attrId);
         std::string hierarchy_;
-        std::vector<string> attributeVec_ = std::vector<string>(UiAttr::MAX + 1);
+        std::array<AttrCell, UiAttr::MAX> attrCells_ {};
+        std::bitset<UiAttr::MAX> intAttrs_;
+        std::bitset<UiAttr::MAX> boolAttrs_;
+        std::bitset<UiAttr::MAX> boolValues_;
+        std::shared_ptr<AttrStringPool> attrPool_ = nullptr;
         Rect bounds_ = {0, 0, 0, 0};
         Rect origBounds_ = {0, 0, 0, 0};
         std::int32_t displayId_ = 0;
+        int32_t nodeIndex_ = -1;
+        int32_t parentNodeIndex_ = -1;
+        int32_t depth_ = 0;
+        uint64_t snapshotEpoch_ = 0;
     };
 
     // ensure Widget is movable, since we need to move a constructed Widget object into WidgetTree
@@ -380,10 +585,40 @@ namespace OHOS::uitest {
         Point offset_ = {0, 0};
     };
 
+    class JsonStreamWriter;
+
+    /**Nodes of a window to dump.*/
+    struct DumpWindow {
+        const Window *window_ = nullptr;
+        vector<Widget> widgets_;
+    };
+
+    /**Extra attributes of a node in the hidumper info, the names and values refer to the info text.*/
+    using ExtraAttrs = vector<pair<string_view, string_view>>;
+    /**Extra attributes of the nodes in the hidumper info of a window, keyed by the accessibility id.*/
+    using ExtraAttrsIndex = unordered_map<string_view, ExtraAttrs>;
+
     class DumpHandler {
     public:
-        static void AddExtraAttrs(nlohmann::json &root, const map<int32_t, string_view> &elementTrees, size_t index);
+        static void AddExtraAttrs(nlohmann::json &root, const map<int32_t, string_view> &elementTrees);
+        /**Parse the hidumper info of a window in one pass, the nodes without any extra attribute are not indexed.*/
+        static void IndexExtraAttrs(string_view elementTree, ExtraAttrsIndex &index);
         static void DumpWindowInfoToJson(const DumpOption &option, vector<Widget> &allWidget, nlohmann::json &root);
+        /**Write the layout of the windows as the nodes are visited, the output is identical to the compact dump of
+         * the json built by UiDriver::DumpUiHierarchy. elementTrees is nullptr if no extra attribute is wanted.*/
+        static void DumpLayoutToStream(const DumpOption &option, const Rect &mergeBounds, vector<DumpWindow> &windows,
+            const map<int32_t, string_view> *elementTrees, JsonStreamWriter &writer);
+        /**Diff the layout against the base one by the hashcodes of the nodes, the root is keyed by "". The diff has
+         * the added nodes, the changed attributes, extraAttrs and children of the kept ones and the removed nodes.
+         * Fails if any other node has no unique hashcode, the full layout should be used then.*/
+        static void DiffLayout(const nlohmann::json &base, const nlohmann::json &layout, nlohmann::json &diff,
+            ApiCallErr &error);
+        /**Diff the layout against the last one and keep it as the next base. The output has the diff or the full
+         * layout in "layout", which "diff" tells. The full one is given on the first capture or if the diff fails.*/
+        static void DiffLayoutWithLast(nlohmann::json &last, const nlohmann::json &layout, nlohmann::json &out);
+        /**Rebuild the full layout from the base one and the diff made against it by DiffLayout.*/
+        static void ApplyLayoutDiff(const nlohmann::json &base, const nlohmann::json &diff, nlohmann::json &layout,
+            ApiCallErr &error);
     };
     
     class WidgetHierarchyBuilder {
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common_utilities_hpp.h"
+#include "ui_scroll_tracker.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    void UiScrollTracker::OnScrollStart(uint64_t eventMillis, int32_t windowId)
+    {
+        {
+            lock_guard<mutex> locker(mtx_);
+            scrolling_ = true;
+            scrollWindowId_ = windowId;
+            scrollStartMillis_ = eventMillis;
+        }
+        cond_.notify_all();
+    }
+
+    void UiScrollTracker::OnScrollEnd(uint64_t eventMillis, int32_t windowId)
+    {
+        {
+            lock_guard<mutex> locker(mtx_);
+            scrolling_ = false;
+            scrollEndMillis_ = eventMillis;
+            scrollEndCounts_[windowId]++;
+        }
+        cond_.notify_all();
+    }
+
+    bool UiScrollTracker::WaitScrollComplete(uint32_t timeoutMs, uint32_t quietMs)
+    {
+        unique_lock<mutex> locker(mtx_);
+        while (true) {
+            const auto currentMs = GetCurrentMillisecond();
+            if (scrolling_) {
+                const auto deadlineMs = scrollStartMillis_ + timeoutMs;
+                if (currentMs >= deadlineMs) {
+                    LOG_E("wait for scrollEnd event timeout.");
+                    scrolling_ = false;
+                    scrollEndMillis_ = 0;
+                    return false;
+                }
+                cond_.wait_for(locker, chrono::milliseconds(deadlineMs - currentMs));
+                continue;
+            }
+            const auto quietEndMs = scrollEndMillis_ + quietMs;
+            if (currentMs >= quietEndMs) {
+                return true;
+            }
+            // woken up earlier by a new scroll start
+            cond_.wait_for(locker, chrono::milliseconds(quietEndMs - currentMs));
+        }
+    }
+
+    uint64_t UiScrollTracker::CountScrollEnds(int32_t windowId) const
+    {
+        auto iter = scrollEndCounts_.find(windowId);
+        return iter == scrollEndCounts_.end() ? 1 : iter->second + 1;
+    }
+
+    uint64_t UiScrollTracker::GetScrollEndCount(int32_t windowId)
+    {
+        lock_guard<mutex> locker(mtx_);
+        return CountScrollEnds(windowId);
+    }
+
+    bool UiScrollTracker::WaitScrollEnd(int32_t windowId, uint64_t endCount, uint32_t startTimeoutMs,
+        uint32_t scrollTimeoutMs)
+    {
+        unique_lock<mutex> locker(mtx_);
+        const auto startDeadlineMs = GetCurrentMillisecond() + startTimeoutMs;
+        while (CountScrollEnds(windowId) == endCount) {
+            // a started scroll of the window is waited for until it ends
+            const auto deadlineMs = scrolling_ && scrollWindowId_ == windowId ?
+                max(startDeadlineMs, scrollStartMillis_ + scrollTimeoutMs) : startDeadlineMs;
+            const auto currentMs = GetCurrentMillisecond();
+            if (currentMs >= deadlineMs) {
+                return false;
+            }
+            cond_.wait_for(locker, chrono::milliseconds(deadlineMs - currentMs));
+        }
+        return true;
+    }
+} // namespace OHOS::uitest
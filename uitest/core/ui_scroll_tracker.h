@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UI_SCROLL_TRACKER_H
+#define UI_SCROLL_TRACKER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+
+namespace OHOS::uitest {
+    /**Tracks the scroll by the scroll start and end events, waiters are woken up by the events directly. The scroll
+     * ends are counted per window, so that the scrolls of the other windows are not taken for the waited one.*/
+    class UiScrollTracker {
+    public:
+        void OnScrollStart(uint64_t eventMillis, int32_t windowId);
+
+        void OnScrollEnd(uint64_t eventMillis, int32_t windowId);
+
+        /**Wait until the scroll ends and no scroll starts again in quietMs after it, returns false if it does not
+         * end in timeoutMs since it started, the scroll is considered complete then.*/
+        bool WaitScrollComplete(uint32_t timeoutMs, uint32_t quietMs);
+
+        /**Get the count of the scroll end events in the window, starting from 1 as 0 means the scroll events are not
+         * tracked.*/
+        uint64_t GetScrollEndCount(int32_t windowId);
+
+        /**Wait until a scroll in the window ends after the given count, returns false if no scroll starts in
+         * startTimeoutMs or the started one does not end in scrollTimeoutMs since it started.*/
+        bool WaitScrollEnd(int32_t windowId, uint64_t endCount, uint32_t startTimeoutMs, uint32_t scrollTimeoutMs);
+
+    private:
+        uint64_t CountScrollEnds(int32_t windowId) const;
+        std::mutex mtx_;
+        std::condition_variable cond_;
+        std::map<int32_t, uint64_t> scrollEndCounts_;
+        int32_t scrollWindowId_ = -1;
+        bool scrolling_ = false;
+        uint64_t scrollStartMillis_ = 0;
+        uint64_t scrollEndMillis_ = 0;
+    };
+} // namespace OHOS::uitest
+
+#endif
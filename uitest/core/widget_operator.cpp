@@ -14,7 +14,8 @@
  */
 
 #include "widget_operator.h"
-#include <thread>
+#include <algorithm>
+#include <unordered_map>
 
 namespace OHOS::uitest {
     using namespace std;
@@ -22,38 +23,105 @@ namespace OHOS::uitest {
     
     static constexpr float SCROLL_MOVE_FACTOR = 0.7;
 
-    static bool IsScrolledToBorder(int oriDis,
-                                   const std::vector<unique_ptr<Widget>> &allWidgets,
-                                   const map<string, unique_ptr<Widget>> &anchorLeafWidgets,
-                                   bool vertical)
+    // the ratio range of the content shift to the swipe distance used to adapt the swipe distance
+    static constexpr float MIN_SHIFT_RATIO = 0.25;
+    static constexpr float MAX_SHIFT_RATIO = 4.0;
+
+    // a fling at the border scrolls nothing, no scroll starting in this period after it means the end is reached
+    static constexpr uint32_t FLING_SCROLL_START_TIMEOUT_MS = 500;
+    static constexpr uint32_t MAX_FLING_COUNT = 200;
+
+    /**Fingerprint of the contents in the scroll widget on one page.*/
+    struct ScrollFingerprint {
+        // hash of the ids and positions of the contents in DFS order, equal hashes mean nothing moved
+        size_t hash_ = 0;
+        // position on the scroll axis of each content by accessibility id
+        unordered_map<string, int32_t> positions_;
+    };
+
+    static void AddToFingerprint(ScrollFingerprint &page, const Widget &widget, bool vertical)
     {
-        if (oriDis < 0) {
-            return false;
+        auto id = widget.GetAttr(UiAttr::ACCESSIBILITY_ID);
+        const auto bounds = widget.GetOrigBounds();
+        const auto position = vertical ? bounds.top_ : bounds.left_;
+        static constexpr size_t hashSeed = 0x9e3779b9;
+        static constexpr size_t leftShift = 6;
+        static constexpr size_t rightShift = 2;
+        for (auto value : {hash<string>()(id), hash<int32_t>()(position)}) {
+            page.hash_ ^= value + hashSeed + (page.hash_ << leftShift) + (page.hash_ >> rightShift);
+        }
+        page.positions_.emplace(move(id), position);
+    }
+
+    /**Compares the pages before and after each turn to detect the border, and adapts the swipe distance to the
+     * observed content shift so that each turn moves the contents by about one swipe distance.*/
+    class ScrollEngine {
+    public:
+        /**Feed the page scanned after the last turn, returns whether the last turn reached the border.*/
+        bool OnPage(ScrollFingerprint &&page)
+        {
+            const auto border = turnedDistance_ > 0 && IsBorder(page);
+            last_ = move(page);
+            return border;
+        }
+
+        /**Distance of the next swipe, 0 means the whole widget.*/
+        int32_t GetDistance() const
+        {
+            if (maxDistance_ <= 0 || shiftRatio_ <= 1.0) {
+                return 0;
+            }
+            return static_cast<int32_t>(maxDistance_ / shiftRatio_);
+        }
+
+        void OnTurned(int32_t distance)
+        {
+            turnedDistance_ = distance;
+            maxDistance_ = max(maxDistance_, distance);
         }
-        int baselineValue = oriDis * SCROLL_MOVE_FACTOR;
-        size_t index = 0;
-        for (; index < allWidgets.size(); ++index) {
-            string accessibilityId = allWidgets.at(index)->GetAttr(UiAttr::ACCESSIBILITY_ID);
-            
-            auto iterator = anchorLeafWidgets.find(accessibilityId);
-            if (iterator != anchorLeafWidgets.end()) {
-                if (vertical && abs(allWidgets.at(index)->GetBounds().top_ - iterator->second->GetBounds().top_)
-                                >= baselineValue) {
-                    LOG_D("Swipe distance of component[%{public}s] is greater than baseline", accessibilityId.c_str());
-                    return false;
-                } else if (!vertical &&
-                           abs(allWidgets.at(index)->GetBounds().left_ - iterator->second->GetBounds().left_) >=
-                           baselineValue) {
-                    LOG_D("Swipe distance of component[%{public}s] is greater than baseline", accessibilityId.c_str());
-                    return false;
+
+    private:
+        bool IsBorder(const ScrollFingerprint &page)
+        {
+            if (page.hash_ == last_.hash_ && page.positions_.size() == last_.positions_.size()) {
+                LOG_D("Nothing moved after swipe");
+                return true;
+            }
+            vector<int32_t> shifts;
+            bool newContent = false;
+            for (const auto &[id, position] : page.positions_) {
+                auto iter = last_.positions_.find(id);
+                if (iter == last_.positions_.end()) {
+                    newContent = true;
+                } else {
+                    shifts.emplace_back(abs(position - iter->second));
                 }
-            } else {
-                LOG_D("Component[%{public}s] is invisible after swipe", accessibilityId.c_str());
+            }
+            if (shifts.empty()) {
+                // all the contents are replaced, they moved more than the whole widget
+                shiftRatio_ = min(MAX_SHIFT_RATIO, shiftRatio_ * TWO);
+                LOG_D("Contents are all replaced after swipe, shift ratio %{public}f", shiftRatio_);
                 return false;
             }
+            const auto maxShift = *max_element(shifts.begin(), shifts.end());
+            const auto expectedShift = turnedDistance_ * shiftRatio_;
+            if (!newContent && maxShift < expectedShift * SCROLL_MOVE_FACTOR) {
+                LOG_D("Contents moved %{public}d, less than expected %{public}f", maxShift, expectedShift);
+                return true;
+            }
+            auto median = shifts.begin() + shifts.size() / TWO;
+            nth_element(shifts.begin(), median, shifts.end());
+            const auto ratio = static_cast<float>(*median) / turnedDistance_;
+            shiftRatio_ = max(MIN_SHIFT_RATIO, min(MAX_SHIFT_RATIO, ratio));
+            LOG_D("Contents moved %{public}d by swipe %{public}d", *median, turnedDistance_);
+            return false;
         }
-        return true;
-    }
+
+        ScrollFingerprint last_;
+        int32_t turnedDistance_ = 0;
+        int32_t maxDistance_ = 0;
+        float shiftRatio_ = 1.0;
+    };
 
     static void ConstructNoFilterInWidgetSelector(WidgetSelector &scrollSelector,
                                                   const std::string &hostApp,
@@ -105,34 +173,56 @@ namespace OHOS::uitest {
         if (retrieved == nullptr || error.code_ != NO_ERROR) {
             return;
         }
-        int turnDis = -1;
-        map<string, unique_ptr<Widget>> lastWidgets;
+        WidgetSelector contents;
+        ConstructNoFilterInWidgetSelector(contents, driver_.GetHostApp(widget_), widget_.GetAttr(UiAttr::HASHCODE));
+        // the end reached by the flings is confirmed by one more page turn, or the pages are turned on to it
+        FlingToEnd(toTop, error);
+        if (error.code_ != NO_ERROR) {
+            return;
+        }
+        ScrollEngine engine;
         while (true) {
-            auto hostApp = driver_.GetHostApp(widget_);
-            WidgetSelector selector{};
-            ConstructNoFilterInWidgetSelector(selector, hostApp, widget_.GetAttr(UiAttr::HASHCODE));
-            std::vector<unique_ptr<Widget>> widgetsInScroll;
-            driver_.FindWidgets(selector, widgetsInScroll, error, true);
+            ScrollFingerprint page;
+            ScanScrollPage(contents, nullptr, true, page, error);
             if (error.code_ != NO_ERROR) {
                 LOG_E("There is error when ScrollToEnd, msg is %{public}s", error.message_.c_str());
                 return;
             }
-            if (widgetsInScroll.empty()) {
+            if (page.positions_.empty()) {
                 LOG_I("There is no child when ScrollToEnd");
                 return;
             }
-            if (toTop && IsScrolledToBorder(turnDis, widgetsInScroll, lastWidgets, true)) {
+            if (engine.OnPage(move(page))) {
                 return;
             }
-            if (!toTop && IsScrolledToBorder(turnDis, widgetsInScroll, lastWidgets, true)) {
+            TurnPage(toTop, true, engine, error);
+        }
+    }
+
+    void WidgetOperator::FlingToEnd(bool toTop, ApiCallErr &error) const
+    {
+        // only the scrolls of the window hosting the widget are waited for
+        const auto windowId = atoi(widget_.GetAttr(UiAttr::HOST_WINDOW_ID).c_str());
+        if (driver_.GetScrollEndCount(windowId) == 0) {
+            return;
+        }
+        uint32_t flingCount = 0;
+        for (; flingCount < MAX_FLING_COUNT; flingCount++) {
+            const auto endCount = driver_.GetScrollEndCount(windowId);
+            int flingDistance = 0;
+            TurnPage(toTop, 0, flingDistance, true, error, TouchOp::FLING);
+            if (error.code_ != NO_ERROR) {
                 return;
             }
-            lastWidgets.clear();
-            for (int32_t index = 0; index < widgetsInScroll.size(); index++) {
-                lastWidgets[widgetsInScroll[index]->GetAttr(UiAttr::ACCESSIBILITY_ID)] = move(widgetsInScroll[index]);
+            if (!driver_.WaitForScrollEnd(windowId, endCount, FLING_SCROLL_START_TIMEOUT_MS)) {
+                break;
             }
-            TurnPage(toTop, turnDis, true, error);
         }
+        if (flingCount == MAX_FLING_COUNT) {
+            LOG_W("Still scrolling after %{public}u flings, turn pages instead", flingCount);
+            return;
+        }
+        LOG_I("No scroll after %{public}u flings", flingCount);
     }
 
     void WidgetOperator::DragIntoWidget(const Widget &another, ApiCallErr &error) const
@@ -212,40 +302,59 @@ namespace OHOS::uitest {
             return nullptr;
         }
         bool scrollingUp = true;
-        int turnDis = -1;
-        map<string, unique_ptr<Widget>> lastWidgets;
         auto hostApp = driver_.GetHostApp(widget_);
         auto newSelector = ConstructScrollFindSelector(selector, widget_.GetAttr(UiAttr::HASHCODE), hostApp, error);
+        WidgetSelector contents;
+        ConstructNoFilterInWidgetSelector(contents, hostApp, widget_.GetAttr(UiAttr::HASHCODE));
+        ScrollEngine engine;
         while (true) {
-            std::vector<unique_ptr<Widget>> targetsInScroll;
-            driver_.FindWidgets(newSelector, targetsInScroll, error, true);
-            if (!targetsInScroll.empty()) {
-                return std::move(targetsInScroll.at(0));
+            ScrollFingerprint page;
+            auto target = ScanScrollPage(contents, &newSelector, vertical, page, error);
+            if (target != nullptr) {
+                return target;
             }
-            WidgetSelector scrollSelector;
-            ConstructNoFilterInWidgetSelector(scrollSelector, hostApp, widget_.GetAttr(UiAttr::HASHCODE));
-            std::vector<unique_ptr<Widget>> widgetsInScroll;
-            driver_.FindWidgets(scrollSelector, widgetsInScroll, error, false);
             if (error.code_ != NO_ERROR) {
                 LOG_E("There is error when Find Widget's subwidget, msg is %{public}s", error.message_.c_str());
                 return nullptr;
             }
-            if (widgetsInScroll.empty()) {
+            if (page.positions_.empty()) {
                 LOG_I("There is no child when Find Widget's subwidget");
                 return nullptr;
             }
-            if (scrollingUp && IsScrolledToBorder(turnDis, widgetsInScroll, lastWidgets, vertical)) {
+            if (engine.OnPage(move(page))) {
+                if (!scrollingUp) {
+                    LOG_W("Scroll search widget failed: %{public}s", selector.Describe().data());
+                    return nullptr;
+                }
                 scrollingUp = false;
-            } else if (IsScrolledToBorder(turnDis, widgetsInScroll, lastWidgets, vertical)) {
-                LOG_W("Scroll search widget failed: %{public}s", selector.Describe().data());
-                return nullptr;
             }
-            lastWidgets.clear();
-            for (int32_t index = 0; index < widgetsInScroll.size(); index++) {
-                lastWidgets[widgetsInScroll[index]->GetAttr(UiAttr::ACCESSIBILITY_ID)] = move(widgetsInScroll[index]);
-            }
-            TurnPage(scrollingUp, turnDis, vertical, error);
+            TurnPage(scrollingUp, vertical, engine, error);
+        }
+    }
+
+    unique_ptr<Widget> WidgetOperator::ScanScrollPage(const WidgetSelector &contents, const WidgetSelector *target,
+        bool vertical, ScrollFingerprint &page, ApiCallErr &error) const
+    {
+        vector<const WidgetSelector *> selectors = {&contents};
+        if (target != nullptr) {
+            selectors.emplace_back(target);
         }
+        unique_ptr<Widget> found = nullptr;
+        driver_.VisitWidgetsBatch(selectors, [&page, &found, target, vertical](size_t index, const Widget &widget) {
+            if (index == INDEX_ZERO) {
+                AddToFingerprint(page, widget, vertical);
+            } else if (found == nullptr) {
+                found = UiDriver::CloneFreeWidget(widget, target->Describe());
+            }
+        }, error, options_);
+        return found;
+    }
+
+    void WidgetOperator::TurnPage(bool toTop, bool vertical, ScrollEngine &engine, ApiCallErr &error) const
+    {
+        int turnedDistance = 0;
+        TurnPage(toTop, engine.GetDistance(), turnedDistance, vertical, error);
+        engine.OnTurned(turnedDistance);
     }
 
     bool WidgetOperator::CheckDeadZone(bool vertical, ApiCallErr &error)
@@ -264,7 +373,8 @@ namespace OHOS::uitest {
             return true;
         }
     }
-    void WidgetOperator::TurnPage(bool toTop, int &oriDistance, bool vertical, ApiCallErr &error) const
+    void WidgetOperator::TurnPage(bool toTop, int32_t distance, int &oriDistance, bool vertical,
+        ApiCallErr &error, TouchOp op) const
     {
         auto bounds = widget_.GetBounds();
         Point topPoint;
@@ -297,13 +407,24 @@ namespace OHOS::uitest {
                 topPoint.px_ = gestureZone;
             }
         }
+        // shorten the swipe around its center
+        auto &swipeFrom = vertical ? topPoint.py_ : topPoint.px_;
+        auto &swipeTo = vertical ? bottomPoint.py_ : bottomPoint.px_;
+        const auto shorten = (swipeTo - swipeFrom - distance) / TWO;
+        if (distance > 0 && shorten > 0) {
+            swipeFrom += shorten;
+            swipeTo -= shorten;
+        }
         topPoint.displayId_ = widget_.GetDisplayId();
         bottomPoint.displayId_ = widget_.GetDisplayId();
-        auto touch = (toTop) ? GenericSwipe(TouchOp::SWIPE, topPoint, bottomPoint)
-                             : GenericSwipe(TouchOp::SWIPE, bottomPoint, topPoint);
-        driver_.PerformTouch(touch, options_, error);
-        static constexpr auto sliceMs = 500;
-        this_thread::sleep_for(chrono::milliseconds(sliceMs));
+        auto touch = (toTop) ? GenericSwipe(op, topPoint, bottomPoint) : GenericSwipe(op, bottomPoint, topPoint);
+        if (op == TouchOp::FLING) {
+            auto flingOptions = options_;
+            flingOptions.swipeVelocityPps_ = options_.maxSwipeVelocityPps_;
+            driver_.PerformTouch(touch, flingOptions, error);
+        } else {
+            driver_.PerformTouch(touch, options_, error);
+        }
         oriDistance = (vertical) ? std::abs(topPoint.py_ - bottomPoint.py_) : std::abs(topPoint.px_ - bottomPoint.px_);
         if (vertical && toTop) {
             LOG_I("turn page vertical from %{public}d to %{public}d", topPoint.py_, bottomPoint.py_);
@@ -19,6 +19,9 @@
 #include "ui_driver.h"
 
 namespace OHOS::uitest {
+    struct ScrollFingerprint;
+    class ScrollEngine;
+
     class WidgetOperator {
     public:
         WidgetOperator(UiDriver &driver, const Widget &widget, const UiOpArgs &options);
@@ -45,7 +48,17 @@ namespace OHOS::uitest {
         bool CheckDeadZone(bool vertical, ApiCallErr &error);
 
     private:
-        void TurnPage(bool toTop, int &oriDistance, bool vertical, ApiCallErr &error) const;
+        /**Swipe on the widget to turn a page, the swipe is shortened to the given distance if it is positive.
+         * A fling is performed at the max velocity.*/
+        void TurnPage(bool toTop, int32_t distance, int &oriDistance, bool vertical, ApiCallErr &error,
+            TouchOp op = TouchOp::SWIPE) const;
+        /**Fling until no scroll follows, nothing is done if the scroll events are not tracked. The end is left to
+         * be confirmed by turning pages.*/
+        void FlingToEnd(bool toTop, ApiCallErr &error) const;
+        /**Fingerprint the contents of the widget and find the target in the same UI snapshot.*/
+        std::unique_ptr<Widget> ScanScrollPage(const WidgetSelector &contents, const WidgetSelector *target,
+            bool vertical, ScrollFingerprint &page, ApiCallErr &error) const;
+        void TurnPage(bool toTop, bool vertical, ScrollEngine &engine, ApiCallErr &error) const;
         UiDriver &driver_;
         const Widget &widget_;
         const UiOpArgs &options_;
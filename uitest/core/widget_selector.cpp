@@ -24,16 +24,17 @@ namespace OHOS::uitest {
 
     WidgetSelector::WidgetSelector(bool addVisibleMatcher)
     {
-        if (!addVisibleMatcher) {
-            return;
+        if (addVisibleMatcher) {
+            auto visibleMatcher = WidgetMatchModel(UiAttr::VISIBLE, "true", EQ);
+            selfMatchers_.emplace_back(visibleMatcher);
         }
-        auto visibleMatcher = WidgetMatchModel(UiAttr::VISIBLE, "true", EQ);
-        selfMatchers_.emplace_back(visibleMatcher);
+        CompilePlan();
     }
 
     void WidgetSelector::AddMatcher(const WidgetMatchModel &matcher)
     {
         selfMatchers_.emplace_back(matcher);
+        CompilePlan();
     }
 
     void WidgetSelector::AddFrontLocator(const WidgetSelector &selector, ApiCallErr &error)
@@ -43,6 +44,7 @@ namespace OHOS::uitest {
             return;
         }
         frontLocators_.emplace_back(selector);
+        CompilePlan();
     }
 
     void WidgetSelector::AddRearLocator(const WidgetSelector &selector, ApiCallErr &error)
@@ -52,6 +54,7 @@ namespace OHOS::uitest {
             return;
         }
         rearLocators_.emplace_back(selector);
+        CompilePlan();
     }
 
     void WidgetSelector::AddParentLocator(const WidgetSelector &selector, ApiCallErr &error)
@@ -61,6 +64,7 @@ namespace OHOS::uitest {
             return;
         }
         parentLocators_.emplace_back(selector);
+        CompilePlan();
     }
 
     void WidgetSelector::AddAppLocator(string app)
@@ -117,6 +121,7 @@ namespace OHOS::uitest {
     void WidgetSelector::SetWantMulti(bool wantMulti)
     {
         wantMulti_ = wantMulti;
+        CompilePlan();
     }
 
     bool WidgetSelector::IsWantMulti() const
@@ -129,18 +134,35 @@ namespace OHOS::uitest {
                                 std::vector<Widget> &visitWidgets,
                                 std::vector<int> &targetWidgets) const
     {
-        std::unique_ptr<SelectStrategy> visitStrategy = ConstructSelectStrategy();
+        std::unique_ptr<SelectStrategy> visitStrategy = SelectStrategy::BuildPlanStrategy(plan_);
         LOG_D("Do Select, select strategy is %{public}d", visitStrategy->GetStrategyType());
         DumpOption option;
         visitStrategy->LocateNode(window, elementNodeRef, visitWidgets, targetWidgets, option);
     }
 
+    void WidgetSelector::SelectBatch(const std::vector<const WidgetSelector *> &selectors,
+                                     const Window &window,
+                                     ElementNodeIterator &elementNodeRef,
+                                     std::vector<Widget> &visitWidgets,
+                                     std::vector<std::vector<int>> &targetWidgets)
+    {
+        std::vector<std::shared_ptr<const SelectPlan>> plans;
+        for (const auto selector : selectors) {
+            plans.emplace_back(selector->plan_);
+        }
+        std::unique_ptr<SelectStrategy> visitStrategy = SelectStrategy::BuildPlanStrategy(move(plans));
+        LOG_D("Do batch select by %{public}zu selectors", selectors.size());
+        DumpOption option;
+        targetWidgets.resize(selectors.size());
+        visitStrategy->LocateNodes(window, elementNodeRef, visitWidgets, targetWidgets, option);
+    }
+
     std::vector<WidgetMatchModel> WidgetSelector::GetSelfMatchers() const
     {
         return selfMatchers_;
     }
 
-    std::unique_ptr<SelectStrategy> WidgetSelector::ConstructSelectStrategy() const
+    void WidgetSelector::CompilePlan()
     {
         StrategyBuildParam buildParam;
         buildParam.myselfMatcher = selfMatchers_;
@@ -159,6 +181,6 @@ namespace OHOS::uitest {
                 buildParam.withInAnchorMatcherVec.emplace_back(withInLocator.GetSelfMatchers());
             }
         }
-        return SelectStrategy::BuildSelectStrategy(buildParam, wantMulti_);
+        plan_ = SelectStrategy::CompilePlan(buildParam, wantMulti_);
     }
 } // namespace OHOS::uitest
\ No newline at end of file
@@ -66,10 +66,17 @@ namespace OHOS::uitest {
                     std::vector<Widget> &visitWidgets,
                     std::vector<int> &targetWidgets) const;
 
+        /**Select by all the selectors in one traversal, the targets of selectors[i] are put in targetWidgets[i].*/
+        static void SelectBatch(const std::vector<const WidgetSelector *> &selectors,
+                                const Window &window,
+                                ElementNodeIterator &elementNodeRef,
+                                std::vector<Widget> &visitWidgets,
+                                std::vector<std::vector<int>> &targetWidgets);
+
         std::vector<WidgetMatchModel> GetSelfMatchers() const;
 
     private:
-        std::unique_ptr<SelectStrategy> ConstructSelectStrategy() const;
+        void CompilePlan();
         std::vector<WidgetMatchModel> selfMatchers_;
         std::vector<WidgetSelector> frontLocators_;
         std::vector<WidgetSelector> rearLocators_;
@@ -77,6 +84,8 @@ namespace OHOS::uitest {
         string appLocator_ = "";
         bool wantMulti_ = false;
         int32_t displayLocator_ = -1;
+        // recompiled when the selector changes, shared by the copies of this selector
+        std::shared_ptr<const SelectPlan> plan_;
     };
 } // namespace OHOS::uitest
 
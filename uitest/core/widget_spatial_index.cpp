@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "widget_spatial_index.h"
+
+namespace OHOS::uitest {
+    using namespace std;
+
+    void WidgetSpatialIndex::Add(const Widget &widget, int32_t layer)
+    {
+        Entry entry;
+        entry.bounds_ = widget.GetBounds();
+        entry.layer_ = layer;
+        entry.depth_ = widget.GetDepth();
+        entry.order_ = widgets_.size();
+        entries_.emplace_back(entry);
+        widgets_.emplace_back(widget);
+    }
+
+    size_t WidgetSpatialIndex::GetCell(int32_t coordinate, int32_t origin, int32_t cellSize) const
+    {
+        const auto cell = static_cast<int64_t>(coordinate - origin) / cellSize;
+        return static_cast<size_t>(clamp<int64_t>(cell, 0, static_cast<int64_t>(gridSize_) - 1));
+    }
+
+    void WidgetSpatialIndex::Build()
+    {
+        cellStarts_.clear();
+        cellEntries_.clear();
+        gridSize_ = 0;
+        if (entries_.empty()) {
+            return;
+        }
+        // the top-most entry comes first in every cell, so a lookup stops at the first hit
+        sort(entries_.begin(), entries_.end(), [](const Entry &a, const Entry &b) {
+            if (a.layer_ != b.layer_) {
+                return a.layer_ > b.layer_;
+            }
+            if (a.depth_ != b.depth_) {
+                return a.depth_ > b.depth_;
+            }
+            return a.order_ > b.order_;
+        });
+        extent_ = entries_.front().bounds_;
+        for (const auto &entry : entries_) {
+            extent_.left_ = min(extent_.left_, entry.bounds_.left_);
+            extent_.right_ = max(extent_.right_, entry.bounds_.right_);
+            extent_.top_ = min(extent_.top_, entry.bounds_.top_);
+            extent_.bottom_ = max(extent_.bottom_, entry.bounds_.bottom_);
+        }
+        // about one widget per cell on a side for small trees, the large containers are listed in every cell
+        const auto side = static_cast<size_t>(sqrt(static_cast<double>(entries_.size())));
+        gridSize_ = clamp<size_t>(side, 1, MAX_GRID_SIZE);
+        const auto gridSize = static_cast<int64_t>(gridSize_);
+        // the edges are inclusive, so the extent spans one more than its width and height
+        cellWidth_ = static_cast<int32_t>((static_cast<int64_t>(extent_.GetWidth()) + gridSize) / gridSize);
+        cellHeight_ = static_cast<int32_t>((static_cast<int64_t>(extent_.GetHeight()) + gridSize) / gridSize);
+        cellStarts_.assign(gridSize_ * gridSize_ + 1, 0);
+        for (const auto &entry : entries_) {
+            const auto &bounds = entry.bounds_;
+            for (auto row = GetCell(bounds.top_, extent_.top_, cellHeight_);
+                row <= GetCell(bounds.bottom_, extent_.top_, cellHeight_); row++) {
+                for (auto column = GetCell(bounds.left_, extent_.left_, cellWidth_);
+                    column <= GetCell(bounds.right_, extent_.left_, cellWidth_); column++) {
+                    cellStarts_[row * gridSize_ + column + 1]++;
+                }
+            }
+        }
+        for (size_t cell = 1; cell < cellStarts_.size(); cell++) {
+            cellStarts_[cell] += cellStarts_[cell - 1];
+        }
+        cellEntries_.resize(cellStarts_.back());
+        vector<size_t> filled(cellStarts_.begin(), cellStarts_.end() - 1);
+        for (size_t index = 0; index < entries_.size(); index++) {
+            const auto &bounds = entries_[index].bounds_;
+            for (auto row = GetCell(bounds.top_, extent_.top_, cellHeight_);
+                row <= GetCell(bounds.bottom_, extent_.top_, cellHeight_); row++) {
+                for (auto column = GetCell(bounds.left_, extent_.left_, cellWidth_);
+                    column <= GetCell(bounds.right_, extent_.left_, cellWidth_); column++) {
+                    cellEntries_[filled[row * gridSize_ + column]++] = static_cast<uint32_t>(index);
+                }
+            }
+        }
+    }
+
+    const Widget *WidgetSpatialIndex::Find(const Point &point) const
+    {
+        if (gridSize_ == 0 || point.px_ < extent_.left_ || point.px_ > extent_.right_ ||
+            point.py_ < extent_.top_ || point.py_ > extent_.bottom_) {
+            return nullptr;
+        }
+        const auto cell = GetCell(point.py_, extent_.top_, cellHeight_) * gridSize_ +
+            GetCell(point.px_, extent_.left_, cellWidth_);
+        for (auto index = cellStarts_[cell]; index < cellStarts_[cell + 1]; index++) {
+            const auto &entry = entries_[cellEntries_[index]];
+            const auto &bounds = entry.bounds_;
+            if (point.px_ >= bounds.left_ && point.px_ <= bounds.right_ &&
+                point.py_ >= bounds.top_ && point.py_ <= bounds.bottom_) {
+                return &widgets_[entry.order_];
+            }
+        }
+        return nullptr;
+    }
+} // namespace OHOS::uitest
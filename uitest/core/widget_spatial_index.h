@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef WIDGET_SPATIAL_INDEX_H
+#define WIDGET_SPATIAL_INDEX_H
+
+#include <vector>
+#include "ui_model.h"
+
+namespace OHOS::uitest {
+    /**Index of the visible widgets of one display by their bounds in a uniform grid, to find the widget at a point
+     * without walking all the widgets. Each cell lists the widgets overlapping it from the top-most one.*/
+    class WidgetSpatialIndex {
+    public:
+        static constexpr size_t MAX_GRID_SIZE = 32;
+
+        /**Add a visible widget, in DFS order within its window. layer is the z-order of its window, the higher one
+         * is on top.*/
+        void Add(const Widget &widget, int32_t layer);
+
+        /**Build the grid, call it after all the widgets are added.*/
+        void Build();
+
+        /**Find the top-most widget whose bounds contain the point, the edges included: the one in the top-most
+         * window, then the deepest one, then the later one in DFS order. Returns nullptr if none.*/
+        const Widget *Find(const Point &point) const;
+
+        size_t Size() const
+        {
+            return widgets_.size();
+        }
+
+    private:
+        struct Entry {
+            Rect bounds_{0, 0, 0, 0};
+            int32_t layer_ = 0;
+            int32_t depth_ = 0;
+            // position in DFS order, the index of the widget too
+            size_t order_ = 0;
+        };
+        size_t GetCell(int32_t coordinate, int32_t origin, int32_t cellSize) const;
+        std::vector<Widget> widgets_;
+        std::vector<Entry> entries_;
+        Rect extent_{0, 0, 0, 0};
+        size_t gridSize_ = 0;
+        int32_t cellWidth_ = 1;
+        int32_t cellHeight_ = 1;
+        // entries of cell i are cellEntries_[cellStarts_[i], cellStarts_[i + 1]), cells are in row-major order
+        std::vector<size_t> cellStarts_;
+        std::vector<uint32_t> cellEntries_;
+    };
+} // namespace OHOS::uitest
+
+#endif
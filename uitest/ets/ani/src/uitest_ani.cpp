@@ -148,6 +148,52 @@ static ani_ref UnmarshalObject(ani_env *env, nlohmann::json resultValue_)
     return result;
 }
 
+/**Unmarshal the array of component refs, the nested arrays are unmarshalled to arrays of components.*/
+static ani_ref UnmarshalComponents(ani_env *env, const nlohmann::json &refs)
+{
+    ani_class arrayCls = nullptr;
+    if (ANI_OK != env->FindClass(Builder::BuildClass({"std", "core", "Array"}).Descriptor().c_str(), &arrayCls)) {
+        HiLog::Error(LABEL, "%{public}s FindClass Array Failed", __func__);
+    }
+    arkts::ani_signature::SignatureBuilder array_ctor{};
+    array_ctor.AddInt();
+    ani_method arrayCtor = findCtorMethod(env, arrayCls, array_ctor.BuildSignatureDescriptor().c_str());
+    ani_object arrayObj;
+    ani_size com_size = refs.size();
+    if (ANI_OK != env->Object_New(arrayCls, arrayCtor, &arrayObj, com_size)) {
+        HiLog::Error(LABEL, "%{public}s Object New Array Failed", __func__);
+        return reinterpret_cast<ani_ref>(arrayObj);
+    }
+    ani_class cls = findCls(env, Builder::BuildClass({"@ohos", "UiTest", "Component"}).Descriptor().c_str());
+    ani_method com_ctor;
+    ani_object com_obj;
+    if (cls != nullptr) {
+        arkts::ani_signature::SignatureBuilder string_ctor{};
+        string_ctor.AddClass({"std", "core", "String"});
+        com_ctor = findCtorMethod(env, cls, string_ctor.BuildSignatureDescriptor().c_str());
+    }
+    if (cls == nullptr || com_ctor == nullptr) {
+        return nullptr;
+    }
+    for (ani_size index = 0; index < refs.size(); index++) {
+        const auto &ref = refs.at(index);
+        if (ref.type() == nlohmann::detail::value_t::array) {
+            com_obj = reinterpret_cast<ani_object>(UnmarshalComponents(env, ref));
+        } else {
+            ani_ref item = UnmarshalObject(env, ref);
+            if (ANI_OK != env->Object_New(cls, com_ctor, &com_obj, reinterpret_cast<ani_object>(item))) {
+                HiLog::Error(LABEL, "%{public}s component Object new failed !!!", __func__);
+            }
+        }
+        auto status = env->Object_CallMethodByName_Void(arrayObj, "$_set", "iY:", index, com_obj);
+        if (ANI_OK != status) {
+            HiLog::Error(LABEL, "%{public}s Object_CallMethodByName_Void set Failed", __func__);
+            break;
+        }
+    }
+    return reinterpret_cast<ani_ref>(arrayObj);
+}
+
 static ani_ref UnmarshalReply(ani_env *env, const ApiCallInfo callInfo_, const ApiReplyInfo &reply_)
 {
     if (callInfo_.fdParamIndex_ >= 0) {
@@ -175,46 +221,7 @@ static ani_ref UnmarshalReply(ani_env *env, const ApiCallInfo callInfo_, const A
     if (resultType == nlohmann::detail::value_t::null) {
         return nullptr;
     } else if (resultType == nlohmann::detail::value_t::array) {
-        ani_class arrayCls = nullptr;
-        if (ANI_OK != env->FindClass(Builder::BuildClass({"std", "core", "Array"}).Descriptor().c_str(), &arrayCls)) {
-            HiLog::Error(LABEL, "%{public}s FindClass Array Failed", __func__);
-        }
-        ani_ref undefinedRef = nullptr;
-        if (ANI_OK != env->GetUndefined(&undefinedRef)) {
-            HiLog::Error(LABEL, "%{public}s GetUndefined Failed", __func__);
-        }
-        arkts::ani_signature::SignatureBuilder array_ctor{};
-        array_ctor.AddInt();
-        ani_method arrayCtor = findCtorMethod(env, arrayCls, array_ctor.BuildSignatureDescriptor().c_str());
-        ani_object arrayObj;
-        ani_size com_size = reply_.resultValue_.size();
-        if (ANI_OK != env->Object_New(arrayCls, arrayCtor, &arrayObj, com_size)) {
-            HiLog::Error(LABEL, "%{public}s Object New Array Failed", __func__);
-            return reinterpret_cast<ani_ref>(arrayObj);
-        }
-        ani_class cls = findCls(env, Builder::BuildClass({"@ohos", "UiTest", "Component"}).Descriptor().c_str());
-        ani_method com_ctor;
-        ani_object com_obj;
-        if (cls != nullptr) {
-            arkts::ani_signature::SignatureBuilder string_ctor{};
-            string_ctor.AddClass({"std", "core", "String"});
-            com_ctor = findCtorMethod(env, cls, string_ctor.BuildSignatureDescriptor().c_str());
-        }
-        if (cls == nullptr || com_ctor == nullptr) {
-            return nullptr;
-        }
-        for (ani_size index = 0; index < reply_.resultValue_.size(); index++) {
-            ani_ref item = UnmarshalObject(env, reply_.resultValue_.at(index));
-            if (ANI_OK != env->Object_New(cls, com_ctor, &com_obj, reinterpret_cast<ani_object>(item))) {
-                HiLog::Error(LABEL, "%{public}s component Object new failed !!!", __func__);
-            }
-            auto status = env->Object_CallMethodByName_Void(arrayObj, "$_set", "iY:", index, com_obj);
-            if (ANI_OK != status) {
-                HiLog::Error(LABEL, "%{public}s Object_CallMethodByName_Void set Failed", __func__);
-                break;
-            }
-        }
-        return reinterpret_cast<ani_ref>(arrayObj);
+        return UnmarshalComponents(env, reply_.resultValue_);
     } else {
         return UnmarshalObject(env, reply_.resultValue_);
     }
@@ -755,14 +762,9 @@ static ani_boolean delayMsSync(ani_env *env, ani_object obj, ani_int t)
     return true;
 }
 
-static ani_ref findComponentSync(ani_env *env, ani_object obj, ani_object on_obj)
+/**Wrap the component ref replied by the call into a Component, or null if none is replied.*/
+static ani_ref NewComponent(ani_env *env, const ApiCallInfo &callInfo_, const ApiReplyInfo &reply_)
 {
-    ApiCallInfo callInfo_;
-    ApiReplyInfo reply_;
-    callInfo_.apiId_ = "Driver.findComponent";
-    callInfo_.callerObjRef_ = aniStringToStdString(env, unwrapp(env, obj, "nativeDriver"));
-    callInfo_.paramList_.push_back(aniStringToStdString(env, unwrapp(env, on_obj, "nativeOn")));
-    Transact(callInfo_, reply_);
     ani_ref nativeComponent = UnmarshalReply(env, callInfo_, reply_);
     if (nativeComponent == nullptr) {
         return nativeComponent;
@@ -784,6 +786,28 @@ static ani_ref findComponentSync(ani_env *env, ani_object obj, ani_object on_obj
     return com_obj;
 }
 
+static ani_ref findComponentSync(ani_env *env, ani_object obj, ani_object on_obj)
+{
+    ApiCallInfo callInfo_;
+    ApiReplyInfo reply_;
+    callInfo_.apiId_ = "Driver.findComponent";
+    callInfo_.callerObjRef_ = aniStringToStdString(env, unwrapp(env, obj, "nativeDriver"));
+    callInfo_.paramList_.push_back(aniStringToStdString(env, unwrapp(env, on_obj, "nativeOn")));
+    Transact(callInfo_, reply_);
+    return NewComponent(env, callInfo_, reply_);
+}
+
+static ani_ref findComponentAtSync(ani_env *env, ani_object obj, ani_object p)
+{
+    ApiCallInfo callInfo_;
+    ApiReplyInfo reply_;
+    callInfo_.apiId_ = "Driver.findComponentAt";
+    callInfo_.callerObjRef_ = aniStringToStdString(env, unwrapp(env, obj, "nativeDriver"));
+    callInfo_.paramList_.push_back(getPoint(env, p));
+    Transact(callInfo_, reply_);
+    return NewComponent(env, callInfo_, reply_);
+}
+
 static ani_object findComponentsSync(ani_env *env, ani_object obj, ani_object on_obj)
 {
     ApiCallInfo callInfo_;
@@ -796,6 +820,31 @@ static ani_object findComponentsSync(ani_env *env, ani_object obj, ani_object on
     return nativeComponents;
 }
 
+static ani_object findComponentsBatchSync(ani_env *env, ani_object obj, ani_object ons)
+{
+    ApiCallInfo callInfo_;
+    ApiReplyInfo reply_;
+    callInfo_.apiId_ = "Driver.findComponentsBatch";
+    callInfo_.callerObjRef_ = aniStringToStdString(env, unwrapp(env, obj, "nativeDriver"));
+    ani_int length = 0;
+    if (ANI_OK != env->Object_GetPropertyByName_Int(ons, "length", &length)) {
+        HiLog::Error(LABEL, "%{public}s Get Array length Failed", __func__);
+    }
+    auto onRefs = nlohmann::json::array();
+    for (ani_int index = 0; index < length; index++) {
+        ani_ref on_obj = nullptr;
+        if (ANI_OK != env->Object_CallMethodByName_Ref(ons, "$_get", "i:Y", &on_obj, index)) {
+            HiLog::Error(LABEL, "%{public}s Get Array element Failed", __func__);
+            break;
+        }
+        onRefs.push_back(aniStringToStdString(env, unwrapp(env, reinterpret_cast<ani_object>(on_obj), "nativeOn")));
+    }
+    callInfo_.paramList_.push_back(onRefs);
+    Transact(callInfo_, reply_);
+    ani_object nativeComponents = reinterpret_cast<ani_object>(UnmarshalReply(env, callInfo_, reply_));
+    return nativeComponents;
+}
+
 static ani_boolean assertComponentExistSync(ani_env *env, ani_object obj, ani_object on_obj)
 {
     ApiCallInfo callInfo_;
@@ -2157,7 +2206,9 @@ static ani_boolean BindDriver(ani_env *env)
         ani_native_function{"getDisplayDensitySync", nullptr, reinterpret_cast<void *>(getDisplayDensitySync)},
         ani_native_function{"getDisplayRotationSync", nullptr, reinterpret_cast<void *>(getDisplayRotationSync)},
         ani_native_function{"findComponentsSync", nullptr, reinterpret_cast<void *>(findComponentsSync)},
+        ani_native_function{"findComponentsBatchSync", nullptr, reinterpret_cast<void *>(findComponentsBatchSync)},
         ani_native_function{"findComponentSync", nullptr, reinterpret_cast<void *>(findComponentSync)},
+        ani_native_function{"findComponentAtSync", nullptr, reinterpret_cast<void *>(findComponentAtSync)},
         ani_native_function{"waitForIdleSync", nullptr, reinterpret_cast<void *>(waitForIdleSync)},
         ani_native_function{"waitForComponentSync", nullptr, reinterpret_cast<void *>(waitForComponentSync)},
         ani_native_function{"triggerCombineKeysSync", nullptr, reinterpret_cast<void *>(triggerCombineKeysSync)},
@@ -178,6 +178,15 @@ namespace OHOS::uitest {
             }
             return napi_ok;
         }
+        if (type == nlohmann::detail::value_t::array) { // nested array, the object refs in it are wrapped too
+            NAPI_CALL_BASE(env, napi_create_array_with_length(env, in.size(), pOut), NAPI_ERR);
+            for (size_t idx = 0; idx < in.size(); idx++) {
+                napi_value item = nullptr;
+                NAPI_CALL_BASE(env, UnmarshalObject(env, in.at(idx), &item, jsThis), NAPI_ERR);
+                NAPI_CALL_BASE(env, napi_set_element(env, *pOut, idx, item), NAPI_ERR);
+            }
+            return napi_ok;
+        }
         if (type != nlohmann::detail::value_t::string) { // non-string value, convert and return object
             NAPI_CALL_BASE(env, napi_create_string_utf8(env, in.dump().c_str(), NAPI_AUTO_LENGTH, pOut), NAPI_ERR);
             NAPI_CALL_BASE(env, ValueStringConvert(env, *pOut, pOut, false), NAPI_ERR);
@@ -375,6 +384,23 @@ namespace OHOS::uitest {
         ctx.callInfo_.fdParamIndex_ = INDEX_ZERO;
     }
 
+    /** Restore the js arrays marshalled as objects keyed by the element indexes, recursively.*/
+    static void RestoreIndexedArrays(nlohmann::json &value)
+    {
+        if (value.is_object() && value.contains("0")) {
+            auto array = nlohmann::json::array();
+            for (size_t idx = 0; value.contains(to_string(idx)); idx++) {
+                array.emplace_back(move(value[to_string(idx)]));
+            }
+            value = move(array);
+        }
+        if (value.is_object() || value.is_array()) {
+            for (auto &item : value) {
+                RestoreIndexedArrays(item);
+            }
+        }
+    }
+
     static void PreprocessTransaction(napi_env env, TransactionContext &ctx, napi_value &error)
     {
         auto &paramList = ctx.callInfo_.paramList_;
@@ -407,6 +433,26 @@ namespace OHOS::uitest {
                 paramList[1] = param0["1"];
                 paramList[TWO] = times;
             }
+        } else if (id == "Driver.findComponentsBatch" && !paramList.empty() && paramList.at(0).is_object()) {
+            // the js array of On is marshalled as an object keyed by the element indexes
+            const auto ons = paramList.at(0);
+            auto onArray = nlohmann::json::array();
+            for (size_t idx = 0; ons.contains(to_string(idx)); idx++) {
+                onArray.emplace_back(ons[to_string(idx)]);
+            }
+            paramList[0] = onArray;
+        } else if (id == "Driver.executeBatch" && !paramList.empty()) {
+            // the steps, the args of each step and the arrays in the args, an empty js array comes as {}
+            auto &steps = paramList[0];
+            RestoreIndexedArrays(steps);
+            if (steps.is_object() && steps.empty()) {
+                steps = nlohmann::json::array();
+            }
+            for (auto &step : steps) {
+                if (step.is_object() && step.contains("args") && step["args"].is_object()) {
+                    step["args"] = nlohmann::json::array();
+                }
+            }
         }
     }
 
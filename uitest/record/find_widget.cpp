@@ -19,30 +19,11 @@ namespace OHOS::uitest {
     std::vector<std::string> FindWidget(UiDriver &driver, float x, float y)
     {
         ApiCallErr err(NO_ERROR);
-        std::vector<std::unique_ptr<Widget>> rec;
-        WidgetSelector selector{};
-        selector.SetWantMulti(true);
-        driver.FindWidgets(selector, rec, err, true);
-        if (err.code_ != NO_ERROR) {
-            return {};
-        }
-        int maxDep = 0;
-        int maxIndex = -1;
-        for (size_t index = 0; index < rec.size(); index++) {
-            const auto &rect = rec[index]->GetBounds();
-            if (!(x <= rect.right_ && x >= rect.left_ && y <= rect.bottom_ && y >= rect.top_)) {
-                continue;
-            }
-            int curDep = rec[index]->GetHierarchy().length();
-            if (curDep > maxDep) {
-                maxDep = curDep;
-                maxIndex = index;
-            }
-        }
-        if (maxIndex > -1) {
-            return std::move(rec[maxIndex])->GetAttrVec();
-        } else {
+        // the touches on an unchanged UI are looked up in the spatial index of the same snapshot
+        auto widget = driver.FindWidgetAt(Point(static_cast<int32_t>(x), static_cast<int32_t>(y)), err);
+        if (err.code_ != NO_ERROR || widget == nullptr) {
             return {};
         }
+        return widget->GetAttrVec();
     }
-} // namespace OHOS::uitest
\ No newline at end of file
+} // namespace OHOS::uitest
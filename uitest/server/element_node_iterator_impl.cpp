@@ -17,13 +17,13 @@
 namespace OHOS::uitest {
     using namespace OHOS::Accessibility;
 
-    ElementNodeIteratorImpl::ElementNodeIteratorImpl(
-        const std::vector<AccessibilityElementInfo> &elements)
+    ElementNodeIteratorImpl::ElementNodeIteratorImpl(std::vector<AccessibilityElementInfo> elements)
     {
         elementInfoLists_ = std::move(elements);
         currentIndex_ = -1;
         topIndex_ = 0;
         lastCurrentIndex_ = -1;
+        BuildIndex();
     }
 
     ElementNodeIteratorImpl::ElementNodeIteratorImpl()
@@ -36,31 +36,27 @@ namespace OHOS::uitest {
     ElementNodeIteratorImpl::~ElementNodeIteratorImpl()
     {
         elementInfoLists_.clear();
-        elementToParentIndexMap_.clear();
-        elementIndexToHierarch_.clear();
-        visitAndVisibleIndexSet_.clear();
+        nodeHierarchies_.clear();
+    }
+
+    void ElementNodeIteratorImpl::BuildIndex()
+    {
+        nodeIndex_.Build(
+            elementInfoLists_.size(),
+            [this](size_t index) { return elementInfoLists_[index].GetAccessibilityId(); },
+            [this](size_t index) { return elementInfoLists_[index].GetChildCount(); },
+            [this](size_t index, int32_t slot) { return elementInfoLists_[index].GetChildId(slot); });
+        nodeHierarchies_.resize(elementInfoLists_.size());
     }
 
     bool ElementNodeIteratorImpl::DFSNextWithInTarget(Widget &widget)
     {
         if (currentIndex_ == topIndex_) {
-            int count = elementInfoLists_[currentIndex_].GetChildCount();
-            if (count <= 0) {
+            if (nodeIndex_.GetChildCount(currentIndex_) <= 0) {
                 return false;
             }
-            for (size_t i = currentIndex_ + 1; i < elementInfoLists_.size(); ++i) {
-                if (elementInfoLists_[i].GetAccessibilityId() != elementInfoLists_[currentIndex_].GetChildId(0)) {
-                    continue;
-                }
-                elementToParentIndexMap_.emplace(i, currentIndex_);
-                std::string parentHierarchy = elementIndexToHierarch_.at(currentIndex_);
-                currentIndex_ = i;
-                visitAndVisibleIndexSet_.insert(currentIndex_);
-                WrapperElement(widget);
-                widget.SetHierarchy(WidgetHierarchyBuilder::Build(parentHierarchy, 0));
-                elementIndexToHierarch_.emplace(currentIndex_, widget.GetHierarchy());
-                return true;
-            }
+            VisitNode(widget, nodeIndex_.GetFirstChild(currentIndex_), currentIndex_, 0);
+            return true;
         }
         return VisitNodeByChildAndBrother(widget);
     }
@@ -73,11 +69,11 @@ namespace OHOS::uitest {
 
         if (currentIndex_ == -1) {
             currentIndex_ = 0;
-            elementToParentIndexMap_.emplace(currentIndex_, -1);
-            visitAndVisibleIndexSet_.insert(currentIndex_);
+            nodeIndex_.MarkVisited(currentIndex_, ElementNodeIndex::NO_NODE);
             WrapperElement(widget);
+            widget.SetNodePosition(currentIndex_, ElementNodeIndex::NO_NODE, 0);
             widget.SetHierarchy(ROOT_HIERARCHY + to_string(windowId));
-            elementIndexToHierarch_.emplace(currentIndex_, widget.GetHierarchy());
+            nodeHierarchies_[currentIndex_] = widget.GetHierarchy();
             return true;
         }
         return VisitNodeByChildAndBrother(widget);
@@ -85,7 +81,7 @@ namespace OHOS::uitest {
 
     bool ElementNodeIteratorImpl::IsVisitFinish() const
     {
-        return elementInfoLists_.size() == elementToParentIndexMap_.size();
+        return elementInfoLists_.size() == nodeIndex_.GetVisitedCount();
     }
 
     void ElementNodeIteratorImpl::RestoreNodeIndexByAnchor()
@@ -102,16 +98,14 @@ namespace OHOS::uitest {
 
     void ElementNodeIteratorImpl::ClearDFSNext()
     {
-        elementToParentIndexMap_.clear();
-        elementIndexToHierarch_.clear();
-        visitAndVisibleIndexSet_.clear();
+        nodeIndex_.ClearVisit();
         currentIndex_ = -1;
         topIndex_ = 0;
     }
 
     void ElementNodeIteratorImpl::RemoveInvisibleWidget()
     {
-        visitAndVisibleIndexSet_.erase(currentIndex_);
+        nodeIndex_.MarkInvisible(currentIndex_);
     }
 
     std::string ElementNodeIteratorImpl::GenerateNodeHashCode(const AccessibilityElementInfo &element)
@@ -127,93 +121,74 @@ namespace OHOS::uitest {
 
     void ElementNodeIteratorImpl::WrapperElement(Widget &widget)
     {
-        AccessibilityElementInfo element = elementInfoLists_[currentIndex_];
+        const AccessibilityElementInfo &element = elementInfoLists_[currentIndex_];
+        widget.SetAttrPool(attrPool_);
         WrapperNodeAttrToVec(widget, element);
     }
 
+    void ElementNodeIteratorImpl::VisitNode(Widget &widget, int index, int parentIndex, int slot)
+    {
+        nodeIndex_.MarkVisited(index, parentIndex);
+        currentIndex_ = index;
+        WrapperElement(widget);
+        widget.SetNodePosition(index, parentIndex, nodeIndex_.GetVisitedDepth(index));
+        widget.SetHierarchy(WidgetHierarchyBuilder::Build(nodeHierarchies_[parentIndex], slot));
+        nodeHierarchies_[currentIndex_] = widget.GetHierarchy();
+    }
+
     bool ElementNodeIteratorImpl::VisitNodeByChildAndBrother(Widget &widget)
     {
-        int childCount = elementInfoLists_[currentIndex_].GetChildCount();
-        if (childCount > 0) {
-            if (VisitChildren(widget)) {
-                return true;
-            }
+        if (VisitChildren(widget)) {
+            return true;
         }
-
-        if (elementToParentIndexMap_.find(currentIndex_) == elementToParentIndexMap_.cend()) {
+        if (!nodeIndex_.IsVisited(currentIndex_)) {
             LOG_D("This node has no parent: %{public}s",
                   std::to_string(elementInfoLists_[currentIndex_].GetAccessibilityId()).data());
             return false;
         }
-        int parentIndex = elementToParentIndexMap_.at(currentIndex_);
+        int parentIndex = nodeIndex_.GetVisitedParent(currentIndex_);
         int tempChildIndex = currentIndex_;
-        if (elementToParentIndexMap_.find(topIndex_) == elementToParentIndexMap_.cend()) {
+        if (!nodeIndex_.IsVisited(topIndex_)) {
             LOG_D("This topIndex_ has no parent: %{public}d", topIndex_);
             return false;
         }
-        while (parentIndex != elementToParentIndexMap_.at(topIndex_)) {
+        const int topParentIndex = nodeIndex_.GetVisitedParent(topIndex_);
+        while (parentIndex != topParentIndex) {
             if (VisitBrother(widget, parentIndex, tempChildIndex)) {
                 return true;
             }
-            if (elementToParentIndexMap_.find(parentIndex) == elementToParentIndexMap_.cend()) {
-                LOG_D("This node has no parent: %{public}s",
-                      std::to_string(elementInfoLists_[parentIndex].GetAccessibilityId()).data());
+            if (!nodeIndex_.IsVisited(parentIndex)) {
+                LOG_D("This node has no parent: %{public}d", parentIndex);
                 return false;
             }
             tempChildIndex = parentIndex;
-            parentIndex = elementToParentIndexMap_.at(parentIndex);
+            parentIndex = nodeIndex_.GetVisitedParent(parentIndex);
         }
         return false;
     }
 
     bool ElementNodeIteratorImpl::VisitChildren(Widget& widget)
     {
-        if (visitAndVisibleIndexSet_.find(currentIndex_) == visitAndVisibleIndexSet_.cend()) {
+        if (nodeIndex_.GetChildCount(currentIndex_) <= 0) {
+            return false;
+        }
+        if (!nodeIndex_.IsVisitedAndVisible(currentIndex_)) {
             LOG_D("node %{public}s is invisible not find its children",
                   std::to_string(elementInfoLists_[currentIndex_].GetAccessibilityId()).data());
             return false;
-        } else {
-            for (size_t i = currentIndex_ + 1; i < elementInfoLists_.size(); ++i) {
-                if (elementInfoLists_[i].GetAccessibilityId() != elementInfoLists_[currentIndex_].GetChildId(0)) {
-                    continue;
-                }
-                elementToParentIndexMap_.emplace(i, currentIndex_);
-                std::string parentHierarchy = elementIndexToHierarch_.at(currentIndex_);
-                currentIndex_ = i;
-                visitAndVisibleIndexSet_.insert(currentIndex_);
-                WrapperElement(widget);
-                widget.SetHierarchy(WidgetHierarchyBuilder::Build(parentHierarchy, 0));
-                elementIndexToHierarch_.emplace(currentIndex_, widget.GetHierarchy());
-                return true;
-            }
-            return false;
         }
+        VisitNode(widget, nodeIndex_.GetFirstChild(currentIndex_), currentIndex_, 0);
+        return true;
     }
 
     bool ElementNodeIteratorImpl::VisitBrother(Widget &widget, int parentIndex, int tempChildIndex)
     {
-        AccessibilityElementInfo &parentModel = elementInfoLists_[parentIndex];
-        int parentChildCount = parentModel.GetChildCount();
-        for (int i = 0; i < parentChildCount; ++i) {
-            if ((parentModel.GetChildId(i) == elementInfoLists_[tempChildIndex].GetAccessibilityId()) &&
-                (i < parentChildCount - 1)) {
-                if (parentModel.GetChildId(i + 1) == elementInfoLists_[tempChildIndex + 1].GetAccessibilityId()) {
-                    elementToParentIndexMap_.emplace(tempChildIndex + 1, parentIndex);
-                    std::string parentHierarchy = elementIndexToHierarch_.at(parentIndex);
-                    currentIndex_ = tempChildIndex + 1;
-                    visitAndVisibleIndexSet_.insert(currentIndex_);
-                    WrapperElement(widget);
-                    widget.SetHierarchy(WidgetHierarchyBuilder::Build(parentHierarchy, i + 1));
-                    elementIndexToHierarch_.emplace(currentIndex_, widget.GetHierarchy());
-                    return true;
-                } else {
-                    LOG_E("Node error, except: %{public}s, actual is %{public}s",
-                          std::to_string(parentModel.GetChildId(i + 1)).data(),
-                          std::to_string(elementInfoLists_[tempChildIndex + 1].GetAccessibilityId()).data());
-                }
-            }
+        const auto slot = nodeIndex_.GetChildSlot(parentIndex, tempChildIndex);
+        if (slot == ElementNodeIndex::NO_NODE || slot + 1 >= nodeIndex_.GetChildCount(parentIndex)) {
+            return false;
         }
-        return false;
+        VisitNode(widget, tempChildIndex + 1, parentIndex, slot + 1);
+        return true;
     }
 
     void ElementNodeIteratorImpl::WrapperNodeAttrToVec(Widget &widget, const AccessibilityElementInfo &element)
@@ -223,11 +198,11 @@ namespace OHOS::uitest {
                          nodeOriginRect.GetLeftTopYScreenPostion(), nodeOriginRect.GetRightBottomYScreenPostion()};
         widget.SetBounds(visibleRect);
         widget.SetOrigBounds(visibleRect);
-        widget.SetAttr(UiAttr::ACCESSIBILITY_ID, std::to_string(element.GetAccessibilityId()));
+        widget.SetIntAttr(UiAttr::ACCESSIBILITY_ID, element.GetAccessibilityId());
         widget.SetAttr(UiAttr::ID, element.GetInspectorKey());
         widget.SetAttr(UiAttr::TEXT, element.GetContent());
         widget.SetAttr(UiAttr::ORIGINALTEXT, element.GetOriginalText());
-        widget.SetAttr(UiAttr::UNIQUEID, std::to_string(element.GetUniqueId()));
+        widget.SetIntAttr(UiAttr::UNIQUEID, element.GetUniqueId());
         widget.SetAttr(UiAttr::KEY, element.GetInspectorKey());
         widget.SetAttr(UiAttr::TYPE, element.GetComponentType());
         widget.SetAttr(UiAttr::DESCRIPTION, element.GetDescriptionInfo());
@@ -242,8 +217,8 @@ namespace OHOS::uitest {
         widget.SetAttr(UiAttr::SCROLLABLE, element.IsScrollable() ? "true" : "false");
         widget.SetAttr(UiAttr::CHECKABLE, element.IsCheckable() ? "true" : "false");
         widget.SetAttr(UiAttr::CHECKED, element.IsChecked() ? "true" : "false");
-        widget.SetAttr(UiAttr::HOST_WINDOW_ID, std::to_string(element.GetWindowId()));
-        widget.SetAttr(UiAttr::ZINDEX, std::to_string(element.GetZIndex()));
+        widget.SetIntAttr(UiAttr::HOST_WINDOW_ID, element.GetWindowId());
+        widget.SetIntAttr(UiAttr::ZINDEX, element.GetZIndex());
         widget.SetAttr(UiAttr::OPACITY, std::to_string(element.GetOpacity()));
         widget.SetAttr(UiAttr::BACKGROUNDCOLOR, element.GetBackgroundColor());
         widget.SetAttr(UiAttr::BACKGROUNDIMAGE, element.GetBackgroundImage());
@@ -24,7 +24,7 @@
 namespace OHOS::uitest {
     class ElementNodeIteratorImpl : public ElementNodeIterator {
     public:
-        explicit ElementNodeIteratorImpl(const std::vector<OHOS::Accessibility::AccessibilityElementInfo> &elements);
+        explicit ElementNodeIteratorImpl(std::vector<OHOS::Accessibility::AccessibilityElementInfo> elements);
         ElementNodeIteratorImpl();
         ~ElementNodeIteratorImpl() override;
         bool DFSNextWithInTarget(Widget &widget) override;
@@ -41,6 +41,8 @@ namespace OHOS::uitest {
         void WrapperElement(Widget &widget) override;
 
     private:
+        void BuildIndex();
+        void VisitNode(Widget &widget, int index, int parentIndex, int slot);
         bool VisitNodeByChildAndBrother(Widget &widget);
         bool VisitChildren(Widget& widget);
         bool VisitBrother(Widget &widget, int parentIndex, int tempCurrentIndex);
@@ -35,6 +35,7 @@
 #include <vector>
 #include <cmath>
 #include <fcntl.h>
+#include <fstream>
 #include <cstdio>
 #include "ipc_transactor.h"
 #include "system_ui_controller.h"
@@ -68,6 +69,7 @@ namespace OHOS::uitest {
     "  -m <true/false>          whether merge windows, true means to merge, set it true when not use this option\n"
     "  -d <displayId>                                           specifies the locate screen of the target window\n"
     "  -e <attributeName>                                               extend by adding the specified attribute\n"
+    "  --diff <basePath>              save only the nodes changed from the layout saved at basePath, by hashcode\n"
     "start-daemon <token>                                                                 start the test process\n"
     "uiRecord                                                                            recording Ui Operations\n"
     "  record                                                           Write Ui event information into csv file\n"
@@ -102,6 +104,7 @@ namespace OHOS::uitest {
         {nullptr, required_argument, nullptr, 'w'},
         {nullptr, required_argument, nullptr, 'm'},
         {nullptr, required_argument, nullptr, 'e'},
+        {"diff", required_argument, nullptr, 'D'},
         {nullptr, 0, nullptr, 0}};
     /* *Print to the console of this shell process. */
     static inline void PrintToConsole(string_view message)
@@ -214,6 +217,32 @@ namespace OHOS::uitest {
         return EXIT_SUCCESS;
     }
 
+    /**Write the diff of the layout against the base layout file, only the changed nodes are written.*/
+    static void DumpLayoutDiff(UiDriver &driver, DumpOption &option, int32_t fd, ApiCallErr &err)
+    {
+        ifstream baseFile(option.diffBasePath_);
+        auto base = nlohmann::json::parse(baseFile, nullptr, false);
+        if (!baseFile.is_open() || base.is_discarded()) {
+            err = ApiCallErr(ERR_INVALID_INPUT, "Invalid base layout file:" + option.diffBasePath_);
+            return;
+        }
+        nlohmann::json layout;
+        driver.DumpUiHierarchy(layout, option, err);
+        if (err.code_ != NO_ERROR) {
+            return;
+        }
+        nlohmann::json diff;
+        DumpHandler::DiffLayout(base, layout, diff, err);
+        if (err.code_ != NO_ERROR) {
+            return;
+        }
+        auto diffStr = diff.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+        if (write(fd, diffStr.data(), diffStr.size()) != static_cast<ssize_t>(diffStr.size())) {
+            LOG_E("Write layout diff to file failed, errno: %{public}s", strerror(errno));
+        }
+        LOG_D("layout diff size = %{public}zu", diffStr.size());
+    }
+
     static void DumpLayoutImpl(DumpOption &option, bool initController, ApiCallErr &err)
     {
         int32_t fd = open(option.savePath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
@@ -231,18 +260,21 @@ namespace OHOS::uitest {
             UiDriver::RegisterController(move(controller));
         }
         auto driver = UiDriver();
-        auto data = nlohmann::json();
-        driver.DumpUiHierarchy(data, option, err);
+        if (!option.diffBasePath_.empty()) {
+            DumpLayoutDiff(driver, option, fd, err);
+        } else {
+            // the layout is written as the nodes are visited, not held in memory as a json tree and its string
+            JsonStreamWriter writer(fd);
+            driver.DumpUiHierarchy(writer, option, err);
+            if (err.code_ == NO_ERROR && !writer.Flush()) {
+                LOG_E("Write dumpStr to file failed");
+            }
+            LOG_D("dumpStr size = %{public}zu", writer.GetSize());
+        }
         if (err.code_ != NO_ERROR) {
             close(fd);
             return;
         }
-        string dumpStr = data.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
-        LOG_D("dumpStr size = %{public}zu", dumpStr.size());
-        ssize_t written = write(fd, dumpStr.c_str(), dumpStr.length());
-        if (written == -1 || static_cast<size_t>(written) != dumpStr.length()) {
-            LOG_E("Write dumpStr to file failed, errno: %{public}s", strerror(errno));
-        }
         if (fsync(fd) == -1) {
             LOG_E("fsync failed, errno: %{public}s", strerror(errno));
         }
@@ -301,6 +333,8 @@ namespace OHOS::uitest {
                 }
             }
         }
+        auto iter7 = params.find('D');
+        option.diffBasePath_ = (iter7 != params.end()) ? iter7->second : "";
         return true;
     }
 
@@ -311,7 +345,7 @@ namespace OHOS::uitest {
         auto savePath = "/data/local/tmp/layout_" + ts + ".json";
         option.savePath_ = savePath;
         map<char, string> params;
-        if (GetParam(argc, argv, "p:w:b:m:e:d:ia", HELP_MSG, params) == EXIT_FAILURE) {
+        if (GetParam(argc, argv, "p:w:b:m:e:d:D:ia", HELP_MSG, params) == EXIT_FAILURE) {
             return EXIT_FAILURE;
         }
         if (!ParseDumpOption(params, option)) {
@@ -338,6 +372,7 @@ namespace OHOS::uitest {
         cmd.SetParam("mergeWindow", option.notMergeWindow_);
         cmd.SetParam("displayId", to_string(option.displayId_));
         cmd.SetParam("extendedAttrs", string(option.extendedAttrs_));
+        cmd.SetParam("diffBasePath", string(option.diffBasePath_));
         ApiTransactor::SendBroadcastCommand(cmd, err);
         if (err.code_ == NO_ERROR) {
             PrintToConsole("DumpLayout saved to:" + option.savePath_);
@@ -402,6 +437,7 @@ namespace OHOS::uitest {
         option.notMergeWindow_ = cmd.GetBoolParam("mergeWindow", true);
         option.displayId_ = atoi(cmd.GetStringParam("displayId").c_str());
         option.extendedAttrs_ = cmd.GetStringParam("extendedAttrs");
+        option.diffBasePath_ = cmd.GetStringParam("diffBasePath");
         return option;
     }
 
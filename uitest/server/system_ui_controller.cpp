@@ -39,6 +39,8 @@
 #include "wm_common.h"
 #include "element_node_iterator_impl.h"
 #include "system_ui_controller.h"
+#include "ui_idle_detector.h"
+#include "ui_scroll_tracker.h"
 #include "test_server_client.h"
 #include "test_server_error_code.h"
 #include "parameters.h"
@@ -84,17 +86,32 @@ namespace OHOS::uitest {
 
         void WaitScrollCompelete();
 
+        uint64_t GetScrollEndCount(int32_t windowId);
+
+        bool WaitScrollEnd(int32_t windowId, uint64_t endCount, uint32_t startTimeoutMs);
+
         void RegisterUiEventListener(shared_ptr<UiEventListener> listerner);
 
+        uint64_t GetUiEventEpoch() const;
+
+        /**Block until an event moves the epoch away from the given one or timeout, returns whether it moved.*/
+        bool WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs);
+
+        void SetUiEventTracked(bool tracked);
+
     private:
         function<void()> onConnectCallback_ = nullptr;
         function<void()> onDisConnectCallback_ = nullptr;
-        atomic<uint64_t> lastEventMillis_ = 0;
-        atomic<uint64_t> lastScrollBeginEventMillis_ = 0;
-        atomic<bool> scrollCompelete_ = true;
+        UiIdleDetector idleDetector_;
+        UiScrollTracker scrollTracker_;
+        atomic<uint64_t> uiEventEpoch_ = 1;
+        atomic<bool> uiEventTracked_ = true;
         vector<shared_ptr<UiEventListener>> listeners_;
+        mutex eventMtx_;
+        condition_variable eventCond_;
         
         // Helper functions
+        void IncreaseUiEventEpoch();
         void NotifyListeners(const std::string& capturedEvent, const UiEventSourceInfo& uiEventSourceInfo,
             Widget* widget = nullptr);
     };
@@ -244,6 +261,7 @@ namespace OHOS::uitest {
 
     void UiEventMonitor::OnAbilityConnected()
     {
+        IncreaseUiEventEpoch();
         if (onConnectCallback_ != nullptr) {
             onConnectCallback_();
         }
@@ -251,6 +269,7 @@ namespace OHOS::uitest {
 
     void UiEventMonitor::OnAbilityDisconnected()
     {
+        IncreaseUiEventEpoch();
         if (onDisConnectCallback_ != nullptr) {
             onDisConnectCallback_();
         }
@@ -284,15 +303,16 @@ namespace OHOS::uitest {
     {
         auto eventType = eventInfo.GetEventType();
         LOG_D("OnEvent:0x%{public}x", eventType);
+        // any received event may come with ui changes, invalidate the ui snapshot
+        IncreaseUiEventEpoch();
         auto capturedEvent = GetWatchedEvent(eventInfo);
         if (eventType == Accessibility::EventType::TYPE_VIEW_SCROLLED_START) {
             LOG_I("Capture scroll begin");
-            scrollCompelete_.store(false);
-            lastScrollBeginEventMillis_.store(GetCurrentMillisecond());
+            scrollTracker_.OnScrollStart(GetCurrentMillisecond(), eventInfo.GetWindowId());
         }
         if (eventType == Accessibility::EventType::TYPE_VIEW_SCROLLED_EVENT) {
             LOG_I("Capture scroll end");
-            scrollCompelete_.store(true);
+            scrollTracker_.OnScrollEnd(GetCurrentMillisecond(), eventInfo.GetWindowId());
         }
         if (capturedEvent != "undefine") {
             LOG_D("testfwk Capture event: %{public}s", capturedEvent.c_str());
@@ -326,56 +346,73 @@ namespace OHOS::uitest {
             NotifyListeners(capturedEvent, uiEventSourceInfo, widget.get());
         }
         if (std::find(EVENT_MASK.begin(), EVENT_MASK.end(), eventInfo.GetEventType()) != EVENT_MASK.end()) {
-            lastEventMillis_.store(GetCurrentMillisecond());
+            idleDetector_.OnUiEvent(GetCurrentMillisecond());
         }
     }
 
-    uint64_t UiEventMonitor::GetLastEventMillis()
+    void UiEventMonitor::IncreaseUiEventEpoch()
     {
-        if (lastEventMillis_.load() <= 0) {
-            lastEventMillis_.store(GetCurrentMillisecond());
+        {
+            std::lock_guard<std::mutex> locker(eventMtx_);
+            uiEventEpoch_.fetch_add(1);
         }
-        return lastEventMillis_.load();
+        eventCond_.notify_all();
+    }
+
+    uint64_t UiEventMonitor::GetUiEventEpoch() const
+    {
+        return uiEventTracked_.load() ? uiEventEpoch_.load() : 0;
+    }
+
+    bool UiEventMonitor::WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs)
+    {
+        std::unique_lock<std::mutex> locker(eventMtx_);
+        return eventCond_.wait_for(locker, chrono::milliseconds(timeoutMs), [this, epoch]() {
+            return GetUiEventEpoch() != epoch;
+        });
+    }
+
+    void UiEventMonitor::SetUiEventTracked(bool tracked)
+    {
+        uiEventTracked_.store(tracked);
+        IncreaseUiEventEpoch();
+    }
+
+    uint64_t UiEventMonitor::GetLastEventMillis()
+    {
+        return idleDetector_.GetLastEventMillis();
     }
 
     void UiEventMonitor::WaitScrollCompelete()
     {
-        if (scrollCompelete_.load()) {
-            return;
-        }
-        auto currentMs = GetCurrentMillisecond();
-        if (lastScrollBeginEventMillis_.load() <= 0) {
-            lastScrollBeginEventMillis_.store(currentMs);
-        }
-        const auto idleThresholdMs = 10000;
-        static constexpr auto sliceMs = 10;
-        while (currentMs - lastScrollBeginEventMillis_.load() < idleThresholdMs) {
-            if (scrollCompelete_.load()) {
-                return;
-            }
-            this_thread::sleep_for(chrono::milliseconds(sliceMs));
-            currentMs = GetCurrentMillisecond();
-        }
-        LOG_E("wait for scrollEnd event timeout.");
-        scrollCompelete_.store(true);
-        return;
+        // the scroll end event may be followed by another scroll start shortly, as in a fling
+        static constexpr uint32_t scrollQuietMs = 20;
+        static constexpr uint32_t scrollTimeoutMs = 10000;
+        scrollTracker_.WaitScrollComplete(scrollTimeoutMs, scrollQuietMs);
+    }
+
+    uint64_t UiEventMonitor::GetScrollEndCount(int32_t windowId)
+    {
+        // the scroll ends may be missed while the events are not tracked
+        return uiEventTracked_.load() ? scrollTracker_.GetScrollEndCount(windowId) : 0;
+    }
+
+    bool UiEventMonitor::WaitScrollEnd(int32_t windowId, uint64_t endCount, uint32_t startTimeoutMs)
+    {
+        static constexpr uint32_t scrollTimeoutMs = 10000;
+        return scrollTracker_.WaitScrollEnd(windowId, endCount, startTimeoutMs, scrollTimeoutMs);
     }
 
     bool UiEventMonitor::WaitEventIdle(uint32_t idleThresholdMs, uint32_t timeoutMs)
     {
-        const auto currentMs = GetCurrentMillisecond();
-        if (lastEventMillis_.load() <= 0) {
-            lastEventMillis_.store(currentMs);
-        }
-        if (currentMs - lastEventMillis_.load() >= idleThresholdMs) {
-            return true;
-        }
-        static constexpr auto sliceMs = 10;
-        this_thread::sleep_for(chrono::milliseconds(sliceMs));
-        if (timeoutMs <= sliceMs) {
-            return false;
+        uint64_t idleLatencyMs = 0;
+        const auto idle = idleDetector_.WaitIdle(idleThresholdMs, timeoutMs, idleLatencyMs);
+        if (idle) {
+            LOG_D("Ui idle in %{public}ums, detected %{public}" PRIu64 "ms late", idleThresholdMs, idleLatencyMs);
+        } else {
+            LOG_W("Wait ui idle in %{public}ums timeout after %{public}ums", idleThresholdMs, timeoutMs);
         }
-        return WaitEventIdle(idleThresholdMs, timeoutMs - sliceMs);
+        return idle;
     }
 
     void UiEventMonitor::NotifyListeners(const std::string& capturedEvent,
@@ -481,11 +518,8 @@ namespace OHOS::uitest {
         }
     }
 
-    static void InflateWindowInfo(AccessibilityWindowInfo& node, Window& info, bool needAbilityInfo)
+    static void InflateWindowBundle(AccessibilityWindowInfo& node, Window& info, bool needAbilityInfo)
     {
-        info.focused_ = node.IsFocused();
-        info.actived_ = node.IsActive();
-        info.decoratorEnabled_ = node.IsDecorEnable();
         AccessibilityElementInfo element;
         LOG_D("Start Get Bundle Name by WindowId %{public}d", node.GetWindowId());
         if (AccessibilityUITestAbility::GetInstance()->GetRootByWindow(node, element) != RET_OK) {
@@ -496,6 +530,13 @@ namespace OHOS::uitest {
             info.bundleName_ = app;
             InflateAbilityInfo(info, app, element, needAbilityInfo);
         }
+    }
+
+    static void InflateWindowInfo(AccessibilityWindowInfo& node, Window& info)
+    {
+        info.focused_ = node.IsFocused();
+        info.actived_ = node.IsActive();
+        info.decoratorEnabled_ = node.IsDecorEnable();
         auto touchAreas = node.GetTouchHotAreas();
         for (auto area : touchAreas) {
             Rect rect { info.bounds_.left_ + area.GetLeftTopXScreenPostion(),
@@ -570,6 +611,45 @@ namespace OHOS::uitest {
         }
     }
 
+    bool SysUiController::GetWindowsInDisplay(int32_t displayId, vector<Window> &out, bool skipWaitForUiSteady,
+        bool needAbilityInfo) const
+    {
+        vector<AccessibilityWindowInfo> windows;
+        if (!GetAamsWindowInfos(windows, displayId, skipWaitForUiSteady)) {
+            return false;
+        }
+        auto screenSize = GetDisplaySize(displayId);
+        auto screenRect = Rect(0, screenSize.px_, 0, screenSize.py_);
+        std::vector<AccessibilityWindowInfo *> visibleWindows;
+        std::vector<Rect> overplays;
+        // window wrapper, the visible region of each window depends on the windows above it
+        for (auto &win : windows) {
+            Rect winRectInScreen = GetVisibleRect(screenRect, win);
+            Rect visibleArea = winRectInScreen;
+            if (!RectAlgorithm::ComputeMaxVisibleRegion(winRectInScreen, overplays, visibleArea)) {
+                LOG_I("window is covered, windowId : %{public}d, layer is %{public}d", win.GetWindowId(),
+                      win.GetWindowLayer());
+                continue;
+            }
+            LOG_I("window is visible, windowId: %{public}d, active: %{public}d, focus: %{public}d,"
+                "layer: %{public}d, displayId: %{public}" PRIu64 "",
+                win.GetWindowId(), win.IsActive(), win.IsFocused(), win.GetWindowLayer(), win.GetDisplayId());
+            Window winWrapper{win.GetWindowId()};
+            winWrapper.bounds_ = winRectInScreen;
+            InflateWindowInfo(win, winWrapper);
+            winWrapper.displayId_ = win.GetDisplayId();
+            UpdateWindowAttrs(winWrapper, overplays);
+            winWrapper.displayId_ = displayId;
+            out.emplace_back(move(winWrapper));
+            visibleWindows.emplace_back(&win);
+        }
+        // the bundle of each window is an independent query, run them concurrently
+        RunConcurrently(out.size(), MAX_FETCH_WORKERS, [&out, &visibleWindows, needAbilityInfo](size_t index) {
+            InflateWindowBundle(*visibleWindows[index], out[index], needAbilityInfo);
+        });
+        return true;
+    }
+
     void SysUiController::GetUiWindows(std::map<int32_t, vector<Window>> &out, int32_t targetDisplay,
         bool skipWaitForUiSteady, bool needAbilityInfo)
     {
@@ -581,58 +661,40 @@ namespace OHOS::uitest {
         }
         DisplayManager &dpm = DisplayManager::GetInstance();
         auto displayIds = dpm.GetAllDisplayIds();
+        vector<int32_t> targetDisplays;
         for (auto displayId : displayIds) {
             if ((targetDisplay != -1 && targetDisplay != static_cast<int32_t>(displayId)) ||
                 displayId == VIRTUAL_DISPLAY_ID) {
                 continue;
             }
-            if (!ConvertAAMS(displayId, error)) {
-                continue;
-            }
-            vector<AccessibilityWindowInfo> windows;
-            if (!GetAamsWindowInfos(windows, displayId, skipWaitForUiSteady)) {
-                continue;
-            }
-            auto screenSize = GetDisplaySize(displayId);
-            auto screenRect = Rect(0, screenSize.px_, 0, screenSize.py_);
-            std::vector<Window> winInfos;
-            std::vector<Rect> overplays;
-            // window wrapper
-            for (auto &win : windows) {
-                Rect winRectInScreen = GetVisibleRect(screenRect, win);
-                Rect visibleArea = winRectInScreen;
-                if (!RectAlgorithm::ComputeMaxVisibleRegion(winRectInScreen, overplays, visibleArea)) {
-                    LOG_I("window is covered, windowId : %{public}d, layer is %{public}d", win.GetWindowId(),
-                          win.GetWindowLayer());
-                    continue;
+            targetDisplays.emplace_back(displayId);
+        }
+        vector<vector<Window>> winInfos(targetDisplays.size());
+        vector<uint8_t> fetched(targetDisplays.size(), false);
+        auto fetchDisplay = [&](size_t index) {
+            fetched[index] = GetWindowsInDisplay(targetDisplays[index], winInfos[index], skipWaitForUiSteady,
+                needAbilityInfo);
+        };
+        if (isSingleUser_) {
+            RunConcurrently(targetDisplays.size(), MAX_FETCH_WORKERS, fetchDisplay);
+        } else {
+            // the connection serves one user at a time, the displays of different users must be fetched in turn
+            for (size_t index = 0; index < targetDisplays.size(); index++) {
+                if (ConvertAAMS(targetDisplays[index], error)) {
+                    fetchDisplay(index);
                 }
-                LOG_I("window is visible, windowId: %{public}d, active: %{public}d, focus: %{public}d,"
-                    "layer: %{public}d, displayId: %{public}" PRIu64 "",
-                    win.GetWindowId(), win.IsActive(), win.IsFocused(), win.GetWindowLayer(), win.GetDisplayId());
-                Window winWrapper{win.GetWindowId()};
-                winWrapper.bounds_ = winRectInScreen;
-                InflateWindowInfo(win, winWrapper, needAbilityInfo);
-                winWrapper.displayId_ = win.GetDisplayId();
-                UpdateWindowAttrs(winWrapper, overplays);
-                winWrapper.displayId_ = displayId;
-                winInfos.emplace_back(move(winWrapper));
             }
-            out.insert(make_pair(displayId, move(winInfos)));
+        }
+        for (size_t index = 0; index < targetDisplays.size(); index++) {
+            if (fetched[index]) {
+                out.insert(make_pair(targetDisplays[index], move(winInfos[index])));
+            }
         }
     }
 
-    bool SysUiController::GetWidgetsInWindow(const Window &winInfo, unique_ptr<ElementNodeIterator> &elementIterator,
-        AamsWorkMode mode)
+    bool SysUiController::FetchWindowNodes(const Window &winInfo, unique_ptr<ElementNodeIterator> &elementIterator,
+        AamsWorkMode mode) const
     {
-        std::lock_guard<std::mutex> dumpLocker(dumpMtx); // disallow concurrent dumpUi
-        ApiCallErr error = ApiCallErr(NO_ERROR);
-        if (!ConvertAAMS(winInfo.displayId_, error)) {
-            return false;
-        }
-        if (!connected_) {
-            LOG_W("Connect to AccessibilityUITestAbility failed");
-            return false;
-        }
         std::vector<AccessibilityElementInfo> elementInfos;
         AccessibilityWindowInfo window;
         LOG_D("Get Window by WindowId %{public}d", winInfo.id_);
@@ -655,11 +717,61 @@ namespace OHOS::uitest {
         } else {
             LOG_I("End Get nodes from window by WindowId %{public}d, node size is %{public}zu, appId: %{public}s",
                   winInfo.id_, elementInfos.size(), winInfo.bundleName_.data());
-            elementIterator = std::make_unique<ElementNodeIteratorImpl>(elementInfos);
+            elementIterator = std::make_unique<ElementNodeIteratorImpl>(std::move(elementInfos));
         }
         return true;
     }
 
+    bool SysUiController::GetWidgetsInWindow(const Window &winInfo, unique_ptr<ElementNodeIterator> &elementIterator,
+        AamsWorkMode mode)
+    {
+        std::lock_guard<std::mutex> dumpLocker(dumpMtx); // disallow concurrent dumpUi
+        ApiCallErr error = ApiCallErr(NO_ERROR);
+        if (!ConvertAAMS(winInfo.displayId_, error)) {
+            return false;
+        }
+        if (!connected_) {
+            LOG_W("Connect to AccessibilityUITestAbility failed");
+            return false;
+        }
+        return FetchWindowNodes(winInfo, elementIterator, mode);
+    }
+
+    void SysUiController::GetWidgetsInWindows(const vector<const Window *> &windows,
+        vector<unique_ptr<ElementNodeIterator>> &iterators, AamsWorkMode mode)
+    {
+        std::lock_guard<std::mutex> dumpLocker(dumpMtx); // disallow concurrent dumpUi
+        iterators.clear();
+        iterators.resize(windows.size());
+        // group the windows by display, the windows of one user are fetched concurrently after converting to it
+        vector<vector<size_t>> groups;
+        map<int32_t, size_t> displayToGroup;
+        for (size_t index = 0; index < windows.size(); index++) {
+            const auto groupKey = isSingleUser_ ? 0 : windows[index]->displayId_;
+            auto [iter, inserted] = displayToGroup.emplace(groupKey, groups.size());
+            if (inserted) {
+                groups.emplace_back();
+            }
+            groups[iter->second].emplace_back(index);
+        }
+        for (const auto &group : groups) {
+            ApiCallErr error = ApiCallErr(NO_ERROR);
+            if (!ConvertAAMS(windows[group.front()]->displayId_, error)) {
+                continue;
+            }
+            if (!connected_) {
+                LOG_W("Connect to AccessibilityUITestAbility failed");
+                continue;
+            }
+            RunConcurrently(group.size(), MAX_FETCH_WORKERS, [&](size_t index) {
+                const auto winIndex = group[index];
+                if (!FetchWindowNodes(*windows[winIndex], iterators[winIndex], mode)) {
+                    iterators[winIndex] = nullptr;
+                }
+            });
+        }
+    }
+
     int32_t SysUiController::GetValidDisplayId(int32_t id) const
     {
         if (id == UNASSIGNED) {
@@ -1214,6 +1326,38 @@ namespace OHOS::uitest {
         return g_monitorInstance_->WaitEventIdle(idleThresholdMs, timeoutMs);
     }
 
+    uint64_t SysUiController::GetUiEventEpoch() const
+    {
+        if (!connected_ || g_monitorInstance_ == nullptr) {
+            return 0;
+        }
+        return g_monitorInstance_->GetUiEventEpoch();
+    }
+
+    bool SysUiController::WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs) const
+    {
+        if (!connected_ || g_monitorInstance_ == nullptr) {
+            return UiController::WaitForUiEvent(epoch, timeoutMs);
+        }
+        return g_monitorInstance_->WaitForUiEvent(epoch, timeoutMs);
+    }
+
+    uint64_t SysUiController::GetScrollEndCount(int32_t windowId) const
+    {
+        if (!connected_ || g_monitorInstance_ == nullptr) {
+            return 0;
+        }
+        return g_monitorInstance_->GetScrollEndCount(windowId);
+    }
+
+    bool SysUiController::WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const
+    {
+        if (!connected_ || g_monitorInstance_ == nullptr) {
+            return UiController::WaitForScrollEnd(windowId, count, timeoutMs);
+        }
+        return g_monitorInstance_->WaitScrollEnd(windowId, count, timeoutMs);
+    }
+
     void SysUiController::DisConnectFromSysAbility()
     {
         if (!connected_ || g_monitorInstance_ == nullptr) {
@@ -1379,11 +1523,18 @@ namespace OHOS::uitest {
     void SysUiController::CloseAamsEvent() const
     {
         AccessibilityUITestAbility::GetInstance()->ConfigureEvents({ Accessibility::EventType::TYPE_VIEW_INVALID });
+        // ui changes can not be observed without events
+        if (g_monitorInstance_ != nullptr) {
+            g_monitorInstance_->SetUiEventTracked(false);
+        }
     }
 
     void SysUiController::OpenAamsEvent() const
     {
         AccessibilityUITestAbility::GetInstance()->ConfigureEvents(EVENT_MASK);
+        if (g_monitorInstance_ != nullptr) {
+            g_monitorInstance_->SetUiEventTracked(true);
+        }
     }
 
     class OnSaLoadCallback : public SystemAbilityLoadCallbackStub {
@@ -1432,9 +1583,12 @@ namespace OHOS::uitest {
     {
 #ifdef HIDUMPER_ENABLED
         auto sam = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
-        // wati SA start
-        constexpr auto delayMs = 2000;
-        this_thread::sleep_for(chrono::milliseconds(delayMs));
+        // wait SA start once, the concurrent fetches of the other windows wait for the same delay
+        static once_flag waitSaStart;
+        call_once(waitSaStart, []() {
+            constexpr auto delayMs = 2000;
+            this_thread::sleep_for(chrono::milliseconds(delayMs));
+        });
         if (sam == nullptr) {
             LOG_E("Get samgr failed");
             return;
@@ -34,8 +34,19 @@ namespace OHOS::uitest {
         bool GetWidgetsInWindow(const Window &winInfo, unique_ptr<ElementNodeIterator> &elementIterator,
             AamsWorkMode mode) override;
 
+        void GetWidgetsInWindows(const vector<const Window *> &windows,
+            vector<unique_ptr<ElementNodeIterator>> &iterators, AamsWorkMode mode) override;
+
         bool WaitForUiSteady(uint32_t idleThresholdMs, uint32_t timeoutMs) const override;
 
+        uint64_t GetUiEventEpoch() const override;
+
+        bool WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs) const override;
+
+        uint64_t GetScrollEndCount(int32_t windowId) const override;
+
+        bool WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const override;
+
         void InjectTouchEventSequence(const PointerMatrix &events) const override;
 
         void InjectMouseEventSequence(const vector<MouseEvent> &events) const override;
@@ -110,6 +121,12 @@ namespace OHOS::uitest {
         mutable std::vector<int32_t> downKeys_;
         int32_t currentUser_ = -1;
         bool ConvertAAMS(int32_t displayId, ApiCallErr &error);
+        /**Fetch the visible windows of the display, the caller must hold dumpMtx and have converted to its user.*/
+        bool GetWindowsInDisplay(int32_t displayId, vector<Window> &out, bool skipWaitForUiSteady,
+            bool needAbilityInfo) const;
+        /**Fetch the nodes of the window, the caller must hold dumpMtx and have converted to its user.*/
+        bool FetchWindowNodes(const Window &winInfo, unique_ptr<ElementNodeIterator> &elementIterator,
+            AamsWorkMode mode) const;
         bool isSingleUser_ = true;
     };
 }
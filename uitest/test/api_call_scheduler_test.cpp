@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <thread>
+#include "gtest/gtest.h"
+#include "api_call_scheduler.h"
+#include "frontend_api_handler.h"
+#include "frontend_api_tables.h"
+#include "mock_element_node_iterator.h"
+#include "mock_controller.h"
+#include "ui_driver.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+using namespace nlohmann;
+
+static constexpr uint32_t WAIT_TIMEOUT_MS = 5000;
+
+/**Wait until the condition holds, returns false on timeout.*/
+static bool WaitUntil(const function<bool()> &condition)
+{
+    const auto start = GetCurrentMillisecond();
+    while (!condition()) {
+        if (GetCurrentMillisecond() - start > WAIT_TIMEOUT_MS) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+TEST(ApiCallSchedulerTest, classifyApis)
+{
+    ASSERT_EQ(API_READ_PURE, GetApiAccess("On.text"));
+    ASSERT_EQ(API_READ_PURE, GetApiAccess("By.isAfter"));
+    ASSERT_EQ(API_READ_PURE, GetApiAccess("Driver.delayMs"));
+    ASSERT_EQ(API_READ_WIDGET, GetApiAccess("Component.getText"));
+    ASSERT_EQ(API_READ_WIDGET, GetApiAccess("Component.isEnabled"));
+    ASSERT_EQ(API_READ_WIDGET, GetApiAccess("Component.getAllProperties"));
+    ASSERT_EQ(API_READ_WIDGET, GetApiAccess("UiComponent.isEnabled"));
+    ASSERT_EQ(API_READ_SNAPSHOT, GetApiAccess("Driver.findComponents"));
+    ASSERT_EQ(API_READ_SNAPSHOT, GetApiAccess("Driver.waitForComponent"));
+    ASSERT_EQ(API_READ_SNAPSHOT, GetApiAccess("Driver.dumpLayout"));
+    ASSERT_EQ(API_READ_SNAPSHOT, GetApiAccess("UiWindow.getBundleName"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("Driver.click"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("Component.inputText"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("Driver.isComponentPresentWhenLongClick"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("UiWindow.resize"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("Driver.create"));
+    ASSERT_EQ(API_MUTATING, GetApiAccess("BackendObjectsCleaner"));
+}
+
+TEST(ApiCallSchedulerTest, readsRunAlongWithEachOther)
+{
+    static constexpr size_t readerCount = 8;
+    ApiCallScheduler scheduler;
+    atomic<size_t> running = 0;
+    atomic<size_t> met = 0;
+    vector<thread> readers;
+    for (size_t index = 0; index < readerCount; index++) {
+        readers.emplace_back([&scheduler, &running, &met]() {
+            ApiCallTurn turn(scheduler, API_READ_PURE);
+            running++;
+            // all the readers are running at the same time
+            if (WaitUntil([&running]() { return running == readerCount; })) {
+                met++;
+            }
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(readerCount, met);
+    ASSERT_EQ(0, scheduler.GetQueuedCount());
+}
+
+TEST(ApiCallSchedulerTest, writesRunAloneInOrder)
+{
+    ApiCallScheduler scheduler;
+    mutex orderMutex;
+    vector<string> order;
+    atomic<int32_t> running = 0;
+    atomic<bool> overlapped = false;
+    auto runCall = [&](string name, ApiAccess access) {
+        ApiCallTurn turn(scheduler, access);
+        const auto others = running++;
+        overlapped = overlapped || (access == API_MUTATING && others > 0);
+        {
+            lock_guard<mutex> guard(orderMutex);
+            order.emplace_back(name);
+        }
+        this_thread::sleep_for(chrono::milliseconds(INDEX_TEN));
+        running--;
+    };
+    // the calls arrive while a read is running, and queue in the order of arrival
+    auto firstRead = make_unique<ApiCallTurn>(scheduler, API_READ_PURE);
+    vector<thread> callers;
+    const vector<pair<string, ApiAccess>> calls = {{"write0", API_MUTATING}, {"read1", API_READ_SNAPSHOT},
+        {"read2", API_READ_PURE}, {"write3", API_MUTATING}, {"write4", API_MUTATING}, {"read5", API_READ_PURE}};
+    for (size_t index = 0; index < calls.size(); index++) {
+        callers.emplace_back(runCall, calls[index].first, calls[index].second);
+        ASSERT_TRUE(WaitUntil([&scheduler, index]() { return scheduler.GetQueuedCount() == index + TWO; }));
+    }
+    {
+        lock_guard<mutex> guard(orderMutex);
+        ASSERT_TRUE(order.empty());
+    }
+    firstRead = nullptr;
+    for (auto &caller : callers) {
+        caller.join();
+    }
+    ASSERT_FALSE(overlapped);
+    ASSERT_EQ(calls.size(), order.size());
+    ASSERT_EQ("write0", order[0]);
+    // the reads between two writes run along with each other in any order
+    ASSERT_TRUE((order[1] == "read1" && order[2] == "read2") || (order[1] == "read2" && order[2] == "read1"));
+    ASSERT_EQ("write3", order[3]);
+    ASSERT_EQ("write4", order[4]);
+    ASSERT_EQ("read5", order[5]);
+}
+
+TEST(ApiCallSchedulerTest, widgetReadsShareSnapshot)
+{
+    static constexpr size_t readerCount = 4;
+    ApiCallScheduler scheduler;
+    atomic<size_t> running = 0;
+    atomic<size_t> met = 0;
+    vector<thread> readers;
+    for (size_t index = 0; index < readerCount; index++) {
+        readers.emplace_back([&scheduler, &running, &met]() {
+            ApiCallTurn turn(scheduler, API_READ_WIDGET);
+            running++;
+            if (WaitUntil([&running]() { return running == readerCount; })) {
+                met++;
+            }
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    ASSERT_EQ(readerCount, met);
+}
+
+TEST(ApiCallSchedulerTest, widgetReadWaitsForSnapshotRead)
+{
+    ApiCallScheduler scheduler;
+    atomic<bool> widgetRead = false;
+    auto snapshotRead = make_unique<ApiCallTurn>(scheduler, API_READ_SNAPSHOT);
+    thread reader([&scheduler, &widgetRead]() {
+        ApiCallTurn turn(scheduler, API_READ_WIDGET);
+        widgetRead = true;
+    });
+    ASSERT_TRUE(WaitUntil([&scheduler]() { return scheduler.GetQueuedCount() == TWO; }));
+    this_thread::sleep_for(chrono::milliseconds(INDEX_TEN));
+    // the snapshot is being traversed by the other read
+    ASSERT_FALSE(widgetRead);
+    snapshotRead = nullptr;
+    reader.join();
+    ASSERT_TRUE(widgetRead);
+}
+
+TEST(ApiCallSchedulerTest, yieldSnapshotWhileWaiting)
+{
+    ApiCallScheduler scheduler;
+    {
+        // nothing to release out of any turn
+        ApiCallYield yield;
+    }
+    atomic<bool> waiting = false;
+    atomic<bool> otherRead = false;
+    thread waiter([&scheduler, &waiting, &otherRead]() {
+        ApiCallTurn turn(scheduler, API_READ_SNAPSHOT);
+        ApiCallYield yield;
+        waiting = true;
+        WaitUntil([&otherRead]() { return otherRead.load(); });
+    });
+    ASSERT_TRUE(WaitUntil([&waiting]() { return waiting.load(); }));
+    {
+        // runs while the first read is waiting
+        ApiCallTurn turn(scheduler, API_READ_SNAPSHOT);
+        otherRead = true;
+    }
+    waiter.join();
+    ASSERT_EQ(0, scheduler.GetQueuedCount());
+}
+
+class ApiCallSchedulerServerTest : public testing::Test {
+protected:
+    static constexpr size_t itemCount = 8;
+
+    void SetUp() override
+    {
+        auto mockController = make_unique<MockController>();
+        controller_ = mockController.get();
+        UiDriver::RegisterController(move(mockController));
+        Window win(100);
+        win.displayId_ = 0;
+        win.bounds_ = Rect {0, 200, 0, 400};
+        win.bundleName_ = "com.test.app";
+        vector<MockAccessibilityElementInfo> eles(itemCount + 1);
+        eles[0].accessibilityId = "1";
+        eles[0].windowId = "100";
+        eles[0].content = "Root";
+        eles[0].rectInScreen = Rect {0, 200, 0, 400};
+        for (size_t index = 1; index <= itemCount; index++) {
+            const auto top = static_cast<int32_t>(index * 40);
+            eles[index].accessibilityId = to_string(index + 1);
+            eles[index].windowId = "100";
+            eles[index].parentIndex = 0;
+            eles[index].content = "item" + to_string(index - 1);
+            eles[index].rectInScreen = Rect {10, 190, top, top + 30};
+            eles[0].childIndexVec.emplace_back(index);
+        }
+        controller_->AddWindowsAndNode(win, eles);
+        // widen the window of the races
+        controller_->SetFetchLatencyMs(1);
+    }
+
+    string Invoke(string_view apiId, string_view caller, const json &params = json::array())
+    {
+        auto call = ApiCallInfo {.apiId_ = string(apiId), .callerObjRef_ = string(caller)};
+        call.paramList_ = params;
+        auto reply = ApiReplyInfo();
+        FrontendApiServer::Get().Call(call, reply);
+        EXPECT_EQ(NO_ERROR, reply.exception_.code_) << apiId << ": " << reply.exception_.message_;
+        return reply.resultValue_.is_string() ? reply.resultValue_.get<string>() : reply.resultValue_.dump();
+    }
+
+    /**Run the reading callers with the writes interleaved, checks the read components.*/
+    void RunConcurrentCallers();
+
+    MockController *controller_ = nullptr;
+};
+
+void ApiCallSchedulerServerTest::RunConcurrentCallers()
+{
+    static constexpr size_t callerCount = 16;
+    static constexpr size_t roundCount = 20;
+    const auto driverRef = Invoke("Driver.create", "");
+    vector<string> componentRefs;
+    for (size_t index = 0; index < itemCount; index++) {
+        const auto onRef = Invoke("On.text", REF_SEED_ON, json::array({"item" + to_string(index)}));
+        componentRefs.emplace_back(Invoke("Driver.findComponent", driverRef, json::array({onRef})));
+    }
+    atomic<size_t> mismatches = 0;
+    vector<thread> callers;
+    for (size_t index = 0; index < callerCount; index++) {
+        callers.emplace_back([&, index]() {
+            const auto item = index % itemCount;
+            const auto text = "item" + to_string(item);
+            for (size_t round = 0; round < roundCount; round++) {
+                mismatches += Invoke("Component.getText", componentRefs[item]) == text ? 0 : 1;
+                const auto onRef = Invoke("On.text", REF_SEED_ON, json::array({text}));
+                const auto componentRef = Invoke("Driver.findComponent", driverRef, json::array({onRef}));
+                mismatches += Invoke("Component.getText", componentRef) == text ? 0 : 1;
+                // the writes are interleaved with the reads of the other callers
+                if (round % callerCount == index) {
+                    Invoke("Driver.InvalidateUiSnapshot", driverRef);
+                    Invoke("Driver.click", driverRef, json::array({100, 50}));
+                    controller_->EmitUiEvent();
+                }
+                Invoke("BackendObjectsCleaner", "", json::array({onRef, componentRef}));
+            }
+        });
+    }
+    for (auto &caller : callers) {
+        caller.join();
+    }
+    ASSERT_EQ(0, mismatches);
+    Invoke("BackendObjectsCleaner", "", json::array({driverRef}));
+}
+
+TEST_F(ApiCallSchedulerServerTest, concurrentInProcessCallers)
+{
+    RunConcurrentCallers();
+}
+
+TEST_F(ApiCallSchedulerServerTest, concurrentInProcessCallersWithUiEvents)
+{
+    // the component getters read the stored widgets until the ui events come
+    controller_->SetUiEventTracked(true);
+    RunConcurrentCallers();
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "backend_object_table.h"
+#include "ui_model.h"
+#include "widget_selector.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+class FakeDriver : public BackendClass {
+public:
+    const FrontEndClassDef &GetFrontendClassDef() const override
+    {
+        return DRIVER_DEF;
+    }
+};
+
+static unique_ptr<Widget> MakeWidget(const string &text)
+{
+    auto widget = make_unique<Widget>("ROOT,0");
+    widget->SetAttr(UiAttr::TEXT, text);
+    return widget;
+}
+
+static string GetText(BackendObjectTable &table, const string &ref)
+{
+    auto object = table.Find(ref);
+    return object == nullptr ? "" : static_cast<Widget *>(object)->GetAttr(UiAttr::TEXT);
+}
+
+TEST(BackendObjectTableTest, useAfterRelease)
+{
+    BackendObjectTable table;
+    const auto driverRef = table.Store(make_unique<FakeDriver>());
+    const auto widgetRef = table.Store(MakeWidget("first"), driverRef);
+    ASSERT_EQ("Driver#0", driverRef);
+    ASSERT_EQ("Component#0", widgetRef);
+    ASSERT_EQ("first", GetText(table, widgetRef));
+    ASSERT_EQ(table.Find(driverRef), table.FindOwner(widgetRef));
+    ASSERT_EQ(driverRef, table.GetOwnerRef(widgetRef));
+    ASSERT_EQ(1, table.Release(widgetRef));
+    ASSERT_EQ(nullptr, table.Find(widgetRef));
+    ASSERT_EQ(nullptr, table.FindOwner(widgetRef));
+    ASSERT_EQ(0, table.Release(widgetRef));
+    // the slot is reused by a new generation, the former reference keeps stale
+    const auto reusedRef = table.Store(MakeWidget("second"), driverRef);
+    ASSERT_NE(widgetRef, reusedRef);
+    ASSERT_EQ(nullptr, table.Find(widgetRef));
+    ASSERT_EQ("second", GetText(table, reusedRef));
+    ASSERT_TRUE(BackendObjectTable::IsObjectRef(widgetRef));
+    ASSERT_EQ(TWO, table.GetLivingCount());
+}
+
+TEST(BackendObjectTableTest, releaseSessionObjects)
+{
+    BackendObjectTable table;
+    const auto driverRef = table.Store(make_unique<FakeDriver>());
+    const auto otherDriverRef = table.Store(make_unique<FakeDriver>());
+    vector<string> widgetRefs;
+    for (auto index = 0; index < 3; index++) {
+        widgetRefs.emplace_back(table.Store(MakeWidget(to_string(index)), driverRef));
+    }
+    const auto otherWidgetRef = table.Store(MakeWidget("other"), otherDriverRef);
+    const auto selectorRef = table.Store(make_unique<WidgetSelector>());
+    // release one bound object before the session
+    ASSERT_EQ(1, table.Release(widgetRefs[1]));
+    ASSERT_EQ(3, table.Release(driverRef));
+    ASSERT_EQ(nullptr, table.Find(driverRef));
+    for (const auto &ref : widgetRefs) {
+        ASSERT_EQ(nullptr, table.Find(ref));
+    }
+    ASSERT_EQ("other", GetText(table, otherWidgetRef));
+    ASSERT_NE(nullptr, table.Find(selectorRef));
+    ASSERT_EQ(3, table.GetLivingCount());
+    ASSERT_EQ(MakeWidget("other")->GetMemoryBytes(), table.GetWidgetMemory());
+}
+
+TEST(BackendObjectTableTest, evictLeastRecentlyUsedWidgets)
+{
+    BackendObjectTable table;
+    const auto widgetBytes = MakeWidget("0")->GetMemoryBytes();
+    table.SetWidgetMemoryLimit(widgetBytes * 3);
+    const auto driverRef = table.Store(make_unique<FakeDriver>());
+    vector<string> refs;
+    for (auto index = 0; index < 3; index++) {
+        const auto epoch = table.BeginCall();
+        refs.emplace_back(table.Store(MakeWidget(to_string(index)), driverRef));
+        table.EndCall(epoch);
+    }
+    // use the first one, then the second one is the least recently used
+    auto epoch = table.BeginCall();
+    ASSERT_EQ("0", GetText(table, refs[0]));
+    table.EndCall(epoch);
+    epoch = table.BeginCall();
+    refs.emplace_back(table.Store(MakeWidget("3"), driverRef));
+    ASSERT_EQ(nullptr, table.Find(refs[1]));
+    ASSERT_EQ("0", GetText(table, refs[0]));
+    ASSERT_EQ("2", GetText(table, refs[2]));
+    ASSERT_EQ("3", GetText(table, refs[3]));
+    ASSERT_EQ(widgetBytes * 3, table.GetWidgetMemory());
+    table.EndCall(epoch);
+    // the widgets used in the current call are kept beyond the limit
+    epoch = table.BeginCall();
+    ASSERT_EQ("0", GetText(table, refs[0]));
+    ASSERT_EQ("2", GetText(table, refs[2]));
+    ASSERT_EQ("3", GetText(table, refs[3]));
+    refs.emplace_back(table.Store(MakeWidget("4"), driverRef));
+    ASSERT_EQ(widgetBytes * 4, table.GetWidgetMemory());
+    ASSERT_EQ("4", GetText(table, refs[4]));
+    table.EndCall(epoch);
+    epoch = table.BeginCall();
+    refs.emplace_back(table.Store(MakeWidget("5"), driverRef));
+    table.EndCall(epoch);
+    ASSERT_EQ(widgetBytes * 3, table.GetWidgetMemory());
+    ASSERT_EQ(nullptr, table.Find(refs[0]));
+    ASSERT_EQ(nullptr, table.Find(refs[2]));
+    ASSERT_EQ("5", GetText(table, refs[5]));
+    // the evicted ones are unbound from the session
+    ASSERT_EQ(4, table.Release(driverRef));
+    ASSERT_EQ(0, table.GetLivingCount());
+    ASSERT_EQ(0, table.GetWidgetMemory());
+}
+
+TEST(BackendObjectTableTest, keepWidgetsOfCallsInProgress)
+{
+    BackendObjectTable table;
+    const auto widgetBytes = MakeWidget("0")->GetMemoryBytes();
+    table.SetWidgetMemoryLimit(widgetBytes);
+    const auto driverRef = table.Store(make_unique<FakeDriver>());
+    auto epoch = table.BeginCall();
+    const auto firstRef = table.Store(MakeWidget("0"), driverRef);
+    table.EndCall(epoch);
+    string secondRef;
+    {
+        // the first call uses the widget while another one stores new widgets
+        BackendObjectCall firstCall(table);
+        ASSERT_EQ("0", GetText(table, firstRef));
+        {
+            BackendObjectCall secondCall(table);
+            secondRef = table.Store(MakeWidget("1"), driverRef);
+        }
+        ASSERT_EQ("0", GetText(table, firstRef));
+        ASSERT_EQ(widgetBytes * TWO, table.GetWidgetMemory());
+    }
+    epoch = table.BeginCall();
+    const auto thirdRef = table.Store(MakeWidget("2"), driverRef);
+    table.EndCall(epoch);
+    ASSERT_EQ(nullptr, table.Find(firstRef));
+    ASSERT_EQ(nullptr, table.Find(secondRef));
+    ASSERT_EQ("2", GetText(table, thirdRef));
+    ASSERT_EQ(widgetBytes, table.GetWidgetMemory());
+}
+
+TEST(BackendObjectTableTest, malformedRefs)
+{
+    BackendObjectTable table;
+    table.Store(make_unique<FakeDriver>());
+    for (const auto ref : {"", "Driver", "Driver#", "#0", "Driver#seed", "Driver#-1", "Driver# 0",
+        "Driver#99999999999999999999999", "Unknown#0", "Driver#1"}) {
+        ASSERT_EQ(nullptr, table.Find(ref)) << ref;
+        ASSERT_EQ(0, table.Release(ref)) << ref;
+    }
+    ASSERT_FALSE(BackendObjectTable::IsObjectRef(REF_SEED_ON));
+    ASSERT_FALSE(BackendObjectTable::IsObjectRef("Unknown#0"));
+    ASSERT_TRUE(BackendObjectTable::IsObjectRef("On#100"));
+    ASSERT_EQ(1, table.GetLivingCount());
+}
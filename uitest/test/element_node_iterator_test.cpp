@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gtest/gtest.h"
+#include "element_node_iterator.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+struct BatchNode {
+    int64_t id;
+    vector<int64_t> childIds;
+};
+
+static void BuildIndex(ElementNodeIndex &index, const vector<BatchNode> &nodes)
+{
+    index.Build(
+        nodes.size(), [&nodes](size_t pos) { return nodes[pos].id; },
+        [&nodes](size_t pos) { return static_cast<int32_t>(nodes[pos].childIds.size()); },
+        [&nodes](size_t pos, int32_t slot) { return nodes[pos].childIds[slot]; });
+}
+
+TEST(ElementNodeIndexTest, testChildrenLocation)
+{
+    // children of one node are contiguous in the batch: 0 -> (1, 2, 3), 1 -> (4, 5), 3 -> (6)
+    vector<BatchNode> nodes = {{100, {101, 102, 103}}, {101, {104, 105}}, {102, {}}, {103, {106}},
+                               {104, {}}, {105, {}}, {106, {}}};
+    ElementNodeIndex index;
+    BuildIndex(index, nodes);
+    ASSERT_EQ(nodes.size(), index.Size());
+    ASSERT_EQ(3, index.GetChildCount(0));
+    ASSERT_EQ(1, index.GetFirstChild(0));
+    ASSERT_EQ(4, index.GetFirstChild(1));
+    ASSERT_EQ(6, index.GetFirstChild(3));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetFirstChild(2));
+    ASSERT_EQ(0, index.GetChildCount(2));
+    ASSERT_EQ(2, index.GetChildSlot(0, 3));
+    ASSERT_EQ(1, index.GetChildSlot(1, 5));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetChildSlot(1, 3));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetChildSlot(ElementNodeIndex::NO_NODE, 0));
+    ASSERT_EQ(0, index.GetChildCount(ElementNodeIndex::NO_NODE));
+}
+
+TEST(ElementNodeIndexTest, testMalformedBatch)
+{
+    // child 203 is missing, so only the children before it are located; 204 is not in the batch at all
+    vector<BatchNode> nodes = {{200, {201, 202, 203}}, {201, {204}}, {202, {}}, {205, {}}};
+    ElementNodeIndex index;
+    BuildIndex(index, nodes);
+    ASSERT_EQ(2, index.GetChildCount(0));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetChildSlot(0, 3));
+    ASSERT_EQ(0, index.GetChildCount(1));
+    // duplicated id, the child is the first one after its parent
+    vector<BatchNode> dupNodes = {{300, {301}}, {301, {300}}, {300, {}}};
+    BuildIndex(index, dupNodes);
+    ASSERT_EQ(1, index.GetFirstChild(0));
+    ASSERT_EQ(2, index.GetFirstChild(1));
+}
+
+TEST(ElementNodeIndexTest, testVisitMarks)
+{
+    vector<BatchNode> nodes = {{1, {2, 3}}, {2, {}}, {3, {}}};
+    ElementNodeIndex index;
+    BuildIndex(index, nodes);
+    ASSERT_FALSE(index.IsVisited(0));
+    index.MarkVisited(0, ElementNodeIndex::NO_NODE);
+    index.MarkVisited(1, 0);
+    ASSERT_TRUE(index.IsVisitedAndVisible(1));
+    ASSERT_EQ(0, index.GetVisitedDepth(0));
+    ASSERT_EQ(1, index.GetVisitedDepth(1));
+    index.MarkInvisible(1);
+    ASSERT_TRUE(index.IsVisited(1));
+    ASSERT_FALSE(index.IsVisitedAndVisible(1));
+    // revisiting keeps the parent and does not count twice
+    index.MarkVisited(1, 2);
+    ASSERT_TRUE(index.IsVisitedAndVisible(1));
+    ASSERT_EQ(0, index.GetVisitedParent(1));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetVisitedParent(0));
+    ASSERT_EQ(2, index.GetVisitedCount());
+    index.MarkInvisible(0);
+    index.ClearVisit();
+    ASSERT_EQ(0, index.GetVisitedCount());
+    ASSERT_FALSE(index.IsVisited(0));
+    ASSERT_FALSE(index.IsVisited(1));
+    ASSERT_EQ(ElementNodeIndex::NO_NODE, index.GetVisitedParent(1));
+    index.MarkVisited(0, ElementNodeIndex::NO_NODE);
+    ASSERT_TRUE(index.IsVisitedAndVisible(0));
+    ASSERT_EQ(1, index.GetVisitedCount());
+}
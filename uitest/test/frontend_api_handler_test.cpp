@@ -21,7 +21,10 @@
 #define private public
 #include "frontend_api_handler.h"
 #undef private
+#include "frontend_api_tables.h"
 #include "dummy_controller.h"
+#include "mock_element_node_iterator.h"
+#include "mock_controller.h"
 #include "widget_selector.h"
 #include "ui_driver.h"
 
@@ -202,6 +205,38 @@ TEST_F(FrontendApiHandlerTest, checkAllHandlersRegisted)
     }
 }
 
+TEST_F(FrontendApiHandlerTest, frontendApiTables)
+{
+    // each frontend-api is found by the perfect hash, with the overloads chained in the order of definition
+    for (const auto &classDef : FRONTEND_CLASS_DEFS) {
+        for (size_t idx = 0; idx < classDef->methodCount_; idx++) {
+            const auto &methodDef = classDef->methods_[idx];
+            auto method = FindFrontendApi(methodDef.name_);
+            ASSERT_NE(NO_API_METHOD, method) << methodDef.name_;
+            while (FRONTEND_API_TABLES.methods_[method].apiId_ == methodDef.name_ &&
+                &GetFrontendMethod(method) != &methodDef) {
+                method = FRONTEND_API_TABLES.methods_[method].nextOverload_;
+                ASSERT_NE(NO_API_METHOD, method) << methodDef.name_;
+            }
+            for (size_t arg = 0; arg < FRONTEND_API_TABLES.methods_[method].maxArgc_; arg++) {
+                const auto &validator = FRONTEND_API_TABLES.args_[FRONTEND_API_TABLES.methods_[method].argStart_ + arg];
+                ASSERT_NE(ARG_UNKNOWN, validator.kind_) << methodDef.name_ << " arg" << arg;
+            }
+        }
+    }
+    ASSERT_NE(NO_API_METHOD, FindFrontendApi("Driver.InvalidateUiSnapshot"));
+    ASSERT_EQ(NO_API_METHOD, FindFrontendApi("Driver.clickx"));
+    ASSERT_EQ(NO_API_METHOD, FindFrontendApi(""));
+    const auto click = FindFrontendApi("Driver.click");
+    const auto &signature = FRONTEND_API_TABLES.methods_[click];
+    ASSERT_EQ(TWO, signature.maxArgc_);
+    ASSERT_EQ("void", signature.returnType_);
+    ASSERT_NE(NO_API_METHOD, signature.nextOverload_);
+    const auto &overload = FRONTEND_API_TABLES.methods_[signature.nextOverload_];
+    ASSERT_EQ(ARG_JSON_OBJECT, FRONTEND_API_TABLES.args_[overload.argStart_].kind_);
+    ASSERT_EQ("Point", FRONTEND_API_TABLES.args_[overload.argStart_].type_);
+}
+
 // API8 end to end call test
 TEST_F(FrontendApiHandlerTest, callApiE2EOldAPi)
 {
@@ -1611,4 +1646,237 @@ TEST_F(FrontendApiHandlerTest, MouseDragNewInterfaceWithoutOptions)
     auto reply2 = ApiReplyInfo();
     server.Call(call2, reply2);
     EXPECT_EQ(NO_ERROR, reply2.exception_.code_);  // Should use default speed and duration
-}
\ No newline at end of file
+}
+
+TEST_F(FrontendApiHandlerTest, findComponentsBatchParameterPreChecks)
+{
+    const auto& server =  FrontendApiServer::Get();
+    auto call0 = ApiCallInfo {.apiId_ = "Driver.create"};
+    auto reply0 = ApiReplyInfo();
+    server.Call(call0, reply0);
+    const auto driverRef = reply0.resultValue_.get<string>();
+    auto call1 = ApiCallInfo {.apiId_ = "On.text", .callerObjRef_ = string(REF_SEED_ON)};
+    call1.paramList_.emplace_back("wyz");
+    auto reply1 = ApiReplyInfo();
+    server.Call(call1, reply1);
+    const auto onRef = reply1.resultValue_.get<string>();
+    // the argument must be an array
+    auto call2 = ApiCallInfo {.apiId_ = "Driver.findComponentsBatch", .callerObjRef_ = driverRef};
+    call2.paramList_.emplace_back(onRef);
+    auto reply2 = ApiReplyInfo();
+    server.Call(call2, reply2);
+    ASSERT_EQ(ERR_INVALID_PARAM, reply2.exception_.code_);
+    ASSERT_TRUE(reply2.exception_.message_.find("Expect array") != string::npos);
+    // each element must be an On
+    auto call3 = ApiCallInfo {.apiId_ = "Driver.findComponentsBatch", .callerObjRef_ = driverRef};
+    call3.paramList_.emplace_back(json::array({onRef, 1}));
+    auto reply3 = ApiReplyInfo();
+    server.Call(call3, reply3);
+    ASSERT_EQ(ERR_INVALID_PARAM, reply3.exception_.code_);
+    ASSERT_TRUE(reply3.exception_.message_.find("Illegal element 1") != string::npos);
+}
+
+TEST_F(FrontendApiHandlerTest, staleObjectRefs)
+{
+    const auto& server =  FrontendApiServer::Get();
+    auto call0 = ApiCallInfo {.apiId_ = "Driver.create"};
+    auto reply0 = ApiReplyInfo();
+    server.Call(call0, reply0);
+    const auto driverRef = reply0.resultValue_.get<string>();
+    auto call1 = ApiCallInfo {.apiId_ = "On.text", .callerObjRef_ = string(REF_SEED_ON)};
+    call1.paramList_.emplace_back("wyz");
+    auto reply1 = ApiReplyInfo();
+    server.Call(call1, reply1);
+    const auto onRef = reply1.resultValue_.get<string>();
+    auto call2 = ApiCallInfo {.apiId_ = "BackendObjectsCleaner"};
+    call2.paramList_ = json::array({driverRef, onRef});
+    auto reply2 = ApiReplyInfo();
+    server.Call(call2, reply2);
+    ASSERT_EQ(NO_ERROR, reply2.exception_.code_);
+    // released caller and argument are told without crashing
+    auto call3 = ApiCallInfo {.apiId_ = "Driver.findComponent", .callerObjRef_ = driverRef};
+    call3.paramList_.emplace_back(onRef);
+    auto reply3 = ApiReplyInfo();
+    server.Call(call3, reply3);
+    ASSERT_EQ(ERR_INTERNAL, reply3.exception_.code_);
+    ASSERT_TRUE(reply3.exception_.message_.find("Check caller failed: Bad object ref") != string::npos);
+    auto call4 = ApiCallInfo {.apiId_ = "On.isAfter", .callerObjRef_ = string(REF_SEED_ON)};
+    call4.paramList_.emplace_back(onRef);
+    auto reply4 = ApiReplyInfo();
+    server.Call(call4, reply4);
+    ASSERT_EQ(ERR_INTERNAL, reply4.exception_.code_);
+    ASSERT_TRUE(reply4.exception_.message_.find("Bad object ref") != string::npos);
+    // released or evicted component is told lost
+    auto call5 = ApiCallInfo {.apiId_ = "Component.getText", .callerObjRef_ = "Component#99999"};
+    auto reply5 = ApiReplyInfo();
+    server.Call(call5, reply5);
+    ASSERT_EQ(ERR_COMPONENT_LOST, reply5.exception_.code_);
+}
+
+class FrontendApiBatchTest : public testing::Test {
+protected:
+    void SetUp() override
+    {
+        auto mockController = make_unique<MockController>();
+        Window win(100);
+        win.displayId_ = 0;
+        win.bounds_ = Rect {0, 200, 0, 400};
+        win.bundleName_ = "com.test.app";
+        vector<MockAccessibilityElementInfo> eles(THREE);
+        eles[0].accessibilityId = "1";
+        eles[0].windowId = "100";
+        eles[0].rectInScreen = Rect {0, 200, 0, 400};
+        eles[0].childIndexVec = {1, 2};
+        for (size_t index = 1; index < eles.size(); index++) {
+            eles[index].accessibilityId = to_string(index + 1);
+            eles[index].windowId = "100";
+            eles[index].parentIndex = 0;
+            eles[index].content = "item" + to_string(index);
+            const auto top = static_cast<int32_t>(index * 100);
+            eles[index].rectInScreen = Rect {10, 190, top, top + 50};
+        }
+        mockController->AddWindowsAndNode(win, eles);
+        UiDriver::RegisterController(move(mockController));
+        auto call = ApiCallInfo {.apiId_ = "Driver.create"};
+        auto reply = ApiReplyInfo();
+        FrontendApiServer::Get().Call(call, reply);
+        driverRef_ = reply.resultValue_.get<string>();
+    }
+
+    void TearDown() override
+    {
+        auto call = ApiCallInfo {.apiId_ = "BackendObjectsCleaner"};
+        call.paramList_.emplace_back(driverRef_);
+        auto reply = ApiReplyInfo();
+        FrontendApiServer::Get().Call(call, reply);
+    }
+
+    ApiReplyInfo ExecuteBatch(const json &steps)
+    {
+        auto call = ApiCallInfo {.apiId_ = "Driver.executeBatch", .callerObjRef_ = driverRef_};
+        call.paramList_.emplace_back(steps);
+        auto reply = ApiReplyInfo();
+        FrontendApiServer::Get().Call(call, reply);
+        return reply;
+    }
+
+    string driverRef_;
+};
+
+TEST_F(FrontendApiBatchTest, chainedSteps)
+{
+    ASSERT_EQ(API_MUTATING, GetApiAccess("Driver.executeBatch"));
+    const auto steps = json::array({
+        {{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"item2"}}},
+        {{"api", "Driver.findComponent"}, {"args", {{{"$step", 0}}}}},
+        {{"api", "Component.getText"}, {"this", {{"$step", 1}}}},
+        {{"api", "Component.getBoundsCenter"}, {"this", {{"$step", 1}}}},
+        {{"api", "Driver.click"}, {"args", {{{"$step", 3}}}}},
+        {{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"item", ValueMatchPattern::STARTS_WITH}}},
+        {{"api", "Driver.findComponents"}, {"this", driverRef_}, {"args", {{{"$step", 5}}}}},
+        {{"api", "Component.getText"}, {"this", {{"$step", 6}, {"$index", 0}}}},
+    });
+    auto reply = ExecuteBatch(steps);
+    ASSERT_EQ(NO_ERROR, reply.exception_.code_) << reply.exception_.message_;
+    const auto &results = reply.resultValue_;
+    ASSERT_EQ(steps.size(), results.size());
+    ASSERT_EQ(0, results[1].get<string>().find("Component#"));
+    ASSERT_EQ("item2", results[2]);
+    ASSERT_EQ(100, results[3]["x"]);
+    ASSERT_EQ(225, results[3]["y"]);
+    ASSERT_TRUE(results[4].is_null());
+    ASSERT_EQ(TWO, results[6].size());
+    ASSERT_EQ("item1", results[7]);
+    // the objects created by the steps are returned to the caller
+    auto call = ApiCallInfo {.apiId_ = "Component.getText", .callerObjRef_ = results[1].get<string>()};
+    auto getText = ApiReplyInfo();
+    FrontendApiServer::Get().Call(call, getText);
+    ASSERT_EQ("item2", getText.resultValue_);
+    // empty batch
+    reply = ExecuteBatch(json::array());
+    ASSERT_EQ(NO_ERROR, reply.exception_.code_);
+    ASSERT_EQ(json::array(), reply.resultValue_);
+}
+
+TEST_F(FrontendApiBatchTest, stopAtFirstError)
+{
+    // step failed in the handler
+    auto reply = ExecuteBatch(json::array({
+        {{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"item1"}}},
+        {{"api", "Driver.findComponent"}, {"args", {{{"$step", 0}}}}},
+        {{"api", "Driver.findWindow"}, {"args", {json::object()}}},
+        {{"api", "Driver.click"}, {"args", {0, 0}}},
+    }));
+    ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    ASSERT_EQ("Step 2 (Driver.findWindow) failed: WindowFilter cannot be empty", reply.exception_.message_);
+    ASSERT_TRUE(reply.resultValue_.is_null());
+    // step failed in the argument checking
+    reply = ExecuteBatch(json::array({{{"api", "Driver.findComponent"}, {"args", {1}}}}));
+    ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    ASSERT_EQ(0, reply.exception_.message_.find("Step 0 (Driver.findComponent) failed: (PreProcessing"));
+    // references to the later steps, to the elements of non-array results, and to the batch are illegal
+    const vector<json> badSteps = {
+        {{"api", "Component.getText"}, {"this", {{"$step", 1}}}},
+        {{"api", "Component.getText"}, {"this", {{"$step", 0}, {"$index", 0}}}},
+        {{"api", "Component.getText"}, {"this", {{"$step", -1}}}},
+        {{"api", "Component.getText"}, {"this", 1}},
+        {{"api", "Driver.executeBatch"}, {"args", {json::array()}}},
+    };
+    for (const auto &step : badSteps) {
+        reply = ExecuteBatch(json::array({{{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"a"}}}, step}));
+        ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_) << step.dump();
+        ASSERT_EQ(0, reply.exception_.message_.find("Step 1 ")) << reply.exception_.message_;
+    }
+    // the steps are checked as BatchStep
+    reply = ExecuteBatch(json::array({{{"args", json::array()}}}));
+    ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    ASSERT_TRUE(reply.exception_.message_.find("Missing property api") != string::npos);
+    reply = ExecuteBatch(json::array({{{"api", "On.text"}, {"argz", json::array()}}}));
+    ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    ASSERT_TRUE(reply.exception_.message_.find("Illegal property of BatchStep") != string::npos);
+}
+
+TEST_F(FrontendApiBatchTest, malformedSteps)
+{
+    auto &server = FrontendApiServer::Get();
+    // a failed preprocessor lets the handler run without the argument checking
+    server.AddCommonPreprocessor("0failedProcessor", [](const ApiCallInfo &in, ApiReplyInfo &out) {
+        throw runtime_error("failed");
+    });
+    const vector<json> badSteps = {"Driver.click", 1, json::array(), {{"api", 1}}, {{"args", json::array()}},
+        {{"api", "Driver.click"}, {"args", 1}}};
+    for (const auto &step : badSteps) {
+        auto reply = ExecuteBatch(json::array({{{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"a"}}}, step}));
+        EXPECT_EQ(ERR_INVALID_PARAM, reply.exception_.code_) << step.dump();
+        EXPECT_EQ(0, reply.exception_.message_.find("Illegal step 1")) << reply.exception_.message_;
+        EXPECT_TRUE(reply.resultValue_.is_null());
+    }
+    auto reply = ExecuteBatch(json::object());
+    EXPECT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    server.RemoveCommonPreprocessor("0failedProcessor");
+}
+
+TEST_F(FrontendApiBatchTest, releaseCreatedObjectsOnError)
+{
+    auto &server = FrontendApiServer::Get();
+    string componentRef;
+    server.AddCommonPreprocessor("0recordingProcessor", [&componentRef](const ApiCallInfo &in, ApiReplyInfo &out) {
+        if (in.apiId_ == "Component.getText") {
+            componentRef = in.callerObjRef_;
+        }
+    });
+    auto reply = ExecuteBatch(json::array({
+        {{"api", "On.text"}, {"this", REF_SEED_ON}, {"args", {"item1"}}},
+        {{"api", "Driver.findComponent"}, {"args", {{{"$step", 0}}}}},
+        {{"api", "Component.getText"}, {"this", {{"$step", 1}}}},
+        {{"api", "Driver.findWindow"}, {"args", {json::object()}}},
+    }));
+    server.RemoveCommonPreprocessor("0recordingProcessor");
+    ASSERT_EQ(ERR_INVALID_PARAM, reply.exception_.code_);
+    ASSERT_EQ(0, componentRef.find("Component#"));
+    // the component found by the batch is released along with the failure
+    auto call = ApiCallInfo {.apiId_ = "Component.getText", .callerObjRef_ = componentRef};
+    reply = ApiReplyInfo();
+    server.Call(call, reply);
+    ASSERT_NE(NO_ERROR, reply.exception_.code_);
+}
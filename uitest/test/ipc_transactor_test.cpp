@@ -224,9 +224,9 @@ TEST(ApiTransactorTest, testHandleFdParam)
 }
 #endif
 
-TEST(ApiTransactorTest, testDetectConcurrentTransaction)
+TEST(ApiTransactorTest, testOverlappedTransaction)
 {
-    constexpr string_view token = "testDetectConcurrentTransaction";
+    constexpr string_view token = "testOverlappedTransaction";
     static constexpr uint32_t apiCostMs = 100; // mock the timecost of api invocation
     // fork and run server
     auto pid = fork();
@@ -237,7 +237,7 @@ TEST(ApiTransactorTest, testDetectConcurrentTransaction)
         };
         ApiTransactor server(true);
         if (server.InitAndConnectPeer(token, executor)) {
-            this_thread::sleep_for(chrono::milliseconds(apiCostMs << 1));
+            this_thread::sleep_for(chrono::milliseconds(apiCostMs << 2));
         }
         exit(0);
     }
@@ -247,7 +247,7 @@ TEST(ApiTransactorTest, testDetectConcurrentTransaction)
     pid = fork();
     ASSERT_NE(pid, -1);
     if (pid == 0) {
-        RedirectStdoutToPipe("testDetectConcurrentTransaction-client", fds);
+        RedirectStdoutToPipe("testOverlappedTransaction-client", fds);
         ApiTransactor client(false);
         auto connSuccess = client.InitAndConnectPeer(token, nullptr);
         ASSERT_EQ(connSuccess, true);
@@ -256,12 +256,12 @@ TEST(ApiTransactorTest, testDetectConcurrentTransaction)
         auto call1 = ApiCallInfo {.apiId_ = "testApi1"};
         ApiReplyInfo result1;
         auto ft = async(launch::async, [&]() { client.Transact(call0, result0); });
-        // delay to ensure invocation(call0,reply0) on going
+        // delay to ensure invocation(call0,reply0) on going, the server schedules the overlapping calls
         this_thread::sleep_for(chrono::milliseconds(apiCostMs >> 1));
         client.Transact(call1, result1);
         ft.get();
         ASSERT_EQ(result0.exception_.code_, NO_ERROR);
-        ASSERT_EQ(result1.exception_.code_, ERR_API_USAGE);
+        ASSERT_EQ(result1.exception_.code_, NO_ERROR);
         exit(0);
     }
     // receive output of client in main process and do assertions
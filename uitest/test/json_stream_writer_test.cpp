@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "gtest/gtest.h"
+#include "nlohmann/json.hpp"
+#include "json_stream_writer.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+// write the json value with the writer, the object keys are iterated in the sorted order
+static void WriteJson(JsonStreamWriter &writer, const nlohmann::json &value)
+{
+    if (value.is_object()) {
+        writer.BeginObject();
+        for (const auto &[key, item] : value.items()) {
+            writer.Key(key);
+            WriteJson(writer, item);
+        }
+        writer.EndObject();
+    } else if (value.is_array()) {
+        writer.BeginArray();
+        for (const auto &item : value) {
+            WriteJson(writer, item);
+        }
+        writer.EndArray();
+    } else {
+        writer.String(value.get<string>());
+    }
+}
+
+static string WriteToString(const nlohmann::json &value, size_t bufferSize)
+{
+    auto file = tmpfile();
+    {
+        JsonStreamWriter writer(fileno(file), bufferSize);
+        WriteJson(writer, value);
+        EXPECT_TRUE(writer.Flush());
+        EXPECT_TRUE(writer.IsGood());
+    }
+    string content;
+    rewind(file);
+    char buffer[BUFSIZ];
+    for (size_t size = 0; (size = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+        content.append(buffer, size);
+    }
+    fclose(file);
+    return content;
+}
+
+TEST(JsonStreamWriterTest, identicalToDump)
+{
+    auto value = nlohmann::json::parse(R"({
+        "b": ["", "text", {}, [], [[]], {"z": "1", "a": "2"}],
+        "a": {"key with space": "value", "quote\"key": "back\\slash"},
+        "c": []
+    })");
+    value["d"] = {"line\nbreak", "tab\tand\x01\x1f", "中文", "del\x7f", "invalid\xff\xc3", "truncated\xe4\xb8"};
+    const auto expected = value.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+    for (size_t bufferSize : {size_t(1), size_t(7), JsonStreamWriter::DEFAULT_BUFFER_SIZE}) {
+        ASSERT_EQ(expected, WriteToString(value, bufferSize));
+    }
+    ASSERT_EQ("[]", WriteToString(nlohmann::json::array(), JsonStreamWriter::DEFAULT_BUFFER_SIZE));
+    ASSERT_EQ("{}", WriteToString(nlohmann::json::object(), JsonStreamWriter::DEFAULT_BUFFER_SIZE));
+}
+
+TEST(JsonStreamWriterTest, writeFailed)
+{
+    JsonStreamWriter writer(-1);
+    writer.BeginArray();
+    writer.String("value");
+    writer.EndArray();
+    ASSERT_TRUE(writer.IsGood());
+    ASSERT_FALSE(writer.Flush());
+    ASSERT_FALSE(writer.IsGood());
+    ASSERT_EQ(strlen("[\"value\"]"), writer.GetSize());
+}
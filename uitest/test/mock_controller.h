@@ -16,6 +16,11 @@
 #ifndef MOCK_CONTROLLER_H
 #define MOCK_CONTROLLER_H
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "ui_controller.h"
 #include "ui_model.h"
 #include "element_node_iterator.h"
@@ -32,6 +37,19 @@ namespace OHOS::uitest {
                                 std::unique_ptr<ElementNodeIterator> &elementNodeIterator,
                                 AamsWorkMode mode) override
         {
+            // mock the latency of fetching the nodes by the accessibility service
+            fetchCount_++;
+            auto fetching = ++fetchingCount_;
+            for (auto peak = maxFetchingCount_.load(); fetching > peak;) {
+                if (maxFetchingCount_.compare_exchange_weak(peak, fetching)) {
+                    break;
+                }
+            }
+            if (fetchLatencyMs_ > 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(fetchLatencyMs_));
+            }
+            --fetchingCount_;
+            std::lock_guard<std::mutex> locker(mockMtx_);
             // copy ele
             auto eleCopy = windowNodeMap.at(winInfo.id_);
             elementNodeIterator = std::make_unique<MockElementNodeIterator>(eleCopy);
@@ -42,6 +60,22 @@ namespace OHOS::uitest {
             return true;
         }
 
+        void SetFetchLatencyMs(uint32_t latencyMs)
+        {
+            fetchLatencyMs_ = latencyMs;
+        }
+
+        int32_t GetFetchCount() const
+        {
+            return fetchCount_;
+        }
+
+        /**The most window fetches ever in flight at the same time.*/
+        int32_t GetMaxConcurrentFetches() const
+        {
+            return maxFetchingCount_;
+        }
+
         bool IsWorkable() const override
         {
             return true;
@@ -84,13 +118,90 @@ namespace OHOS::uitest {
 
         void AddWindowsAndNode(Window in, std::vector<MockAccessibilityElementInfo> eles)
         {
-            testIn.emplace(in.id_, in);
-            windowNodeMap.emplace(in.id_, eles);
+            {
+                std::lock_guard<std::mutex> locker(mockMtx_);
+                testIn.emplace(in.id_, in);
+                windowNodeMap.emplace(in.id_, eles);
+            }
+            EmitUiEvent();
         }
         void RemoveWindowsAndNode(Window in)
         {
-            testIn.erase(in.id_);
-            windowNodeMap.erase(in.id_);
+            {
+                std::lock_guard<std::mutex> locker(mockMtx_);
+                testIn.erase(in.id_);
+                windowNodeMap.erase(in.id_);
+            }
+            EmitUiEvent();
+        }
+
+        uint64_t GetUiEventEpoch() const override
+        {
+            std::lock_guard<std::mutex> locker(eventMtx_);
+            return uiEventTracked_ ? uiEventEpoch_ : 0;
+        }
+
+        bool WaitForUiEvent(uint64_t epoch, uint32_t timeoutMs) const override
+        {
+            std::unique_lock<std::mutex> locker(eventMtx_);
+            return eventCond_.wait_for(locker, std::chrono::milliseconds(timeoutMs), [this, epoch]() {
+                return (uiEventTracked_ ? uiEventEpoch_ : 0) != epoch;
+            });
+        }
+
+        void SetUiEventTracked(bool tracked)
+        {
+            std::lock_guard<std::mutex> locker(eventMtx_);
+            uiEventTracked_ = tracked;
+        }
+
+        void EmitUiEvent()
+        {
+            {
+                std::lock_guard<std::mutex> locker(eventMtx_);
+                uiEventEpoch_++;
+            }
+            eventCond_.notify_all();
+        }
+
+        bool WaitForUiSteady(uint32_t idleThresholdMs, uint32_t timeoutMs) const override
+        {
+            waitForUiSteadyCount_++;
+            lastSteadyThresholdMs_ = idleThresholdMs;
+            if (!steadyByUiEvents_) {
+                return true;
+            }
+            // steady once no ui event comes within the threshold
+            const auto startMs = GetCurrentMillisecond();
+            std::unique_lock<std::mutex> locker(eventMtx_);
+            while (GetCurrentMillisecond() - startMs < timeoutMs) {
+                const auto epoch = uiEventEpoch_;
+                if (!eventCond_.wait_for(locker, std::chrono::milliseconds(idleThresholdMs),
+                    [this, epoch]() { return uiEventEpoch_ != epoch; })) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void SetUiSteadyByUiEvents(bool enable)
+        {
+            steadyByUiEvents_ = enable;
+        }
+
+        uint32_t GetLastSteadyThresholdMs() const
+        {
+            return lastSteadyThresholdMs_;
+        }
+
+        int32_t GetWaitForUiSteadyCount() const
+        {
+            return waitForUiSteadyCount_;
+        }
+
+        int32_t GetUiWindowsCount() const
+        {
+            return getUiWindowsCount_;
         }
 
         void SetCurrentUser(int32_t userId)
@@ -108,9 +219,28 @@ namespace OHOS::uitest {
             displayToUserMap_[displayId] = userId;
         }
 
+        void SetHidumperInfo(int32_t windowId, const std::string &info)
+        {
+            hidumperInfos_[windowId] = info;
+        }
+
+        void GetHidumperInfo(std::string windowId, char **buf, size_t &len) override
+        {
+            auto find = hidumperInfos_.find(atoi(windowId.c_str()));
+            if (find == hidumperInfos_.end()) {
+                return;
+            }
+            len = find->second.size();
+            *buf = new char[len + 1];
+            std::copy(find->second.begin(), find->second.end(), *buf);
+            (*buf)[len] = '\0';
+        }
+
         void GetUiWindows(std::map<int32_t, vector<Window>> &out, int32_t targetDisplay,
             bool skipWaitForUiSteady, bool needAbilityInfo) override
         {
+            getUiWindowsCount_++;
+            std::lock_guard<std::mutex> locker(mockMtx_);
             vector<Window> winInfos;
             for (auto iter = testIn.cbegin(); iter != testIn.cend(); ++iter) {
                 Window win = iter->second;
@@ -129,7 +259,21 @@ namespace OHOS::uitest {
         std::map<int, Window> testIn;
         std::map<int, std::vector<MockAccessibilityElementInfo>> windowNodeMap;
         std::map<int32_t, int32_t> displayToUserMap_ = {{0, -1}, {1, -1}};
-        int32_t currentUser_ = -1;
+        std::map<int32_t, std::string> hidumperInfos_;
+        std::atomic<int32_t> currentUser_ = -1;
+        bool uiEventTracked_ = false;
+        uint64_t uiEventEpoch_ = 1;
+        std::atomic<int32_t> getUiWindowsCount_ = 0;
+        mutable std::atomic<int32_t> waitForUiSteadyCount_ = 0;
+        mutable std::atomic<uint32_t> lastSteadyThresholdMs_ = 0;
+        std::atomic<bool> steadyByUiEvents_ = false;
+        mutable std::mutex mockMtx_;
+        mutable std::mutex eventMtx_;
+        mutable std::condition_variable eventCond_;
+        uint32_t fetchLatencyMs_ = 0;
+        std::atomic<int32_t> fetchCount_ = 0;
+        std::atomic<int32_t> fetchingCount_ = 0;
+        std::atomic<int32_t> maxFetchingCount_ = 0;
     };
 } // namespace OHOS::uitest
 #endif
\ No newline at end of file
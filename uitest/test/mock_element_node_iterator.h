@@ -161,10 +161,15 @@ namespace OHOS::uitest {
 
         bool DFSNextWithInTarget(Widget &widget) override
         {
-            if (elementInfoLists_[currentIndex_ + 1].parentIndex == elementInfoLists_[topIndex_].parentIndex) {
+            if (currentIndex_ + 1 >= static_cast<int>(elementInfoLists_.size())) {
                 return false;
             }
-            if (currentIndex_ >= elementInfoLists_.size() - 1) {
+            // the next node is in the target only if the target is one of its ancestors
+            auto parent = elementInfoLists_[currentIndex_ + 1].parentIndex;
+            while (parent >= 0 && parent != topIndex_) {
+                parent = elementInfoLists_[parent].parentIndex;
+            }
+            if (parent != topIndex_) {
                 return false;
             }
             ++currentIndex_;
@@ -184,7 +189,7 @@ namespace OHOS::uitest {
 
         bool IsVisitFinish() const override
         {
-            return elementInfoLists_.size() == elementToParentIndexMap_.size();
+            return elementInfoLists_.size() == nodeIndex_.GetVisitedCount();
         }
         void RestoreNodeIndexByAnchor() override
         {
@@ -196,16 +201,14 @@ namespace OHOS::uitest {
         }
         void ClearDFSNext() override
         {
-            elementToParentIndexMap_.clear();
-            elementIndexToHierarch_.clear();
-            visitAndVisibleIndexSet_.clear();
+            nodeIndex_.ClearVisit();
             currentIndex_ = -1;
             topIndex_ = 0;
         }
 
         void RemoveInvisibleWidget() override
         {
-            visitAndVisibleIndexSet_.erase(currentIndex_);
+            nodeIndex_.MarkInvisible(currentIndex_);
         }
 
         std::vector<MockAccessibilityElementInfo> elementInfoLists_;
@@ -258,8 +261,14 @@ namespace OHOS::uitest {
         }
         void WrapperElement(Widget &widget) override
         {
-            MockAccessibilityElementInfo element = elementInfoLists_[currentIndex_];
+            const MockAccessibilityElementInfo &element = elementInfoLists_[currentIndex_];
+            widget.SetAttrPool(attrPool_);
             WrapperNodeAttrToVec(widget, element);
+            int32_t depth = 0;
+            for (auto parent = element.parentIndex; parent >= 0; parent = elementInfoLists_[parent].parentIndex) {
+                depth++;
+            }
+            widget.SetNodePosition(currentIndex_, element.parentIndex, depth);
         }
     };
 } // namespace OHOS::uitest
@@ -13,6 +13,10 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
 #include "gtest/gtest.h"
 #include "ui_model.h"
 
@@ -183,4 +187,188 @@ TEST(RectAlgorithmTest, computeMaxVisibleRegion)
     auto expectedVisibleRegion = Rect(1316, 2560, 72, 1600);
     RectAlgorithm::ComputeMaxVisibleRegion(rect, overlaySet, region);
     ASSERT_TRUE(RectAlgorithm::CheckEqual(region, expectedVisibleRegion));
-}
\ No newline at end of file
+}
+// the subtraction of the overlays one by one before the banded sweep, which keeps every fragment
+static int64_t LegacyMaxVisibleArea(const Rect &origRect, const vector<Rect> &overlays)
+{
+    vector<Rect> current = {origRect};
+    for (auto obstacle : overlays) {
+        vector<Rect> next;
+        for (auto rect : current) {
+            Rect intersection(0, 0, 0, 0);
+            if (!RectAlgorithm::ComputeIntersection(rect, obstacle, intersection)) {
+                next.push_back(rect);
+                continue;
+            }
+            if (intersection.bottom_ < rect.bottom_) {
+                next.push_back(Rect(rect.left_, rect.right_, intersection.bottom_, rect.bottom_));
+            }
+            if (rect.top_ < intersection.top_) {
+                next.push_back(Rect(rect.left_, rect.right_, rect.top_, intersection.top_));
+            }
+            if (rect.left_ < intersection.left_) {
+                next.push_back(Rect(rect.left_, intersection.left_, rect.top_, rect.bottom_));
+            }
+            if (intersection.right_ < rect.right_) {
+                next.push_back(Rect(intersection.right_, rect.right_, rect.top_, rect.bottom_));
+            }
+        }
+        current = next;
+    }
+    int64_t maxArea = 0;
+    for (auto rect : current) {
+        if (rect.IsValid()) {
+            maxArea = max<int64_t>(maxArea, rect.GetArea());
+        }
+    }
+    return maxArea;
+}
+
+// the visible rectangle of every pair of the coordinates, with the documented tie-breaking
+static Rect BruteForceMaxVisibleRegion(const Rect &origRect, const vector<Rect> &overlays)
+{
+    set<int32_t> xs = {origRect.left_, origRect.right_};
+    set<int32_t> ys = {origRect.top_, origRect.bottom_};
+    for (const auto &overlay : overlays) {
+        xs.insert({max(overlay.left_, origRect.left_), min(overlay.right_, origRect.right_)});
+        ys.insert({max(overlay.top_, origRect.top_), min(overlay.bottom_, origRect.bottom_)});
+    }
+    Rect best(0, 0, 0, 0);
+    for (auto left : xs) {
+        for (auto right : xs) {
+            for (auto top : ys) {
+                for (auto bottom : ys) {
+                    Rect rect(left, right, top, bottom);
+                    if (!rect.IsValid() || left < origRect.left_ || right > origRect.right_ ||
+                        top < origRect.top_ || bottom > origRect.bottom_) {
+                        continue;
+                    }
+                    auto covered = any_of(overlays.begin(), overlays.end(), [&rect](const Rect &overlay) {
+                        return RectAlgorithm::CheckIntersectant(rect, overlay);
+                    });
+                    auto better = rect.GetArea() != best.GetArea() ? rect.GetArea() > best.GetArea() :
+                        make_tuple(rect.bottom_, -rect.left_, -rect.top_) > make_tuple(best.bottom_, -best.left_,
+                        -best.top_);
+                    best = !covered && better ? rect : best;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+TEST(RectAlgorithmTest, computeMaxVisibleRegionProperties)
+{
+    constexpr int32_t gridStep = 10;
+    constexpr int32_t gridCount = 40;
+    constexpr size_t caseCount = 300;
+    constexpr size_t maxOverlays = 8;
+    mt19937 random(20250101);
+    auto coordinate = [&random]() {
+        return static_cast<int32_t>(random() % (gridCount + 1)) * gridStep;
+    };
+    auto randomRect = [&coordinate]() {
+        auto x0 = coordinate();
+        auto x1 = coordinate();
+        auto y0 = coordinate();
+        auto y1 = coordinate();
+        return Rect(min(x0, x1), max(x0, x1) + gridStep, min(y0, y1), max(y0, y1) + gridStep);
+    };
+    for (size_t index = 0; index < caseCount; index++) {
+        const auto rect = randomRect();
+        vector<Rect> overlays(random() % (maxOverlays + 1));
+        generate(overlays.begin(), overlays.end(), randomRect);
+        Rect region(0, 0, 0, 0);
+        const auto visible = RectAlgorithm::ComputeMaxVisibleRegion(rect, overlays, region);
+        // the same area as the legacy subtraction, inside the rect and not covered by any overlay
+        const auto legacyArea = LegacyMaxVisibleArea(rect, overlays);
+        ASSERT_EQ(legacyArea, static_cast<int64_t>(region.GetArea())) << "case " << index;
+        ASSERT_EQ(legacyArea > 0, visible);
+        if (visible) {
+            Rect inner(0, 0, 0, 0);
+            ASSERT_TRUE(RectAlgorithm::ComputeIntersection(rect, region, inner));
+            ASSERT_TRUE(RectAlgorithm::CheckEqual(inner, region));
+            for (const auto &overlay : overlays) {
+                ASSERT_FALSE(RectAlgorithm::CheckIntersectant(region, overlay)) << "case " << index;
+            }
+        }
+        // the same rectangle as the exhaustive search among the ties
+        ASSERT_TRUE(RectAlgorithm::CheckEqual(BruteForceMaxVisibleRegion(rect, overlays), region)) << "case " << index;
+    }
+}
+
+TEST(RectAlgorithmTest, visibleRegionSimpleCases)
+{
+    const Rect window(0, 100, 0, 200);
+    VisibleRegion region;
+    region.Reset(window, {Rect(200, 300, 0, 100)});
+    ASSERT_FALSE(region.IsOccluded());
+    Rect out(0, 0, 0, 0);
+    ASSERT_TRUE(region.ComputeMaxVisibleRect(Rect(10, 20, 30, 40, 1), out));
+    ASSERT_TRUE(RectAlgorithm::CheckEqual(out, Rect(10, 20, 30, 40)));
+    ASSERT_EQ(1, out.displayId_);
+    // the part out of the window is invisible
+    ASSERT_TRUE(region.ComputeMaxVisibleRect(Rect(50, 150, 150, 250), out));
+    ASSERT_TRUE(RectAlgorithm::CheckEqual(out, Rect(50, 100, 150, 200)));
+    ASSERT_FALSE(region.ComputeMaxVisibleRect(Rect(150, 250, 0, 100), out));
+    ASSERT_FALSE(region.ComputeMaxVisibleRect(Rect(20, 10, 30, 40), out));
+
+    region.Reset(window, {Rect(0, 100, 0, 50), Rect(0, 40, 50, 200)});
+    ASSERT_TRUE(region.IsOccluded());
+    ASSERT_FALSE(region.ComputeMaxVisibleRect(Rect(0, 30, 0, 100), out));
+    ASSERT_TRUE(RectAlgorithm::CheckEqual(out, Rect(0, 0, 0, 0)));
+    ASSERT_TRUE(region.ComputeMaxVisibleRect(Rect(0, 100, 0, 200, 2), out));
+    ASSERT_TRUE(RectAlgorithm::CheckEqual(out, Rect(40, 100, 50, 200)));
+    ASSERT_EQ(2, out.displayId_);
+
+    region.Reset(Rect(0, 0, 0, 0), {});
+    ASSERT_FALSE(region.ComputeMaxVisibleRect(Rect(0, 10, 0, 10), out));
+}
+
+TEST(RectAlgorithmTest, visibleRegionEquivalence)
+{
+    constexpr int32_t gridStep = 10;
+    constexpr int32_t gridCount = 40;
+    constexpr size_t windowCount = 100;
+    constexpr size_t widgetCount = 50;
+    constexpr size_t maxOverlays = 12;
+    mt19937 random(20250202);
+    auto coordinate = [&random]() {
+        return static_cast<int32_t>(random() % (gridCount + 1)) * gridStep;
+    };
+    auto randomRect = [&coordinate]() {
+        auto x0 = coordinate();
+        auto x1 = coordinate();
+        auto y0 = coordinate();
+        auto y1 = coordinate();
+        return Rect(min(x0, x1), max(x0, x1) + gridStep, min(y0, y1), max(y0, y1) + gridStep);
+    };
+    VisibleRegion region;
+    for (size_t windowIndex = 0; windowIndex < windowCount; windowIndex++) {
+        const auto window = randomRect();
+        vector<Rect> overlays(random() % (maxOverlays + 1));
+        generate(overlays.begin(), overlays.end(), randomRect);
+        region.Reset(window, overlays);
+        vector<Rect> expects;
+        RectArrays batch;
+        for (size_t index = 0; index < widgetCount; index++) {
+            const auto widget = randomRect();
+            // same as the widget clipped by the window and then by the overlays, as the select strategy does
+            Rect expect(0, 0, 0, 0);
+            Rect inWindow(0, 0, 0, 0);
+            if (RectAlgorithm::ComputeIntersection(widget, window, inWindow)) {
+                RectAlgorithm::ComputeMaxVisibleRegion(inWindow, overlays, expect);
+            }
+            Rect out(0, 0, 0, 0);
+            ASSERT_EQ(expect.IsValid(), region.ComputeMaxVisibleRect(widget, out));
+            ASSERT_TRUE(RectAlgorithm::CheckEqual(expect, out)) << "window " << windowIndex << " widget " << index;
+            expects.emplace_back(expect);
+            batch.Add(widget);
+        }
+        region.ComputeMaxVisibleRects(batch);
+        ASSERT_EQ(expects.size(), batch.Size());
+        for (size_t index = 0; index < expects.size(); index++) {
+            ASSERT_TRUE(RectAlgorithm::CheckEqual(expects[index], batch.Get(index))) << "window " << windowIndex;
+        }
+    }
+}
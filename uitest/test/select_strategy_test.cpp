@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <random>
 #include "gtest/gtest.h"
 
 #include "mock_element_node_iterator.h"
@@ -23,6 +24,7 @@
 #undef protected
 #include "ui_controller.h"
 #include "ui_action.h"
+#include "widget_selector.h"
 
 using namespace OHOS::uitest;
 using namespace std;
@@ -897,3 +899,266 @@ TEST(SelectStrategyTest, findWidgetsInCliperCoveredByWindows)
     ASSERT_EQ(rect1.top_, 80);
     ASSERT_EQ(rect1.bottom_, 90);
 }
+
+static constexpr size_t RANDOM_TREE_SIZE = 120;
+static constexpr size_t RANDOM_MAX_FAN_OUT = 5;
+static const vector<string> RANDOM_TYPES = {"List", "Text", "Button", "Image"};
+static const vector<string> RANDOM_TEXTS = {"One", "Two", "Three"};
+
+static void BuildRandomTree(vector<MockAccessibilityElementInfo> &eles, mt19937 &random, const string &hierarchy,
+    int parentIndex, size_t depth)
+{
+    const int index = eles.size();
+    MockAccessibilityElementInfo ele;
+    ele.accessibilityId = to_string(index);
+    ele.componentType = RANDOM_TYPES[random() % RANDOM_TYPES.size()];
+    ele.content = "Text " + RANDOM_TEXTS[random() % RANDOM_TEXTS.size()];
+    ele.hierarchy = hierarchy;
+    ele.parentIndex = parentIndex;
+    ele.clip = random() % INDEX_FOUR == 0;
+    // some nodes are out of the window or out of the clip of their ancestors
+    const int32_t left = random() % 1200;
+    const int32_t top = random() % 2200;
+    ele.rectInScreen = Rect{left, left + 1 + static_cast<int32_t>(random() % 600), top,
+                            top + 1 + static_cast<int32_t>(random() % 600)};
+    eles.emplace_back(ele);
+    const auto childCount = depth == 0 ? 0 : random() % (RANDOM_MAX_FAN_OUT + 1);
+    for (size_t child = 0; child < childCount && eles.size() < RANDOM_TREE_SIZE; child++) {
+        BuildRandomTree(eles, random, WidgetHierarchyBuilder::Build(hierarchy, child), index, depth - 1);
+    }
+}
+
+static vector<WidgetMatchModel> RandomMatchers(mt19937 &random)
+{
+    auto selector = WidgetSelector();
+    if (random() % TWO == 0) {
+        selector.AddMatcher(WidgetMatchModel(UiAttr::TYPE, RANDOM_TYPES[random() % RANDOM_TYPES.size()], EQ));
+    } else {
+        selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, RANDOM_TEXTS[random() % RANDOM_TEXTS.size()], CONTAINS));
+    }
+    return selector.GetSelfMatchers();
+}
+
+static vector<string> LocateTargetIds(SelectStrategy &strategy, const vector<MockAccessibilityElementInfo> &eles)
+{
+    Window window{12};
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    window.invisibleBoundsVec_.emplace_back(Rect{0, 300, 0, 300});
+    MockElementNodeIterator iterator(eles);
+    vector<Widget> visits;
+    vector<int> targets;
+    DumpOption option;
+    strategy.LocateNode(window, iterator, visits, targets, option);
+    vector<string> ids;
+    for (auto target : targets) {
+        ids.emplace_back(visits.at(target).GetAttr(UiAttr::ACCESSIBILITY_ID));
+    }
+    return ids;
+}
+
+TEST(SelectStrategyTest, planEquivalentToStrategiesOnRandomTrees)
+{
+    static constexpr size_t ROUNDS = 300;
+    static constexpr size_t MAX_DEPTH = 8;
+    mt19937 random(20250601);
+    size_t nonEmpty = 0;
+    for (size_t round = 0; round < ROUNDS; round++) {
+        vector<MockAccessibilityElementInfo> eles;
+        BuildRandomTree(eles, random, "ROOT", -1, MAX_DEPTH);
+        StrategyBuildParam param;
+        param.myselfMatcher = RandomMatchers(random);
+        // one kind of locator for the simple strategies, or mixed ones for the complex strategy
+        const auto kinds = random() % INDEX_EIGHT;
+        const size_t locatorCount = kinds >= INDEX_FIVE ? 1 + random() % TWO : 1;
+        for (size_t locator = 0; locator < locatorCount; locator++) {
+            if (kinds == INDEX_ONE || kinds == INDEX_FIVE || kinds == INDEX_SEVEN) {
+                param.afterAnchorMatcherVec.emplace_back(RandomMatchers(random));
+            }
+            if (kinds == INDEX_TWO || kinds == INDEX_SIX || kinds == INDEX_SEVEN) {
+                param.beforeAnchorMatcherVec.emplace_back(RandomMatchers(random));
+            }
+            if (kinds == INDEX_THREE || kinds >= INDEX_FIVE) {
+                param.withInAnchorMatcherVec.emplace_back(RandomMatchers(random));
+            }
+        }
+        for (auto wantMulti : {false, true}) {
+            auto strategy = SelectStrategy::BuildSelectStrategy(param, wantMulti);
+            auto plan = SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, wantMulti));
+            auto expected = LocateTargetIds(*strategy, eles);
+            auto actual = LocateTargetIds(*plan, eles);
+            if (!wantMulti && expected.size() > 1) {
+                // the after strategy goes on with the next anchors, only the first target is taken for single one
+                expected.resize(1);
+            }
+            ASSERT_EQ(expected, actual) << "round " << round << ", strategy " << strategy->Describe();
+            nonEmpty += expected.empty() ? 0 : 1;
+        }
+    }
+    // the cases should not be trivial
+    ASSERT_GT(nonEmpty, ROUNDS / INDEX_FOUR);
+}
+
+TEST(SelectStrategyTest, planStopsAtFirstTarget)
+{
+    vector<MockAccessibilityElementInfo> eles;
+    mt19937 random(7);
+    BuildRandomTree(eles, random, "ROOT", -1, INDEX_EIGHT);
+    StrategyBuildParam param;
+    param.myselfMatcher = WidgetSelector().GetSelfMatchers();
+    Window window{12};
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    MockElementNodeIterator iterator(eles);
+    vector<Widget> visits;
+    vector<int> targets;
+    DumpOption option;
+    auto plan = SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, false));
+    plan->LocateNode(window, iterator, visits, targets, option);
+    ASSERT_EQ(1, targets.size());
+    // the traversal stops at the first visible widget
+    ASSERT_EQ(targets.at(0) + 1, visits.size());
+    ASSERT_LT(visits.size(), eles.size());
+}
+
+static constexpr int32_t LARGE_TREE_ROWS = 1000;
+static constexpr int32_t LARGE_TREE_ROW_ITEMS = 99;
+
+// 100k nodes: ROOT -> List * 1000 -> Text * 99, the items 10 and 70 of every 10th list are Buttons
+static void BuildLargeTree(vector<MockAccessibilityElementInfo> &eles)
+{
+    MockAccessibilityElementInfo root;
+    root.accessibilityId = "0";
+    root.componentType = "Column";
+    root.rectInScreen = Rect{0, 1200, 0, 2000};
+    eles.emplace_back(root);
+    for (int32_t row = 0; row < LARGE_TREE_ROWS; row++) {
+        MockAccessibilityElementInfo list;
+        const int listIndex = eles.size();
+        list.accessibilityId = to_string(listIndex);
+        list.componentType = "List";
+        list.content = "List " + to_string(row);
+        list.clip = true;
+        list.rectInScreen = Rect{0, 1200, 0, 1000};
+        list.parentIndex = 0;
+        eles.emplace_back(list);
+        for (int32_t item = 0; item < LARGE_TREE_ROW_ITEMS; item++) {
+            MockAccessibilityElementInfo text;
+            text.accessibilityId = to_string(eles.size());
+            const bool isButton = row % 10 == 0 && (item == 10 || item == 70);
+            text.componentType = isButton ? "Button" : "Text";
+            text.content = "Item " + to_string(row) + "-" + to_string(item);
+            // the items below the list are clipped out
+            text.rectInScreen = Rect{0, 1200, item * 20, item * 20 + 20};
+            text.parentIndex = listIndex;
+            eles.emplace_back(text);
+        }
+    }
+}
+
+TEST(SelectStrategyTest, planStreamsLargeTree)
+{
+    vector<MockAccessibilityElementInfo> eles;
+    BuildLargeTree(eles);
+    ASSERT_EQ(1 + LARGE_TREE_ROWS * (1 + LARGE_TREE_ROW_ITEMS), eles.size());
+    Window window{12};
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    DumpOption option;
+    // the last visible item of the last list, under a parent locator
+    StrategyBuildParam param;
+    param.myselfMatcher.emplace_back(UiAttr::TEXT, "Item 999-49", EQ);
+    param.withInAnchorMatcherVec.emplace_back(vector<WidgetMatchModel>{{UiAttr::TEXT, "List 999", EQ}});
+    MockElementNodeIterator iterator(eles);
+    vector<Widget> visits;
+    vector<int> targets;
+    SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, false))->LocateNode(window, iterator,
+        visits, targets, option);
+    ASSERT_EQ(1, targets.size());
+    // only the target is kept
+    ASSERT_EQ(1, visits.size());
+    ASSERT_EQ("Item 999-49", visits.at(targets.at(0)).GetAttr(UiAttr::TEXT));
+    // the items clipped out by the list are not selected
+    param.myselfMatcher.clear();
+    param.myselfMatcher.emplace_back(UiAttr::TEXT, "Item 999-50", EQ);
+    visits.clear();
+    targets.clear();
+    SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, false))->LocateNode(window, iterator,
+        visits, targets, option);
+    ASSERT_TRUE(targets.empty());
+    ASSERT_TRUE(visits.empty());
+    // the materializing strategy gives up at the travel limit
+    auto plain = SelectStrategy::BuildSelectStrategy(param, false);
+    plain->LocateNode(window, iterator, visits, targets, option);
+    ASSERT_TRUE(targets.empty());
+}
+
+TEST(SelectStrategyTest, planStreamsLargeTreeMultiTargets)
+{
+    vector<MockAccessibilityElementInfo> eles;
+    BuildLargeTree(eles);
+    Window window{12};
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    DumpOption option;
+    StrategyBuildParam param;
+    param.myselfMatcher.emplace_back(UiAttr::TYPE, "Button", EQ);
+    MockElementNodeIterator iterator(eles);
+    vector<Widget> visits;
+    vector<int> targets;
+    SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, true))->LocateNode(window, iterator,
+        visits, targets, option);
+    // the visible buttons, the ones below the clip of their list are dropped
+    vector<string> expected;
+    for (const auto &ele : eles) {
+        if (ele.componentType == "Button" && ele.rectInScreen.top_ < 1000) {
+            expected.emplace_back(ele.accessibilityId);
+        }
+    }
+    ASSERT_EQ(LARGE_TREE_ROWS / 10, expected.size());
+    ASSERT_EQ(expected.size(), targets.size());
+    ASSERT_EQ(expected.size(), visits.size());
+    for (size_t index = 0; index < targets.size(); index++) {
+        ASSERT_EQ(expected[index], visits.at(targets[index]).GetAttr(UiAttr::ACCESSIBILITY_ID));
+    }
+}
+
+TEST(SelectStrategyTest, planStreamsDeepTree)
+{
+    static constexpr int32_t DEPTH = 3000;
+    static constexpr int32_t CLIP_DEPTH = 100;
+    // a chain of nested nodes with a clip in the middle, each node also has a leaf sibling of its child
+    vector<MockAccessibilityElementInfo> eles;
+    int parent = -1;
+    for (int32_t depth = 0; depth < DEPTH; depth++) {
+        MockAccessibilityElementInfo node;
+        node.accessibilityId = to_string(eles.size());
+        node.componentType = "Stack";
+        node.content = "Depth " + to_string(depth);
+        node.clip = depth == CLIP_DEPTH;
+        node.rectInScreen = depth == CLIP_DEPTH ? Rect{0, 600, 0, 2000} : Rect{0, 1200, 0, 2000};
+        node.parentIndex = parent;
+        parent = eles.size();
+        eles.emplace_back(node);
+    }
+    // the leaves hang on the deepest node, one inside the clip and one outside of it
+    for (auto left : {0, 800}) {
+        MockAccessibilityElementInfo leaf;
+        leaf.accessibilityId = to_string(eles.size());
+        leaf.componentType = "Button";
+        leaf.rectInScreen = Rect{left, left + 100, 0, 100};
+        leaf.parentIndex = parent;
+        eles.emplace_back(leaf);
+    }
+    Window window{12};
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    DumpOption option;
+    StrategyBuildParam param;
+    param.myselfMatcher.emplace_back(UiAttr::TYPE, "Button", EQ);
+    param.withInAnchorMatcherVec.emplace_back(vector<WidgetMatchModel>{{UiAttr::TEXT, "Depth 1", EQ}});
+    MockElementNodeIterator iterator(eles);
+    vector<Widget> visits;
+    vector<int> targets;
+    SelectStrategy::BuildPlanStrategy(SelectStrategy::CompilePlan(param, true))->LocateNode(window, iterator,
+        visits, targets, option);
+    ASSERT_EQ(1, targets.size());
+    ASSERT_EQ(1, visits.size());
+    ASSERT_EQ(to_string(DEPTH), visits.at(targets.at(0)).GetAttr(UiAttr::ACCESSIBILITY_ID));
+    ASSERT_EQ(Rect(0, 100, 0, 100).Describe(), visits.at(0).GetBounds().Describe());
+}
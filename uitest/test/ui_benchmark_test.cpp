@@ -0,0 +1,1106 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <regex.h>
+#include <set>
+#include "gtest/gtest.h"
+#include "nlohmann/json.hpp"
+#define private public
+#include "frontend_api_handler.h"
+#undef private
+#include "backend_object_table.h"
+#include "frontend_api_tables.h"
+#include "mock_element_node_iterator.h"
+#include "mock_controller.h"
+#include "select_strategy.h"
+#include "ui_driver.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+unique_ptr<PointerMatrix> MockController::touch_event_records_ = nullptr;
+
+// benchmarks over synthetic UI trees, they report the cost and only assert the functional results, they are built
+// in uitest_core_benchmark apart from the unit tests
+static constexpr size_t BENCH_NODE_COUNT = 20000;
+static constexpr size_t BENCH_FAN_OUT = 8;
+static constexpr size_t STRING_SSO_CAPACITY = 15;
+static const vector<string> BENCH_TYPES = {"Column", "Row", "Text", "Button", "Image", "List", "ListItem"};
+
+static void BuildSyntheticSubtree(vector<MockAccessibilityElementInfo> &eles, const string &hierarchy,
+    int parentIndex, size_t count)
+{
+    const auto index = eles.size();
+    MockAccessibilityElementInfo ele;
+    ele.accessibilityId = to_string(index + 1);
+    ele.inspectorKey = "key_" + to_string(index);
+    ele.content = "text_" + to_string(index);
+    ele.componentType = BENCH_TYPES[index % BENCH_TYPES.size()];
+    ele.bundleName = "com.example.benchmark";
+    ele.hierarchy = hierarchy;
+    ele.parentIndex = parentIndex;
+    const auto offset = static_cast<int32_t>(index % 1000);
+    ele.rectInScreen = Rect{offset, offset + 100, offset, offset + 50};
+    eles.emplace_back(ele);
+    auto remain = count - 1;
+    for (size_t child = 0; child < BENCH_FAN_OUT && remain > 0; child++) {
+        auto childCount = (remain + BENCH_FAN_OUT - 1 - child) / (BENCH_FAN_OUT - child);
+        BuildSyntheticSubtree(eles, WidgetHierarchyBuilder::Build(hierarchy, child), index, childCount);
+        remain -= childCount;
+    }
+}
+
+static vector<MockAccessibilityElementInfo> BuildSyntheticTree(size_t count)
+{
+    vector<MockAccessibilityElementInfo> eles;
+    eles.reserve(count);
+    BuildSyntheticSubtree(eles, ROOT_HIERARCHY + "0", -1, count);
+    return eles;
+}
+
+static void LocateAll(const vector<MockAccessibilityElementInfo> &eles, const vector<WidgetMatchModel> &matchers,
+    vector<Widget> &visitWidgets, vector<int> &targets)
+{
+    StrategyBuildParam buildParam;
+    buildParam.myselfMatcher = matchers;
+    auto strategy = SelectStrategy::BuildSelectStrategy(buildParam, true);
+    Window window(12);
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    MockElementNodeIterator iterator(eles);
+    DumpOption option;
+    strategy->LocateNode(window, iterator, visitWidgets, targets, option);
+}
+
+static size_t StringHeapBytes(string_view value)
+{
+    return value.size() > STRING_SSO_CAPACITY ? value.size() + 1 : 0;
+}
+
+TEST(UiBenchmarkTest, widgetStorage20kNodes)
+{
+    auto eles = BuildSyntheticTree(BENCH_NODE_COUNT);
+    ASSERT_EQ(BENCH_NODE_COUNT, eles.size());
+    vector<Widget> visitWidgets;
+    vector<int> targets;
+    auto matchers = vector<WidgetMatchModel>{WidgetMatchModel(UiAttr::TYPE, "Button", EQ)};
+    const auto locateStart = GetCurrentMicroseconds();
+    LocateAll(eles, matchers, visitWidgets, targets);
+    const auto locateCost = GetCurrentMicroseconds() - locateStart;
+    ASSERT_EQ(BENCH_NODE_COUNT, visitWidgets.size());
+    auto buttonCount = count_if(eles.begin(), eles.end(), [](const MockAccessibilityElementInfo &ele) {
+        return ele.componentType == "Button";
+    });
+    ASSERT_EQ(buttonCount, targets.size());
+
+    // the legacy storage keeps every attribute in its own string, besides the hierarchy member
+    size_t legacyBytes = 0;
+    size_t compactBytes = 0;
+    set<string> pooledValues;
+    vector<vector<string>> legacyWidgets;
+    legacyWidgets.reserve(visitWidgets.size());
+    for (const auto &widget : visitWidgets) {
+        vector<string> legacy(UiAttr::MAX + 1);
+        // vptr, hierarchy, attribute vector, bounds, origin bounds and display id
+        legacyBytes += sizeof(void *) + sizeof(string) + sizeof(vector<string>) + INDEX_TWO * sizeof(Rect) +
+            sizeof(int32_t) + legacy.size() * sizeof(string);
+        compactBytes += sizeof(Widget);
+        const auto hierarchyBytes = StringHeapBytes(widget.GetHierarchy());
+        legacyBytes += hierarchyBytes;
+        compactBytes += hierarchyBytes;
+        for (int index = 0; index < UiAttr::MAX; index++) {
+            const auto attr = static_cast<UiAttr>(index);
+            legacy[index] = widget.GetAttr(attr);
+            legacyBytes += StringHeapBytes(legacy[index]);
+            int64_t number = 0;
+            if (attr != UiAttr::HIERARCHY && attr != UiAttr::BOUNDS && !widget.GetIntAttr(attr, number) &&
+                legacy[index] != "true" && legacy[index] != "false" && !legacy[index].empty()) {
+                pooledValues.insert(legacy[index]);
+            }
+        }
+        legacyWidgets.emplace_back(move(legacy));
+    }
+    for (const auto &value : pooledValues) {
+        // hash node with the next pointer and the cached hash code
+        compactBytes += sizeof(string) + INDEX_TWO * sizeof(void *) + StringHeapBytes(value);
+    }
+
+    const auto legacyMatchStart = GetCurrentMicroseconds();
+    size_t legacyMatched = 0;
+    for (const auto &legacy : legacyWidgets) {
+        if (legacy[UiAttr::VISIBLE] == "true" && legacy[UiAttr::TYPE] == "Button") {
+            legacyMatched++;
+        }
+    }
+    const auto legacyMatchCost = GetCurrentMicroseconds() - legacyMatchStart;
+    const auto matchStart = GetCurrentMicroseconds();
+    size_t matched = 0;
+    for (const auto &widget : visitWidgets) {
+        if (widget.IsVisible() && widget.MatchAttr(matchers.front())) {
+            matched++;
+        }
+    }
+    const auto matchCost = GetCurrentMicroseconds() - matchStart;
+    ASSERT_EQ(legacyMatched, matched);
+    ASSERT_EQ(targets.size(), matched);
+
+    const auto legacyCopyStart = GetCurrentMicroseconds();
+    auto legacyCopy = legacyWidgets;
+    const auto legacyCopyCost = GetCurrentMicroseconds() - legacyCopyStart;
+    const auto copyStart = GetCurrentMicroseconds();
+    auto compactCopy = visitWidgets;
+    const auto copyCost = GetCurrentMicroseconds() - copyStart;
+    ASSERT_EQ(legacyCopy.size(), compactCopy.size());
+
+    cout << "nodes: " << visitWidgets.size() << ", locate: " << locateCost << "us" << endl;
+    cout << "memory legacy: " << legacyBytes / visitWidgets.size() << "B/node, compact: "
+         << compactBytes / visitWidgets.size() << "B/node, pooled values: " << pooledValues.size() << endl;
+    cout << "match legacy: " << legacyMatchCost << "us, compact: " << matchCost << "us" << endl;
+    cout << "copy legacy: " << legacyCopyCost << "us, compact: " << copyCost << "us" << endl;
+    ASSERT_LT(compactBytes * TWO, legacyBytes);
+}
+
+// the matching before the compiled patterns are cached, which compiles on every node
+static bool UncachedRegexMatch(const string &pattern, int flags, const string &text)
+{
+    regex_t preg;
+    if (regcomp(&preg, pattern.c_str(), flags) != 0) {
+        return false;
+    }
+    auto ret = regexec(&preg, text.c_str(), 0, nullptr, 0) == 0;
+    regfree(&preg);
+    return ret;
+}
+
+TEST(UiBenchmarkTest, regexSelector20kNodes)
+{
+    auto eles = BuildSyntheticTree(BENCH_NODE_COUNT);
+    vector<Widget> visitWidgets;
+    vector<int> targets;
+    auto matchers = vector<WidgetMatchModel>{
+        WidgetMatchModel(UiAttr::TYPE, "^(Button|Text)$", REG_EXP),
+        WidgetMatchModel(UiAttr::ID, "^KEY_[0-9]*7$", REG_EXP_ICASE),
+        WidgetMatchModel(UiAttr::TEXT, "text_[0-9]+", REG_EXP)};
+    RegexCache::Get().Clear();
+    const auto compileCount = RegexCache::Get().GetCompileCount();
+    const auto locateStart = GetCurrentMicroseconds();
+    LocateAll(eles, matchers, visitWidgets, targets);
+    const auto locateCost = GetCurrentMicroseconds() - locateStart;
+    ASSERT_EQ(BENCH_NODE_COUNT, visitWidgets.size());
+    ASSERT_EQ(matchers.size(), RegexCache::Get().GetCompileCount() - compileCount);
+
+    const vector<int> flags = {REG_EXTENDED, REG_EXTENDED | REG_ICASE, REG_EXTENDED};
+    const vector<UiAttr> attrs = {UiAttr::TYPE, UiAttr::ID, UiAttr::TEXT};
+    const auto uncachedStart = GetCurrentMicroseconds();
+    size_t uncachedMatched = 0;
+    for (const auto &widget : visitWidgets) {
+        bool matched = widget.IsVisible();
+        for (size_t index = 0; index < matchers.size() && matched; index++) {
+            matched = UncachedRegexMatch(matchers[index].attrValue, flags[index], widget.GetAttr(attrs[index]));
+        }
+        uncachedMatched += matched ? 1 : 0;
+    }
+    const auto uncachedCost = GetCurrentMicroseconds() - uncachedStart;
+    const auto cachedStart = GetCurrentMicroseconds();
+    size_t cachedMatched = 0;
+    for (const auto &widget : visitWidgets) {
+        cachedMatched += (widget.IsVisible() && widget.MatchSelector(matchers)) ? 1 : 0;
+    }
+    const auto cachedCost = GetCurrentMicroseconds() - cachedStart;
+    ASSERT_EQ(uncachedMatched, cachedMatched);
+    ASSERT_EQ(targets.size(), cachedMatched);
+    ASSERT_GT(cachedMatched, 0);
+    cout << "regex locate: " << locateCost << "us, matched: " << cachedMatched << endl;
+    cout << "regex match uncached: " << uncachedCost << "us, cached: " << cachedCost << "us" << endl;
+}
+
+struct SyntheticBatchNode {
+    int64_t id;
+    vector<int64_t> childIds;
+};
+
+// nodes batch as fetched from AAMS, in which the children of one node are contiguous
+static vector<SyntheticBatchNode> BuildSyntheticBatch(size_t count)
+{
+    static constexpr int64_t ID_BASE = 1000;
+    vector<SyntheticBatchNode> nodes(count);
+    for (size_t index = 0; index < count; index++) {
+        nodes[index].id = ID_BASE + static_cast<int64_t>(index);
+        for (size_t child = index * BENCH_FAN_OUT + 1; child <= index * BENCH_FAN_OUT + BENCH_FAN_OUT; child++) {
+            if (child < count) {
+                nodes[index].childIds.emplace_back(ID_BASE + static_cast<int64_t>(child));
+            }
+        }
+    }
+    return nodes;
+}
+
+// the traversal before the flat index, which scans the batch for children and keeps the marks in trees
+static void LegacyBatchTraverse(const vector<SyntheticBatchNode> &nodes, vector<string> &order)
+{
+    map<int, int> parents;
+    set<int> visibles;
+    map<int, string> hierarchies;
+    int current = 0;
+    parents.emplace(current, -1);
+    visibles.insert(current);
+    hierarchies.emplace(current, ROOT_HIERARCHY);
+    order.emplace_back(ROOT_HIERARCHY);
+    auto visit = [&](int index, int parent, int slot) {
+        parents.emplace(index, parent);
+        auto hierarchy = WidgetHierarchyBuilder::Build(hierarchies.at(parent), slot);
+        current = index;
+        visibles.insert(index);
+        hierarchies.emplace(index, hierarchy);
+        order.emplace_back(move(hierarchy));
+    };
+    while (true) {
+        bool moved = false;
+        if (!nodes[current].childIds.empty() && visibles.find(current) != visibles.end()) {
+            for (size_t index = current + 1; index < nodes.size() && !moved; index++) {
+                if (nodes[index].id == nodes[current].childIds[0]) {
+                    visit(index, current, 0);
+                    moved = true;
+                }
+            }
+        }
+        auto parent = parents.at(current);
+        auto child = current;
+        while (!moved && parent != -1) {
+            const auto &ids = nodes[parent].childIds;
+            for (size_t slot = 0; slot + 1 < ids.size() && !moved; slot++) {
+                if (ids[slot] == nodes[child].id && ids[slot + 1] == nodes[child + 1].id) {
+                    visit(child + 1, parent, slot + 1);
+                    moved = true;
+                }
+            }
+            child = parent;
+            parent = parents.at(parent);
+        }
+        if (!moved) {
+            break;
+        }
+    }
+}
+
+static void IndexedBatchTraverse(const vector<SyntheticBatchNode> &nodes, vector<string> &order)
+{
+    ElementNodeIndex index;
+    index.Build(
+        nodes.size(), [&nodes](size_t pos) { return nodes[pos].id; },
+        [&nodes](size_t pos) { return static_cast<int32_t>(nodes[pos].childIds.size()); },
+        [&nodes](size_t pos, int32_t slot) { return nodes[pos].childIds[slot]; });
+    vector<string> hierarchies(nodes.size());
+    int32_t current = 0;
+    index.MarkVisited(current, ElementNodeIndex::NO_NODE);
+    hierarchies[current] = ROOT_HIERARCHY;
+    order.emplace_back(ROOT_HIERARCHY);
+    auto visit = [&](int32_t node, int32_t parent, int32_t slot) {
+        index.MarkVisited(node, parent);
+        hierarchies[node] = WidgetHierarchyBuilder::Build(hierarchies[parent], slot);
+        order.emplace_back(hierarchies[node]);
+        current = node;
+    };
+    while (true) {
+        if (index.GetChildCount(current) > 0 && index.IsVisitedAndVisible(current)) {
+            visit(index.GetFirstChild(current), current, 0);
+            continue;
+        }
+        bool moved = false;
+        auto parent = index.GetVisitedParent(current);
+        auto child = current;
+        while (!moved && parent != ElementNodeIndex::NO_NODE) {
+            const auto slot = index.GetChildSlot(parent, child);
+            if (slot != ElementNodeIndex::NO_NODE && slot + 1 < index.GetChildCount(parent)) {
+                visit(child + 1, parent, slot + 1);
+                moved = true;
+            }
+            child = parent;
+            parent = index.GetVisitedParent(parent);
+        }
+        if (!moved) {
+            break;
+        }
+    }
+}
+
+TEST(UiBenchmarkTest, nodeIteratorScaling)
+{
+    static const vector<size_t> scales = {1000, 5000, 10000, 20000, 50000};
+    for (auto scale : scales) {
+        auto nodes = BuildSyntheticBatch(scale);
+        vector<string> legacyOrder;
+        vector<string> indexedOrder;
+        legacyOrder.reserve(scale);
+        indexedOrder.reserve(scale);
+        const auto legacyStart = GetCurrentMicroseconds();
+        LegacyBatchTraverse(nodes, legacyOrder);
+        const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+        const auto indexedStart = GetCurrentMicroseconds();
+        IndexedBatchTraverse(nodes, indexedOrder);
+        const auto indexedCost = GetCurrentMicroseconds() - indexedStart;
+        ASSERT_EQ(scale, indexedOrder.size());
+        ASSERT_EQ(legacyOrder, indexedOrder);
+        cout << "nodes: " << scale << ", traverse legacy: " << legacyCost << "us, indexed: " << indexedCost << "us"
+             << endl;
+    }
+}
+
+// nested scroll containers, each level clips its children and holds some leaves partly out of its bounds
+static void BuildNestedClipTree(vector<MockAccessibilityElementInfo> &eles, const string &hierarchy, int parentIndex,
+    size_t level, size_t depth)
+{
+    static constexpr size_t LEAF_COUNT = 10;
+    static constexpr int32_t LEAF_HEIGHT = 400;
+    const auto index = static_cast<int>(eles.size());
+    const auto offset = static_cast<int32_t>(level);
+    MockAccessibilityElementInfo ele;
+    ele.accessibilityId = to_string(index + 1);
+    ele.componentType = "Scroll";
+    ele.hierarchy = hierarchy;
+    ele.parentIndex = parentIndex;
+    ele.clip = true;
+    ele.rectInScreen = Rect{offset, 1200 - offset, offset * TWO, 2000 - offset};
+    eles.emplace_back(ele);
+    for (size_t leaf = 0; leaf < LEAF_COUNT; leaf++) {
+        MockAccessibilityElementInfo leafEle;
+        leafEle.accessibilityId = to_string(eles.size() + 1);
+        leafEle.componentType = "Text";
+        leafEle.hierarchy = WidgetHierarchyBuilder::Build(hierarchy, leaf);
+        leafEle.parentIndex = index;
+        const auto top = static_cast<int32_t>(leaf) * LEAF_HEIGHT - offset;
+        leafEle.rectInScreen = Rect{0, 1200, top, top + LEAF_HEIGHT};
+        eles.emplace_back(leafEle);
+    }
+    if (level + 1 < depth) {
+        BuildNestedClipTree(eles, WidgetHierarchyBuilder::Build(hierarchy, LEAF_COUNT), index, level + 1, depth);
+    }
+}
+
+TEST(UiBenchmarkTest, deepClipPropagation)
+{
+    static constexpr size_t CLIP_DEPTH = 300;
+    vector<MockAccessibilityElementInfo> eles;
+    BuildNestedClipTree(eles, ROOT_HIERARCHY + "0", -1, 0, CLIP_DEPTH);
+    vector<Widget> visitWidgets;
+    vector<int> targets;
+    auto matchers = vector<WidgetMatchModel>{WidgetMatchModel(UiAttr::TYPE, "Text", EQ)};
+    const auto locateStart = GetCurrentMicroseconds();
+    LocateAll(eles, matchers, visitWidgets, targets);
+    const auto locateCost = GetCurrentMicroseconds() - locateStart;
+    ASSERT_EQ(eles.size(), visitWidgets.size());
+
+    // the propagation before the parent index, which walks the ancestors by hierarchy string
+    const auto legacyStart = GetCurrentMicroseconds();
+    const Rect windowBounds{0, 1200, 0, 2000};
+    map<string, Rect> clipers;
+    vector<Rect> legacyBounds;
+    for (const auto &widget : visitWidgets) {
+        Rect visible{0, 0, 0, 0};
+        bool shown = RectAlgorithm::ComputeIntersection(widget.GetOrigBounds(), windowBounds, visible);
+        auto hier = widget.GetHierarchy();
+        while (shown && WidgetHierarchyBuilder::GetParentWidgetHierarchy(hier) != "") {
+            auto parentHie = WidgetHierarchyBuilder::GetParentWidgetHierarchy(hier);
+            auto find = clipers.find(parentHie);
+            if (find != clipers.end()) {
+                Rect clipped{0, 0, 0, 0};
+                shown = RectAlgorithm::ComputeIntersection(visible, find->second, clipped);
+                visible = clipped;
+            }
+            hier = parentHie;
+        }
+        legacyBounds.emplace_back(shown ? visible : Rect{0, 0, 0, 0});
+        if (widget.GetBoolAttr(UiAttr::CLIP)) {
+            clipers.emplace(widget.GetHierarchy(), widget.GetOrigBounds());
+        }
+    }
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+    size_t visibleCount = 0;
+    for (size_t index = 0; index < visitWidgets.size(); index++) {
+        ASSERT_TRUE(RectAlgorithm::CheckEqual(legacyBounds[index], visitWidgets[index].GetBounds()));
+        visibleCount += visitWidgets[index].IsVisible() ? 1 : 0;
+    }
+    ASSERT_GT(visibleCount, 0);
+    ASSERT_LT(visibleCount, visitWidgets.size());
+    cout << "clip depth: " << CLIP_DEPTH << ", nodes: " << visitWidgets.size() << ", visible: " << visibleCount
+         << endl;
+    cout << "locate with index clips: " << locateCost << "us, legacy clip walk only: " << legacyCost << "us" << endl;
+}
+
+static vector<int> LocateByStrategy(SelectStrategy &strategy, const vector<MockAccessibilityElementInfo> &eles,
+    vector<Widget> &visitWidgets)
+{
+    Window window(12);
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    MockElementNodeIterator iterator(eles);
+    DumpOption option;
+    vector<int> targets;
+    strategy.LocateNode(window, iterator, visitWidgets, targets, option);
+    return targets;
+}
+
+TEST(UiBenchmarkTest, selectPlan20kNodes)
+{
+    auto eles = BuildSyntheticTree(BENCH_NODE_COUNT);
+    StrategyBuildParam param;
+    param.myselfMatcher = {WidgetMatchModel(UiAttr::VISIBLE, "true", EQ), WidgetMatchModel(UiAttr::TYPE, "Text", EQ)};
+    param.afterAnchorMatcherVec = {{WidgetMatchModel(UiAttr::ID, "key_100", EQ)}};
+    param.beforeAnchorMatcherVec = {{WidgetMatchModel(UiAttr::ID, "key_19000", EQ)}};
+    param.withInAnchorMatcherVec = {{WidgetMatchModel(UiAttr::TYPE, "List", EQ)},
+                                    {WidgetMatchModel(UiAttr::TYPE, "Column", EQ)}};
+    const auto plan = SelectStrategy::CompilePlan(param, true);
+    for (auto wantMulti : {true, false}) {
+        vector<Widget> strategyVisits;
+        const auto strategyStart = GetCurrentMicroseconds();
+        auto strategy = SelectStrategy::BuildSelectStrategy(param, wantMulti);
+        auto expected = LocateByStrategy(*strategy, eles, strategyVisits);
+        const auto strategyCost = GetCurrentMicroseconds() - strategyStart;
+        vector<Widget> planVisits;
+        const auto planStart = GetCurrentMicroseconds();
+        auto planStrategy = SelectStrategy::BuildPlanStrategy(wantMulti ? plan :
+            SelectStrategy::CompilePlan(param, false));
+        auto actual = LocateByStrategy(*planStrategy, eles, planVisits);
+        const auto planCost = GetCurrentMicroseconds() - planStart;
+        ASSERT_FALSE(expected.empty());
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t index = 0; index < expected.size(); index++) {
+            ASSERT_EQ(strategyVisits[expected[index]].GetAttr(UiAttr::ACCESSIBILITY_ID),
+                      planVisits[actual[index]].GetAttr(UiAttr::ACCESSIBILITY_ID));
+        }
+        cout << (wantMulti ? "multi" : "single") << " targets: " << actual.size() << ", complex strategy: "
+             << strategyCost << "us, plan: " << planCost << "us, plan visits: " << planVisits.size() << endl;
+    }
+}
+
+static string ReadWholeFile(FILE *file)
+{
+    string content;
+    rewind(file);
+    char buffer[BUFSIZ];
+    for (size_t size = 0; (size = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+        content.append(buffer, size);
+    }
+    return content;
+}
+
+TEST(UiBenchmarkTest, streamDumpLayout20kNodes)
+{
+    auto controller = make_unique<MockController>();
+    Window window(12);
+    window.bounds_ = Rect{0, 1200, 0, 2000};
+    window.bundleName_ = "com.example.benchmark";
+    controller->AddWindowsAndNode(window, BuildSyntheticTree(BENCH_NODE_COUNT));
+    UiDriver::RegisterController(move(controller));
+    UiDriver driver;
+    auto error = ApiCallErr(NO_ERROR);
+
+    // the legacy dump holds the json tree and its whole string before writing
+    auto legacyFile = tmpfile();
+    DumpOption legacyOption;
+    const auto legacyStart = GetCurrentMicroseconds();
+    nlohmann::json layout;
+    driver.DumpUiHierarchy(layout, legacyOption, error);
+    const auto legacyBuildCost = GetCurrentMicroseconds() - legacyStart;
+    auto layoutStr = layout.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+    ASSERT_EQ(layoutStr.size(), fwrite(layoutStr.data(), 1, layoutStr.size(), legacyFile));
+    fflush(legacyFile);
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+    ASSERT_EQ(NO_ERROR, error.code_);
+    const auto legacyHeldBytes = layoutStr.capacity();
+    layout = nullptr;
+    layoutStr.clear();
+    layoutStr.shrink_to_fit();
+
+    auto streamFile = tmpfile();
+    DumpOption streamOption;
+    const auto streamStart = GetCurrentMicroseconds();
+    size_t streamSize = 0;
+    {
+        JsonStreamWriter writer(fileno(streamFile));
+        driver.DumpUiHierarchy(writer, streamOption, error);
+        ASSERT_TRUE(writer.Flush());
+        streamSize = writer.GetSize();
+    }
+    const auto streamCost = GetCurrentMicroseconds() - streamStart;
+    ASSERT_EQ(NO_ERROR, error.code_);
+
+    const auto legacyOutput = ReadWholeFile(legacyFile);
+    const auto streamOutput = ReadWholeFile(streamFile);
+    fclose(legacyFile);
+    fclose(streamFile);
+    ASSERT_EQ(legacyOutput, streamOutput);
+    ASSERT_EQ(streamSize, streamOutput.size());
+    cout << "dump nodes: " << BENCH_NODE_COUNT << ", size: " << streamSize << "B" << endl;
+    cout << "dump legacy: " << legacyCost << "us (tree " << legacyBuildCost << "us), stream: " << streamCost << "us"
+         << endl;
+    cout << "dump output held legacy: " << legacyHeldBytes << "B besides the json tree, stream: "
+         << JsonStreamWriter::DEFAULT_BUFFER_SIZE << "B" << endl;
+    ASSERT_GT(legacyHeldBytes, JsonStreamWriter::DEFAULT_BUFFER_SIZE * TWO);
+}
+
+static bool LegacyHasVisibleChild(const set<string> &visibleWidgetHies, const string &hie)
+{
+    for (auto visibleHie : visibleWidgetHies) {
+        if (visibleHie.find(hie) != string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// the dump before the post-order pass, which scans all the visible hierarchies for each invisible node
+static void LegacyMarshalWidget(vector<Widget> &allWidget, const string &hierarchy, nlohmann::json &dom,
+    const map<string, int> &visitWidgetMap, const map<string, int> &widgetCountMap, const set<string> &visibleHies)
+{
+    auto attrData = nlohmann::json();
+    allWidget.at(visitWidgetMap.at(hierarchy)).WrapperWidgetToJson(attrData, "");
+    auto childrenData = nlohmann::json::array();
+    auto count = widgetCountMap.find(hierarchy);
+    const int childCount = count == widgetCountMap.end() ? 0 : count->second;
+    for (int childIndex = 0, childVisit = 0; childVisit < childCount; ++childIndex) {
+        auto childHierarchy = WidgetHierarchyBuilder::GetChildHierarchy(hierarchy, childIndex);
+        auto child = visitWidgetMap.find(childHierarchy);
+        if (child == visitWidgetMap.end()) {
+            continue;
+        }
+        ++childVisit;
+        if (allWidget.at(child->second).IsVisible() || LegacyHasVisibleChild(visibleHies, childHierarchy)) {
+            auto childData = nlohmann::json();
+            LegacyMarshalWidget(allWidget, childHierarchy, childData, visitWidgetMap, widgetCountMap, visibleHies);
+            childrenData.emplace_back(childData);
+        }
+    }
+    dom["attributes"] = attrData;
+    dom["children"] = childrenData;
+}
+
+static size_t CountJsonNodes(const nlohmann::json &node)
+{
+    size_t count = 1;
+    for (const auto &child : node["children"]) {
+        count += CountJsonNodes(child);
+    }
+    return count;
+}
+
+TEST(UiBenchmarkTest, deepHiddenSubtreesDump)
+{
+    static constexpr size_t HIDDEN_CHAINS = 100;
+    static constexpr size_t CHAIN_DEPTH = 50;
+    static constexpr size_t VISIBLE_LEAVES = 10000;
+    // root has the hidden chains under the first container and the visible leaves under the second one,
+    // only the chains at even positions end with a visible node
+    vector<Widget> allWidget;
+    auto addWidget = [&allWidget](const string &hierarchy, bool visible) {
+        Widget widget(hierarchy);
+        widget.SetAttr(UiAttr::VISIBLE, visible ? "true" : "false");
+        allWidget.push_back(move(widget));
+    };
+    const auto chainsHierarchy = WidgetHierarchyBuilder::GetChildHierarchy(ROOT_HIERARCHY, 0);
+    const auto leavesHierarchy = WidgetHierarchyBuilder::GetChildHierarchy(ROOT_HIERARCHY, 1);
+    addWidget(ROOT_HIERARCHY, true);
+    addWidget(chainsHierarchy, true);
+    for (size_t chain = 0; chain < HIDDEN_CHAINS; chain++) {
+        auto hierarchy = WidgetHierarchyBuilder::GetChildHierarchy(chainsHierarchy, chain);
+        for (size_t depth = 0; depth < CHAIN_DEPTH; depth++) {
+            addWidget(hierarchy, chain % TWO == 0 && depth == CHAIN_DEPTH - 1);
+            hierarchy = WidgetHierarchyBuilder::GetChildHierarchy(hierarchy, 0);
+        }
+    }
+    addWidget(leavesHierarchy, true);
+    for (size_t leaf = 0; leaf < VISIBLE_LEAVES; leaf++) {
+        addWidget(WidgetHierarchyBuilder::GetChildHierarchy(leavesHierarchy, leaf), true);
+    }
+    const size_t expectedNodes = 3 + HIDDEN_CHAINS / TWO * CHAIN_DEPTH + VISIBLE_LEAVES;
+
+    const auto legacyStart = GetCurrentMicroseconds();
+    map<string, int> visitWidgetMap;
+    map<string, int> widgetCountMap;
+    set<string> visibleHies;
+    for (size_t index = 0; index < allWidget.size(); index++) {
+        const auto &hierarchy = allWidget[index].GetHierarchy();
+        visitWidgetMap.emplace(hierarchy, index);
+        widgetCountMap[WidgetHierarchyBuilder::GetParentWidgetHierarchy(hierarchy)]++;
+        if (allWidget[index].IsVisible()) {
+            visibleHies.insert(hierarchy);
+        }
+    }
+    nlohmann::json legacyLayout;
+    LegacyMarshalWidget(allWidget, ROOT_HIERARCHY, legacyLayout, visitWidgetMap, widgetCountMap, visibleHies);
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+
+    const auto dumpStart = GetCurrentMicroseconds();
+    nlohmann::json layout;
+    DumpOption option;
+    DumpHandler::DumpWindowInfoToJson(option, allWidget, layout);
+    const auto dumpCost = GetCurrentMicroseconds() - dumpStart;
+    const auto dumpNodes = CountJsonNodes(layout);
+    const auto legacyNodes = CountJsonNodes(legacyLayout);
+    ASSERT_EQ(expectedNodes, dumpNodes);
+    // the legacy substring scan also keeps the hidden chains whose hierarchy is a prefix of a visible one
+    ASSERT_GE(legacyNodes, dumpNodes);
+    cout << "hidden chains: " << HIDDEN_CHAINS << "x" << CHAIN_DEPTH << ", visible leaves: " << VISIBLE_LEAVES
+         << ", dumped nodes: " << dumpNodes << " (legacy " << legacyNodes << ")" << endl;
+    cout << "dump legacy: " << legacyCost << "us, with post-order pass: " << dumpCost << "us" << endl;
+}
+
+// the subtraction before the banded sweep, gives up once the fragments exceed the limit as they blow up
+static bool LegacyMaxVisibleRegion(const Rect &origRect, const vector<Rect> &overlays, size_t maxFragments,
+    Rect &out, size_t &peakFragments)
+{
+    vector<Rect> current = {origRect};
+    peakFragments = 1;
+    for (auto obstacle : overlays) {
+        vector<Rect> next;
+        for (auto rect : current) {
+            Rect intersection(0, 0, 0, 0);
+            if (!RectAlgorithm::ComputeIntersection(rect, obstacle, intersection)) {
+                next.push_back(rect);
+                continue;
+            }
+            if (intersection.bottom_ < rect.bottom_) {
+                next.push_back(Rect(rect.left_, rect.right_, intersection.bottom_, rect.bottom_));
+            }
+            if (rect.top_ < intersection.top_) {
+                next.push_back(Rect(rect.left_, rect.right_, rect.top_, intersection.top_));
+            }
+            if (rect.left_ < intersection.left_) {
+                next.push_back(Rect(rect.left_, intersection.left_, rect.top_, rect.bottom_));
+            }
+            if (intersection.right_ < rect.right_) {
+                next.push_back(Rect(intersection.right_, rect.right_, rect.top_, rect.bottom_));
+            }
+        }
+        current = next;
+        peakFragments = max(peakFragments, current.size());
+        if (current.size() > maxFragments) {
+            return false;
+        }
+    }
+    out = Rect(0, 0, 0, 0);
+    for (auto rect : current) {
+        if (rect.IsValid() && rect.GetArea() > out.GetArea()) {
+            out = rect;
+        }
+    }
+    return true;
+}
+
+TEST(UiBenchmarkTest, occlusionManyOverlays)
+{
+    static constexpr size_t MAX_LEGACY_FRAGMENTS = 2000000;
+    static constexpr int32_t SCREEN_WIDTH = 1260;
+    static constexpr int32_t SCREEN_HEIGHT = 2720;
+    static constexpr int32_t MIN_OVERLAY_SIZE = 80;
+    static constexpr int32_t MAX_OVERLAY_SIZE = 400;
+    const Rect window(0, SCREEN_WIDTH, 0, SCREEN_HEIGHT);
+    // floating windows, bubbles and toasts scattered over the window, many of them overlapping each other
+    srand(0);
+    vector<Rect> overlays;
+    for (size_t index = 0; index < 60; index++) {
+        const auto width = MIN_OVERLAY_SIZE + rand() % (MAX_OVERLAY_SIZE - MIN_OVERLAY_SIZE);
+        const auto height = MIN_OVERLAY_SIZE + rand() % (MAX_OVERLAY_SIZE - MIN_OVERLAY_SIZE);
+        const auto left = rand() % (SCREEN_WIDTH - width);
+        const auto top = rand() % (SCREEN_HEIGHT - height);
+        overlays.emplace_back(left, left + width, top, top + height);
+    }
+    // the small overlays in a lattice split each fragment around them, which multiplies the fragments
+    static constexpr int32_t LATTICE_SIZE = 8;
+    static constexpr int32_t LATTICE_CELL = 40;
+    vector<Rect> lattice;
+    for (int32_t row = 0; row < LATTICE_SIZE; row++) {
+        for (int32_t column = 0; column < LATTICE_SIZE; column++) {
+            const auto left = (column + 1) * SCREEN_WIDTH / (LATTICE_SIZE + 1);
+            const auto top = (row + 1) * SCREEN_HEIGHT / (LATTICE_SIZE + 1);
+            lattice.emplace_back(left, left + LATTICE_CELL, top, top + LATTICE_CELL);
+        }
+    }
+    vector<vector<Rect>> scenes;
+    for (size_t count : {10, 20, 30, 40, 50, 60}) {
+        scenes.emplace_back(overlays.begin(), overlays.begin() + count);
+    }
+    for (size_t count : {16, 32, 64}) {
+        scenes.emplace_back(lattice.begin(), lattice.begin() + count);
+    }
+    for (const auto &subset : scenes) {
+        const auto count = subset.size();
+        Rect region(0, 0, 0, 0);
+        const auto sweepStart = GetCurrentMicroseconds();
+        RectAlgorithm::ComputeMaxVisibleRegion(window, subset, region);
+        const auto sweepCost = GetCurrentMicroseconds() - sweepStart;
+        Rect legacyRegion(0, 0, 0, 0);
+        size_t peakFragments = 0;
+        const auto legacyStart = GetCurrentMicroseconds();
+        const auto legacyDone = LegacyMaxVisibleRegion(window, subset, MAX_LEGACY_FRAGMENTS, legacyRegion,
+            peakFragments);
+        const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+        if (legacyDone) {
+            ASSERT_EQ(legacyRegion.GetArea(), region.GetArea());
+        }
+        for (const auto &overlay : subset) {
+            ASSERT_FALSE(RectAlgorithm::CheckIntersectant(region, overlay));
+        }
+        cout << "overlays: " << count << ", visible area: " << region.GetArea() << ", sweep: " << sweepCost
+             << "us, legacy: " << legacyCost << "us with " << peakFragments << " fragments"
+             << (legacyDone ? "" : " (given up)") << endl;
+    }
+}
+
+TEST(UiBenchmarkTest, widgetVisibilityManyWidgets)
+{
+    static constexpr size_t WIDGET_COUNT = 10000;
+    static constexpr int32_t SCREEN_WIDTH = 1260;
+    static constexpr int32_t SCREEN_HEIGHT = 2720;
+    static constexpr int32_t MAX_WIDGET_SIZE = 600;
+    const Rect window(0, SCREEN_WIDTH, 0, SCREEN_HEIGHT);
+    srand(0);
+    vector<Rect> widgets;
+    for (size_t index = 0; index < WIDGET_COUNT; index++) {
+        const auto width = 1 + rand() % MAX_WIDGET_SIZE;
+        const auto height = 1 + rand() % MAX_WIDGET_SIZE;
+        const auto left = rand() % (SCREEN_WIDTH - width);
+        const auto top = rand() % (SCREEN_HEIGHT - height);
+        widgets.emplace_back(left, left + width, top, top + height);
+    }
+    // status bar, navigation bar, a floating window, a bubble and a toast over the window, then more floating ones
+    vector<Rect> overlays = {Rect(0, SCREEN_WIDTH, 0, 120), Rect(0, SCREEN_WIDTH, 2600, SCREEN_HEIGHT),
+        Rect(700, 1200, 900, 1800), Rect(100, 500, 400, 560), Rect(300, 960, 2300, 2420)};
+    for (size_t count : {5, 15, 30}) {
+        while (overlays.size() < count) {
+            const auto left = rand() % (SCREEN_WIDTH - MAX_WIDGET_SIZE);
+            const auto top = rand() % (SCREEN_HEIGHT - MAX_WIDGET_SIZE);
+            overlays.emplace_back(left, left + 1 + rand() % MAX_WIDGET_SIZE, top, top + 1 + rand() % MAX_WIDGET_SIZE);
+        }
+        vector<Rect> legacyResults(WIDGET_COUNT);
+        const auto legacyStart = GetCurrentMicroseconds();
+        for (size_t index = 0; index < WIDGET_COUNT; index++) {
+            RectAlgorithm::ComputeMaxVisibleRegion(widgets[index], overlays, legacyResults[index]);
+        }
+        const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+        const auto regionStart = GetCurrentMicroseconds();
+        VisibleRegion region;
+        region.Reset(window, overlays);
+        vector<Rect> regionResults(WIDGET_COUNT);
+        for (size_t index = 0; index < WIDGET_COUNT; index++) {
+            region.ComputeMaxVisibleRect(widgets[index], regionResults[index]);
+        }
+        const auto regionCost = GetCurrentMicroseconds() - regionStart;
+        RectArrays batch;
+        for (const auto &widget : widgets) {
+            batch.Add(widget);
+        }
+        const auto batchStart = GetCurrentMicroseconds();
+        region.Reset(window, overlays);
+        region.ComputeMaxVisibleRects(batch);
+        const auto batchCost = GetCurrentMicroseconds() - batchStart;
+        size_t visibleCount = 0;
+        for (size_t index = 0; index < WIDGET_COUNT; index++) {
+            ASSERT_TRUE(RectAlgorithm::CheckEqual(legacyResults[index], regionResults[index]));
+            ASSERT_TRUE(RectAlgorithm::CheckEqual(legacyResults[index], batch.Get(index)));
+            visibleCount += legacyResults[index].IsValid() ? 1 : 0;
+        }
+        cout << "widgets: " << WIDGET_COUNT << ", overlays: " << count << ", visible: " << visibleCount
+             << ", per widget: " << legacyCost << "us, region: " << regionCost << "us, batch: " << batchCost << "us"
+             << endl;
+    }
+}
+
+// the recorder's former lookup, a linear scan of all the widgets preferring the longer hierarchy
+static const Widget *LegacyFindWidgetAt(const vector<Widget> &widgets, const Point &point)
+{
+    size_t maxDepth = 0;
+    const Widget *found = nullptr;
+    for (const auto &widget : widgets) {
+        const auto rect = widget.GetBounds();
+        if (!(point.px_ <= rect.right_ && point.px_ >= rect.left_ && point.py_ <= rect.bottom_ &&
+            point.py_ >= rect.top_)) {
+            continue;
+        }
+        const auto depth = widget.GetHierarchy().length();
+        if (depth > maxDepth) {
+            maxDepth = depth;
+            found = &widget;
+        }
+    }
+    return found;
+}
+
+TEST(UiBenchmarkTest, findWidgetAtManyWidgets)
+{
+    static constexpr size_t WIDGET_COUNT = 10000;
+    static constexpr size_t LOOKUP_COUNT = 10000;
+    static constexpr int32_t SCREEN_WIDTH = 1260;
+    static constexpr int32_t SCREEN_HEIGHT = 2720;
+    static constexpr int32_t MAX_DEPTH = 16;
+    srand(0);
+    vector<Widget> widgets;
+    WidgetSpatialIndex index;
+    for (size_t order = 0; order < WIDGET_COUNT; order++) {
+        const auto depth = rand() % MAX_DEPTH;
+        // the deeper widgets are smaller, as the nested ones are
+        const auto maxSize = SCREEN_WIDTH / (depth + 1);
+        const auto width = 1 + rand() % maxSize;
+        const auto height = 1 + rand() % maxSize;
+        const auto left = rand() % (SCREEN_WIDTH - width + 1);
+        const auto top = rand() % (SCREEN_HEIGHT - height + 1);
+        Widget widget(string(ROOT_HIERARCHY) + string(depth * TWO, ','));
+        widget.SetBounds(Rect(left, left + width, top, top + height));
+        widget.SetNodePosition(static_cast<int32_t>(order), -1, depth);
+        widgets.emplace_back(move(widget));
+    }
+    vector<Point> points;
+    for (size_t lookup = 0; lookup < LOOKUP_COUNT; lookup++) {
+        points.emplace_back(rand() % SCREEN_WIDTH, rand() % SCREEN_HEIGHT);
+    }
+    const auto buildStart = GetCurrentMicroseconds();
+    for (const auto &widget : widgets) {
+        index.Add(widget, 0);
+    }
+    index.Build();
+    const auto buildCost = GetCurrentMicroseconds() - buildStart;
+    size_t hits = 0;
+    const auto indexStart = GetCurrentMicroseconds();
+    for (const auto &point : points) {
+        hits += index.Find(point) != nullptr ? 1 : 0;
+    }
+    const auto indexCost = GetCurrentMicroseconds() - indexStart;
+    vector<const Widget *> legacyFounds;
+    const auto legacyStart = GetCurrentMicroseconds();
+    for (const auto &point : points) {
+        legacyFounds.emplace_back(LegacyFindWidgetAt(widgets, point));
+    }
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+    for (size_t lookup = 0; lookup < LOOKUP_COUNT; lookup++) {
+        // both pick one of the deepest widgets at the point
+        const auto found = legacyFounds[lookup];
+        const auto widget = index.Find(points[lookup]);
+        ASSERT_EQ(found == nullptr, widget == nullptr);
+        if (found != nullptr) {
+            ASSERT_EQ(found->GetDepth(), widget->GetDepth());
+        }
+    }
+    cout << "widgets: " << WIDGET_COUNT << ", lookups: " << LOOKUP_COUNT << ", hits: " << hits << ", index build: "
+         << buildCost << "us, index lookups: " << indexCost << "us, linear scans: " << legacyCost << "us" << endl;
+}
+
+// the former signature table of FrontendApiServer, parsed on the first call and keyed by the api name
+struct LegacyApiMethod {
+    vector<string> paramTypes_;
+    size_t defaultArgCount_ = 0;
+};
+
+static void LegacyParseSignatures(multimap<string, LegacyApiMethod> &methods)
+{
+    for (auto classDef : FRONTEND_CLASS_DEFS) {
+        for (size_t idx = 0; idx < classDef->methodCount_; idx++) {
+            const auto &methodDef = classDef->methods_[idx];
+            const auto signature = methodDef.signature_;
+            LegacyApiMethod method;
+            string token;
+            bool isArray = false;
+            for (size_t index = 0; index < signature.length(); index++) {
+                const char ch = signature[index];
+                if (isalpha(ch)) {
+                    token.push_back(ch);
+                } else if (ch == '[') {
+                    isArray = true;
+                } else if (ch == '?') {
+                    method.defaultArgCount_++;
+                } else if (ch == ',' || ch == ')') {
+                    if (!token.empty()) {
+                        method.paramTypes_.emplace_back(isArray ? "[" + token + "]" : token);
+                    }
+                    token.clear();
+                    isArray = false;
+                    if (ch == ')') {
+                        method.paramTypes_.emplace_back(signature.substr(index + TWO));
+                        break;
+                    }
+                }
+            }
+            methods.insert(make_pair(string(methodDef.name_), method));
+        }
+    }
+}
+
+// the former argument check, resolving the type by name and copying the json object to find extra properties
+static void LegacyCheckCallArg(string_view expect, const nlohmann::json &value, bool isDefArg, ApiCallErr &error)
+{
+    using nlohmann::detail::value_t;
+    const auto type = value.type();
+    if (isDefArg && type == value_t::null) {
+        return;
+    }
+    if (expect.length() > TWO && expect.front() == '[' && expect.back() == ']') {
+        for (size_t idx = 0; idx < value.size() && error.code_ == NO_ERROR; idx++) {
+            LegacyCheckCallArg(expect.substr(1, expect.length() - TWO), value.at(idx), false, error);
+        }
+        return;
+    }
+    const auto isInteger = type == value_t::number_integer || type == value_t::number_unsigned;
+    auto find0 = find_if(FRONTEND_CLASS_DEFS.begin(), FRONTEND_CLASS_DEFS.end(),
+        [&expect](const FrontEndClassDef *def) { return def->name_ == expect; });
+    auto find1 = find_if(FRONTEND_JSON_DEFS.begin(), FRONTEND_JSON_DEFS.end(),
+        [&expect](const FrontEndJsonDef *def) { return def->name_ == expect; });
+    if (expect == "int") {
+        error.code_ = isInteger && atoi(value.dump().c_str()) >= 0 ? NO_ERROR : ERR_INVALID_INPUT;
+    } else if (find0 != FRONTEND_CLASS_DEFS.end()) {
+        error.code_ = type == value_t::string ? NO_ERROR : ERR_INVALID_INPUT;
+    } else if (find1 != FRONTEND_JSON_DEFS.end()) {
+        if (type != value_t::object) {
+            error.code_ = ERR_INVALID_INPUT;
+            return;
+        }
+        auto copy = value;
+        for (size_t idx = 0; idx < (*find1)->propCount_ && error.code_ == NO_ERROR; idx++) {
+            const auto def = (*find1)->props_ + idx;
+            const auto propName = string(def->name_);
+            if (!value.contains(propName)) {
+                error.code_ = def->required_ ? ERR_INVALID_INPUT : NO_ERROR;
+                continue;
+            }
+            copy.erase(propName);
+            LegacyCheckCallArg(def->type_, value[propName], !def->required_, error);
+        }
+        error.code_ = error.code_ == NO_ERROR && !copy.empty() ? ERR_INVALID_INPUT : error.code_;
+    }
+}
+
+static void LegacyApiCall(const map<string, ApiInvokeHandler> &handlers,
+    const multimap<string, LegacyApiMethod> &methods, const ApiCallInfo &in, ApiReplyInfo &out)
+{
+    auto call = in;
+    auto handler = handlers.find(call.apiId_);
+    if (handler == handlers.end()) {
+        out.exception_ = ApiCallErr(ERR_INTERNAL, "No handler found");
+        return;
+    }
+    const auto [begin, end] = methods.equal_range(call.apiId_);
+    for (auto method = begin; method != end; method++) {
+        out.exception_ = ApiCallErr(NO_ERROR);
+        const auto &types = method->second.paramTypes_;
+        const auto argc = call.paramList_.size();
+        const auto minArgc = types.size() - 1 - method->second.defaultArgCount_;
+        if (argc > types.size() - 1 || argc < minArgc) {
+            out.exception_ = ApiCallErr(ERR_INVALID_INPUT, "Illegal argument count");
+            continue;
+        }
+        for (size_t idx = 0; idx < argc && out.exception_.code_ == NO_ERROR; idx++) {
+            LegacyCheckCallArg(types.at(idx), call.paramList_.at(idx), idx >= minArgc, out.exception_);
+        }
+        if (out.exception_.code_ == NO_ERROR) {
+            break;
+        }
+    }
+    if (out.exception_.code_ == NO_ERROR) {
+        handler->second(call, out);
+    }
+}
+
+TEST(UiBenchmarkTest, frontendApiCallNoopHandler)
+{
+    static constexpr size_t CALL_COUNT = 100000;
+    static constexpr string_view API_ID = "Driver.swipe";
+    auto &server = FrontendApiServer::Get();
+    size_t handled = 0;
+    const ApiInvokeHandler noop = [&handled](const ApiCallInfo &in, ApiReplyInfo &out) { handled++; };
+    auto create = ApiCallInfo {.apiId_ = "Driver.create"};
+    auto created = ApiReplyInfo();
+    server.Call(create, created);
+    ASSERT_EQ(NO_ERROR, created.exception_.code_);
+    // the second overload (Point,Point,int?) matches, the first one fails on the argument count
+    auto call = ApiCallInfo {.apiId_ = string(API_ID), .callerObjRef_ = created.resultValue_.get<string>()};
+    call.paramList_.emplace_back(nlohmann::json {{"x", 100}, {"y", 200}});
+    call.paramList_.emplace_back(nlohmann::json {{"x", 300}, {"y", 400}, {"displayId", 0}});
+    call.paramList_.emplace_back(600);
+    const auto method = FindFrontendApi(API_ID);
+    ASSERT_NE(NO_API_METHOD, method);
+    auto original = move(server.apiHandlers_[method]);
+    server.apiHandlers_[method] = noop;
+    const auto serverStart = GetCurrentMicroseconds();
+    for (size_t index = 0; index < CALL_COUNT; index++) {
+        auto reply = ApiReplyInfo();
+        server.Call(call, reply);
+    }
+    const auto serverCost = GetCurrentMicroseconds() - serverStart;
+    server.apiHandlers_[method] = move(original);
+    ASSERT_EQ(CALL_COUNT, handled);
+
+    multimap<string, LegacyApiMethod> methods;
+    const auto parseStart = GetCurrentMicroseconds();
+    LegacyParseSignatures(methods);
+    const auto parseCost = GetCurrentMicroseconds() - parseStart;
+    map<string, ApiInvokeHandler> handlers;
+    for (const auto &[name, legacyMethod] : methods) {
+        handlers[name] = [](const ApiCallInfo &in, ApiReplyInfo &out) {};
+    }
+    handlers[string(API_ID)] = noop;
+    handled = 0;
+    const auto legacyStart = GetCurrentMicroseconds();
+    for (size_t index = 0; index < CALL_COUNT; index++) {
+        auto reply = ApiReplyInfo();
+        LegacyApiCall(handlers, methods, call, reply);
+    }
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+    ASSERT_EQ(CALL_COUNT, handled);
+    cout << "calls: " << CALL_COUNT << ", tables: " << serverCost << "us, legacy: " << legacyCost
+         << "us, legacy signature parsing: " << parseCost << "us" << endl;
+}
+
+TEST(UiBenchmarkTest, backendObjectLookup)
+{
+    static constexpr size_t OBJECT_COUNT = 10000;
+    static constexpr size_t LOOKUP_ROUNDS = 20;
+    BackendObjectTable table;
+    map<string, unique_ptr<BackendClass>> legacyObjects;
+    const auto ownerRef = table.Store(make_unique<WidgetSelector>());
+    vector<string> refs;
+    vector<string> legacyRefs;
+    for (size_t index = 0; index < OBJECT_COUNT; index++) {
+        auto widget = make_unique<Widget>("ROOT," + to_string(index));
+        widget->SetAttr(UiAttr::TEXT, "text" + to_string(index));
+        legacyRefs.emplace_back("Component#" + to_string(index));
+        legacyObjects[legacyRefs.back()] = make_unique<Widget>(*widget);
+        refs.emplace_back(table.Store(move(widget), ownerRef));
+    }
+    size_t found = 0;
+    const auto tableStart = GetCurrentMicroseconds();
+    for (size_t round = 0; round < LOOKUP_ROUNDS; round++) {
+        const auto epoch = table.BeginCall();
+        for (const auto &ref : refs) {
+            found += table.Find(ref) != nullptr ? 1 : 0;
+        }
+        table.EndCall(epoch);
+    }
+    const auto tableCost = GetCurrentMicroseconds() - tableStart;
+    const auto legacyStart = GetCurrentMicroseconds();
+    for (size_t round = 0; round < LOOKUP_ROUNDS; round++) {
+        for (const auto &ref : legacyRefs) {
+            // the legacy lookup builds a string key from the string_view reference
+            auto find = legacyObjects.find(string(ref));
+            found += find != legacyObjects.end() && find->second != nullptr ? 1 : 0;
+        }
+    }
+    const auto legacyCost = GetCurrentMicroseconds() - legacyStart;
+    ASSERT_EQ(OBJECT_COUNT * LOOKUP_ROUNDS * TWO, found);
+    const auto releaseStart = GetCurrentMicroseconds();
+    ASSERT_EQ(OBJECT_COUNT + 1, table.Release(ownerRef));
+    const auto releaseCost = GetCurrentMicroseconds() - releaseStart;
+    cout << "objects: " << OBJECT_COUNT << ", lookups: " << OBJECT_COUNT * LOOKUP_ROUNDS << ", slab table: "
+         << tableCost << "us, legacy map: " << legacyCost << "us, bulk release: " << releaseCost << "us" << endl;
+}
@@ -12,6 +12,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <thread>
 #include "gtest/gtest.h"
 #include "ui_driver.h"
 #include "ui_model.h"
@@ -1178,4 +1179,559 @@ TEST_F(UiDriverTest, UserSwitch_Count_LoopThroughUsers)
 
         EXPECT_EQ(controller_->GetCurrentUser(), userId);
     }
-}
\ No newline at end of file
+}
+static void AddSnapshotTestWindow(MockController &controller, string_view text)
+{
+    Window win(100);
+    win.displayId_ = 0;
+    win.bounds_ = Rect{0, 100, 0, 120};
+    win.bundleName_ = "com.test.app";
+    MockAccessibilityElementInfo ele;
+    ele.accessibilityId = "1";
+    ele.windowId = "100";
+    ele.content = string(text);
+    ele.rectInScreen = Rect{30, 60, 10, 20};
+    controller.AddWindowsAndNode(win, {ele});
+}
+
+static size_t FindSnapshotTestWidgets(UiDriver &driver, string_view text)
+{
+    auto error = ApiCallErr(NO_ERROR);
+    auto selector = WidgetSelector();
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, string(text), EQ));
+    selector.AddDisplayLocator(0);
+    vector<unique_ptr<Widget>> widgets;
+    driver.FindWidgets(selector, widgets, error, true);
+    return widgets.size();
+}
+
+TEST_F(UiDriverTest, UiSnapshot_ReuseWithoutUiEvent)
+{
+    controller_->SetUiEventTracked(true);
+    AddSnapshotTestWindow(*controller_, "Button");
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(0, FindSnapshotTestWidgets(*driver_, "Text"));
+    // no ui event in between, the windows are fetched only once
+    ASSERT_EQ(1, controller_->GetUiWindowsCount());
+}
+
+TEST_F(UiDriverTest, UiSnapshot_InvalidatedByUiEvent)
+{
+    controller_->SetUiEventTracked(true);
+    AddSnapshotTestWindow(*controller_, "Button");
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    Window win(100);
+    controller_->RemoveWindowsAndNode(win);
+    AddSnapshotTestWindow(*controller_, "Text");
+    // content changed with ui events, the snapshot must not be reused
+    ASSERT_EQ(0, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Text"));
+    ASSERT_EQ(2, controller_->GetUiWindowsCount());
+    controller_->EmitUiEvent();
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Text"));
+    ASSERT_EQ(3, controller_->GetUiWindowsCount());
+}
+
+TEST_F(UiDriverTest, UiSnapshot_InvalidatedByInjection)
+{
+    controller_->SetUiEventTracked(true);
+    AddSnapshotTestWindow(*controller_, "Button");
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    auto error = ApiCallErr(NO_ERROR);
+    driver_->TriggerKey(Back(), opt_, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(2, controller_->GetUiWindowsCount());
+    driver_->PerformTouch(GenericClick(TouchOp::CLICK, Point(10, 10, 0)), opt_, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(3, controller_->GetUiWindowsCount());
+}
+
+TEST_F(UiDriverTest, UiSnapshot_ForceRefresh)
+{
+    controller_->SetUiEventTracked(true);
+    AddSnapshotTestWindow(*controller_, "Button");
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    driver_->InvalidateUiSnapshot();
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(2, controller_->GetUiWindowsCount());
+    // event observation closed, ui changes are invisible to the driver
+    driver_->CloseAamsEvent();
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(3, controller_->GetUiWindowsCount());
+    driver_->OpenAamsEvent();
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(4, controller_->GetUiWindowsCount());
+}
+
+TEST_F(UiDriverTest, UiSnapshot_UntrackedAlwaysRefresh)
+{
+    AddSnapshotTestWindow(*controller_, "Button");
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(1, FindSnapshotTestWidgets(*driver_, "Button"));
+    ASSERT_EQ(2, controller_->GetUiWindowsCount());
+}
+
+TEST_F(UiDriverTest, UiSnapshot_WidgetCurrentUntilUiEvent)
+{
+    AddSnapshotTestWindow(*controller_, "Button");
+    auto error = ApiCallErr(NO_ERROR);
+    auto selector = WidgetSelector();
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "Button", EQ));
+    selector.AddDisplayLocator(0);
+    vector<unique_ptr<Widget>> widgets;
+    driver_->FindWidgets(selector, widgets, error, true);
+    ASSERT_EQ(1, widgets.size());
+    // ui changes are invisible without the events
+    ASSERT_FALSE(driver_->IsWidgetCurrent(*widgets.at(0)));
+    controller_->SetUiEventTracked(true);
+    widgets.clear();
+    driver_->FindWidgets(selector, widgets, error, true);
+    ASSERT_EQ(1, widgets.size());
+    ASSERT_TRUE(driver_->IsWidgetCurrent(*widgets.at(0)));
+    controller_->EmitUiEvent();
+    ASSERT_FALSE(driver_->IsWidgetCurrent(*widgets.at(0)));
+}
+
+TEST_F(UiDriverTest, FindWidgetsBatch)
+{
+    std::string window1NodeJson = R"(
+        {
+            "attributes":{"windowId":"12", "bundleName":"test12", "componentType":"List", "accessibilityId":"1",
+                "content":"Text List", "rectInScreen":"30,60,10,120"},
+            "children":[
+                {"attributes":{"windowId":"12", "bundleName":"test12", "componentType":"Text",
+                    "accessibilityId":"100", "content":"USB", "rectInScreen":"30,60,10,20"}, "children":[]},
+                {"attributes":{"windowId":"12", "bundleName":"test12", "componentType":"Text",
+                    "accessibilityId":"101", "content":"WLAN", "rectInScreen":"30,60,20,30"}, "children":[]}
+            ]
+        }
+    )";
+    std::string window2NodeJson = R"(
+        {
+            "attributes":{"windowId":"123", "bundleName":"test123", "componentType":"List", "accessibilityId":"1",
+                "content":"Text List", "rectInScreen":"30,60,10,120"},
+            "children":[
+                {"attributes":{"windowId":"123", "bundleName":"test123", "componentType":"Text",
+                    "accessibilityId":"200", "content":"NFC", "rectInScreen":"30,60,10,20"}, "children":[]}
+            ]
+        }
+    )";
+    Window w1{12};
+    w1.windowLayer_ = 2;
+    w1.bounds_ = Rect{0, 100, 0, 120};
+    w1.bundleName_ = "test12";
+    controller_->AddWindowsAndNode(w1,
+        MockElementNodeIterator::ConstructIteratorByJson(window1NodeJson)->elementInfoLists_);
+    Window w2{123};
+    w2.windowLayer_ = 4;
+    w2.bounds_ = Rect{0, 100, 0, 120};
+    w2.bundleName_ = "test123";
+    controller_->AddWindowsAndNode(w2,
+        MockElementNodeIterator::ConstructIteratorByJson(window2NodeJson)->elementInfoLists_);
+
+    vector<WidgetSelector> selectors(4);
+    selectors[0].AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    selectors[1].AddMatcher(WidgetMatchModel(UiAttr::TYPE, "Text", EQ));
+    selectors[2].AddMatcher(WidgetMatchModel(UiAttr::TYPE, "Text", EQ));
+    selectors[2].AddAppLocator("test123");
+    selectors[3].AddMatcher(WidgetMatchModel(UiAttr::TEXT, "None", EQ));
+    vector<const WidgetSelector *> selectorRefs;
+    for (auto &selector : selectors) {
+        selector.SetWantMulti(true);
+        selectorRefs.emplace_back(&selector);
+    }
+    auto error = ApiCallErr(NO_ERROR);
+    const auto fetchCount = controller_->GetUiWindowsCount();
+    vector<vector<unique_ptr<Widget>>> batch;
+    driver_->FindWidgetsBatch(selectorRefs, batch, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    // all the selectors are evaluated on one snapshot
+    ASSERT_EQ(fetchCount + 1, controller_->GetUiWindowsCount());
+    ASSERT_EQ(selectors.size(), batch.size());
+    const vector<size_t> expectCounts = {1, 3, 1, 0};
+    for (size_t index = 0; index < selectors.size(); index++) {
+        vector<unique_ptr<Widget>> widgets;
+        driver_->FindWidgets(selectors[index], widgets, error, true);
+        ASSERT_EQ(expectCounts[index], batch[index].size());
+        ASSERT_EQ(widgets.size(), batch[index].size());
+        for (size_t target = 0; target < widgets.size(); target++) {
+            ASSERT_EQ(widgets[target]->GetAttr(UiAttr::HASHCODE), batch[index][target]->GetAttr(UiAttr::HASHCODE));
+        }
+    }
+    ASSERT_EQ("123:200", batch[2][0]->GetAttr(UiAttr::HASHCODE));
+}
+
+TEST_F(UiDriverTest, FetchWindowsConcurrently)
+{
+    constexpr int32_t windowCount = 6;
+    constexpr uint32_t latencyMs = 50;
+    for (int32_t index = 0; index < windowCount; index++) {
+        const auto windowId = std::to_string(index + 1);
+        const auto bundleName = "test" + windowId;
+        std::string nodeJson = R"({"attributes":{"windowId":")" + windowId + R"(", "bundleName":")" + bundleName +
+            R"(", "componentType":"Text", "accessibilityId":"1", "content":"USB", "rectInScreen":"30,60,10,20"},
+            "children":[]})";
+        Window win{index + 1};
+        win.windowLayer_ = index;
+        win.bounds_ = Rect{0, 100, 0, 120};
+        win.bundleName_ = bundleName;
+        controller_->AddWindowsAndNode(win,
+            MockElementNodeIterator::ConstructIteratorByJson(nodeJson)->elementInfoLists_);
+    }
+    controller_->SetFetchLatencyMs(latencyMs);
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    selector.SetWantMulti(true);
+    auto error = ApiCallErr(NO_ERROR);
+    vector<unique_ptr<Widget>> widgets;
+    const auto startMs = GetCurrentMillisecond();
+    driver_->FindWidgets(selector, widgets, error, true);
+    const auto costMs = GetCurrentMillisecond() - startMs;
+    ASSERT_EQ(NO_ERROR, error.code_);
+    // the windows are fetched by the bounded workers together, far less than fetching them one by one
+    ASSERT_LT(costMs, windowCount * latencyMs * 2 / 3);
+    ASSERT_GT(controller_->GetMaxConcurrentFetches(), 1);
+    ASSERT_LE(controller_->GetMaxConcurrentFetches(), static_cast<int32_t>(MAX_FETCH_WORKERS));
+    // the results are still merged in the window order, top layer first
+    ASSERT_EQ(windowCount, widgets.size());
+    for (int32_t index = 0; index < windowCount; index++) {
+        ASSERT_EQ(std::to_string(windowCount - index) + ":1", widgets[index]->GetAttr(UiAttr::HASHCODE));
+    }
+}
+
+TEST_F(UiDriverTest, FetchTopWindowFirstForSingleTarget)
+{
+    constexpr int32_t windowCount = 4;
+    for (int32_t index = 0; index < windowCount; index++) {
+        const auto windowId = std::to_string(index + 1);
+        std::string nodeJson = R"({"attributes":{"windowId":")" + windowId +
+            R"(", "componentType":"Text", "accessibilityId":"1", "content":"USB", "rectInScreen":"30,60,10,20"},
+            "children":[]})";
+        Window win{index + 1};
+        win.windowLayer_ = index;
+        win.bounds_ = Rect{0, 100, 0, 120};
+        controller_->AddWindowsAndNode(win,
+            MockElementNodeIterator::ConstructIteratorByJson(nodeJson)->elementInfoLists_);
+    }
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    auto error = ApiCallErr(NO_ERROR);
+    vector<unique_ptr<Widget>> widgets;
+    driver_->FindWidgets(selector, widgets, error, true);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    // the target is in the top window, no other window is fetched
+    ASSERT_EQ(1, controller_->GetFetchCount());
+    ASSERT_EQ(1, widgets.size());
+    ASSERT_EQ("4:1", widgets[0]->GetAttr(UiAttr::HASHCODE));
+}
+
+TEST_F(UiDriverTest, WaitForWidgetWakesUpOnUiEvent)
+{
+    std::string nodeJson = R"({"attributes":{"windowId":"12", "componentType":"Text", "accessibilityId":"1",
+        "content":"USB", "rectInScreen":"30,60,10,20"}, "children":[]})";
+    Window win{12};
+    win.bounds_ = Rect{0, 100, 0, 120};
+    controller_->SetUiEventTracked(true);
+    const uint32_t eventIntervalMs = 30;
+    // some unrelated ui events, then the target appears
+    std::thread emitter([this, &nodeJson, &win, eventIntervalMs]() {
+        for (auto index = 0; index < THREE; index++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(eventIntervalMs));
+            controller_->EmitUiEvent();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(eventIntervalMs));
+        controller_->AddWindowsAndNode(win,
+            MockElementNodeIterator::ConstructIteratorByJson(nodeJson)->elementInfoLists_);
+    });
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    UiOpArgs opt;
+    opt.waitWidgetMaxMs_ = 3000;
+    auto error = ApiCallErr(NO_ERROR);
+    const auto startMs = GetCurrentMillisecond();
+    auto widget = driver_->WaitForWidget(selector, opt, error);
+    const auto costMs = GetCurrentMillisecond() - startMs;
+    emitter.join();
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_NE(nullptr, widget);
+    ASSERT_EQ("12:1", widget->GetAttr(UiAttr::HASHCODE));
+    // detected right after the event, not on the fallback poll
+    ASSERT_LT(costMs, FOUR * eventIntervalMs + 200);
+    // evaluated once at first and once per event, each time the ui is steady
+    ASSERT_LE(controller_->GetUiWindowsCount(), FIVE);
+    ASSERT_EQ(controller_->GetUiWindowsCount(), controller_->GetWaitForUiSteadyCount());
+}
+
+TEST_F(UiDriverTest, WaitForWidgetDuringTransition)
+{
+    Window win{12};
+    win.bounds_ = Rect{0, 100, 0, 120};
+    MockAccessibilityElementInfo ele;
+    ele.accessibilityId = "1";
+    ele.windowId = "12";
+    ele.content = "USB";
+    controller_->SetUiEventTracked(true);
+    controller_->SetUiSteadyByUiEvents(true);
+    const uint32_t frameIntervalMs = 10;
+    const int32_t frameCount = 20;
+    // the target slides in after the first evaluation, the ui events keep coming until it stops
+    std::thread animator([this, &win, &ele, frameIntervalMs, frameCount]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(frameIntervalMs * frameCount));
+        for (auto frame = 0; frame <= frameCount; frame++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(frameIntervalMs));
+            ele.rectInScreen = Rect{30 + frame, 60 + frame, 10, 20};
+            controller_->RemoveWindowsAndNode(win);
+            controller_->AddWindowsAndNode(win, {ele});
+        }
+    });
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    UiOpArgs opt;
+    opt.waitWidgetMaxMs_ = 3000;
+    opt.uiSteadyThresholdMs_ = 100;
+    auto error = ApiCallErr(NO_ERROR);
+    auto widget = driver_->WaitForWidget(selector, opt, error);
+    animator.join();
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_NE(nullptr, widget);
+    // taken after the transition, not from the first frame it appears in
+    ASSERT_EQ(30 + frameCount, widget->GetBounds().left_);
+}
+
+TEST_F(UiDriverTest, WaitForWidgetWithoutUiEvent)
+{
+    controller_->SetUiEventTracked(true);
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    UiOpArgs opt;
+    opt.waitWidgetMaxMs_ = 1000;
+    auto error = ApiCallErr(NO_ERROR);
+    const auto startMs = GetCurrentMillisecond();
+    auto widget = driver_->WaitForWidget(selector, opt, error);
+    const auto costMs = GetCurrentMillisecond() - startMs;
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(nullptr, widget);
+    ASSERT_GE(costMs, opt.waitWidgetMaxMs_);
+    // only the low rate fallback polls re-evaluate the selector
+    ASSERT_LE(controller_->GetWaitForUiSteadyCount(), FOUR);
+}
+
+TEST_F(UiDriverTest, WaitForWidgetWithSteadyThreshold)
+{
+    WidgetSelector selector;
+    selector.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "USB", EQ));
+    UiOpArgs opt;
+    opt.waitWidgetMaxMs_ = 0;
+    opt.uiSteadyThresholdMs_ = 300;
+    auto error = ApiCallErr(NO_ERROR);
+    ASSERT_EQ(nullptr, driver_->WaitForWidget(selector, opt, error));
+    // the per-call threshold is used to wait for ui steady
+    ASSERT_EQ(1, controller_->GetWaitForUiSteadyCount());
+    ASSERT_EQ(opt.uiSteadyThresholdMs_, controller_->GetLastSteadyThresholdMs());
+}
+
+/**Add a window holding a list, whose items have the texts which need to be escaped or replaced in json.*/
+static void AddDumpWindow(MockController &controller, int32_t windowId, const string &bundleName, int32_t layer)
+{
+    static const vector<string> texts = {"plain", "quote\"back\\slash", "line\nbreak\ttab\x01", "中文文本",
+        "invalid\xff\xfeutf8", "del\x7f"};
+    vector<MockAccessibilityElementInfo> eles(1);
+    const auto top = windowId * 10;
+    eles[0].accessibilityId = to_string(windowId * 100);
+    eles[0].componentType = "List";
+    eles[0].bundleName = bundleName;
+    eles[0].windowId = to_string(windowId);
+    eles[0].hierarchy = "ROOT";
+    eles[0].rectInScreen = Rect{0, 600, top, top + 1000};
+    for (size_t index = 0; index < texts.size(); index++) {
+        MockAccessibilityElementInfo item;
+        item.accessibilityId = to_string(windowId * 100 + index + 1);
+        item.componentType = "Text";
+        item.content = texts[index];
+        item.inspectorKey = "key_" + to_string(index);
+        item.bundleName = bundleName;
+        item.windowId = to_string(windowId);
+        item.hierarchy = WidgetHierarchyBuilder::Build("ROOT", index);
+        item.parentIndex = 0;
+        // the last item is out of the window and skipped
+        const auto itemTop = index + 1 == texts.size() ? top + 2000 : top + static_cast<int32_t>(index) * 100;
+        item.rectInScreen = Rect{0, 600, itemTop, itemTop + 100};
+        eles[0].childIndexVec.emplace_back(eles.size());
+        eles.emplace_back(item);
+    }
+    Window window{windowId};
+    window.windowLayer_ = layer;
+    window.bounds_ = Rect{0, 600, top, top + 1000};
+    window.bundleName_ = bundleName;
+    window.abilityName_ = bundleName + ".MainAbility";
+    window.pagePath_ = "pages/\"Index\"";
+    controller.AddWindowsAndNode(window, eles);
+}
+
+static string DumpLayoutByStream(UiDriver &driver, DumpOption option, size_t bufferSize, ApiCallErr &error)
+{
+    auto file = tmpfile();
+    {
+        JsonStreamWriter writer(fileno(file), bufferSize);
+        driver.DumpUiHierarchy(writer, option, error);
+        EXPECT_TRUE(writer.Flush());
+    }
+    string content;
+    rewind(file);
+    char buffer[BUFSIZ];
+    for (size_t size = 0; (size = fread(buffer, 1, sizeof(buffer), file)) > 0;) {
+        content.append(buffer, size);
+    }
+    fclose(file);
+    return content;
+}
+
+static string DumpLayoutByJson(UiDriver &driver, DumpOption option, ApiCallErr &error)
+{
+    nlohmann::json out;
+    driver.DumpUiHierarchy(out, option, error);
+    return out.dump(-1, ' ', false, nlohmann::detail::error_handler_t::replace);
+}
+
+TEST_F(UiDriverTest, DumpUIByStreamIdentical)
+{
+    AddDumpWindow(*controller_, 12, "com.example.first", 2);
+    AddDumpWindow(*controller_, 13, "com.example.second", 4);
+    controller_->SetHidumperInfo(12, "|->AccessibilityId: 1201\nBackgroundColor: #FF000000\nContent: quote\"\n"
+        "FontColor: #FFFFFFFF\nFontSize: 16.00fp\n|->AccessibilityId: 1202\nFontSize: 12.00fp\n|->");
+    controller_->SetHidumperInfo(13, "|->AccessibilityId: 1300\nContent: 中文\n|->AccessibilityId: 1303\n"
+        "BackgroundColor: #00000000\n|->");
+    vector<DumpOption> options(6);
+    options[1].listWindows_ = true;
+    options[2].bundleName_ = "com.example.second";
+    options[3].windowId_ = "12";
+    options[4].extendedAttrs_ = "uniqueId ";
+    options[5].addExternAttr_ = true;
+    for (size_t index = 0; index < options.size(); index++) {
+        auto jsonError = ApiCallErr(NO_ERROR);
+        const auto expected = DumpLayoutByJson(*driver_, options[index], jsonError);
+        ASSERT_EQ(NO_ERROR, jsonError.code_);
+        // a small buffer flushes many times in the middle of the dump
+        for (size_t bufferSize : {size_t(16), JsonStreamWriter::DEFAULT_BUFFER_SIZE}) {
+            auto error = ApiCallErr(NO_ERROR);
+            ASSERT_EQ(expected, DumpLayoutByStream(*driver_, options[index], bufferSize, error)) << "option " << index;
+            ASSERT_EQ(NO_ERROR, error.code_);
+        }
+    }
+    // the extra attributes are found
+    auto error = ApiCallErr(NO_ERROR);
+    auto layout = nlohmann::json::parse(DumpLayoutByStream(*driver_, options[5], 16, error));
+    ASSERT_EQ(2, layout["children"].size());
+    auto &firstWindow = layout["children"][1];
+    ASSERT_EQ("com.example.first", firstWindow["attributes"]["bundleName"]);
+    ASSERT_EQ("16.00fp", firstWindow["children"][0]["extraAttrs"]["FontSize"]);
+    ASSERT_EQ("quote\"", firstWindow["children"][0]["extraAttrs"]["Content"]);
+    ASSERT_EQ("12.00fp", firstWindow["children"][1]["extraAttrs"]["FontSize"]);
+    ASSERT_EQ("中文", layout["children"][0]["extraAttrs"]["Content"]);
+}
+
+TEST_F(UiDriverTest, DumpUIDiffRoundTrip)
+{
+    vector<DumpOption> options(2);
+    options[1].listWindows_ = true;
+    auto error = ApiCallErr(NO_ERROR);
+    AddDumpWindow(*controller_, 12, "com.example.first", 2);
+    vector<nlohmann::json> bases(options.size());
+    for (size_t index = 0; index < options.size(); index++) {
+        driver_->DumpUiHierarchy(bases[index], options[index], error);
+        ASSERT_EQ(NO_ERROR, error.code_);
+    }
+    AddDumpWindow(*controller_, 13, "com.example.second", 4);
+    for (size_t index = 0; index < options.size(); index++) {
+        nlohmann::json layout;
+        driver_->DumpUiHierarchy(layout, options[index], error);
+        ASSERT_EQ(NO_ERROR, error.code_);
+        ASSERT_NE(bases[index], layout);
+        // the added window in one direction is the removed window in the other
+        for (const auto &[from, to] : {make_pair(&bases[index], &layout), make_pair(&layout, &bases[index])}) {
+            nlohmann::json diff;
+            DumpHandler::DiffLayout(*from, *to, diff, error);
+            ASSERT_EQ(NO_ERROR, error.code_);
+            nlohmann::json rebuilt;
+            DumpHandler::ApplyLayoutDiff(*from, diff, rebuilt, error);
+            ASSERT_EQ(NO_ERROR, error.code_);
+            ASSERT_EQ(*to, rebuilt) << "option " << index;
+        }
+        // an unchanged layout has an empty diff
+        nlohmann::json diff;
+        DumpHandler::DiffLayout(layout, layout, diff, error);
+        ASSERT_EQ(NO_ERROR, error.code_);
+        ASSERT_TRUE(diff["added"].empty() && diff["changed"].empty() && diff["removed"].empty());
+    }
+}
+
+static void AddHitTestWindows(MockController &controller, string_view floatText)
+{
+    // a floating window over the lower right part of the app window
+    Window app(12);
+    app.windowLayer_ = 1;
+    app.bounds_ = Rect{0, 100, 0, 200};
+    app.invisibleBoundsVec_ = {Rect{50, 100, 50, 150}};
+    MockAccessibilityElementInfo appRoot;
+    appRoot.accessibilityId = "1";
+    appRoot.windowId = "12";
+    appRoot.content = "AppRoot";
+    appRoot.rectInScreen = Rect{0, 100, 0, 200};
+    MockAccessibilityElementInfo appText;
+    appText.accessibilityId = "2";
+    appText.windowId = "12";
+    appText.parentIndex = 0;
+    appText.content = "AppText";
+    appText.rectInScreen = Rect{10, 90, 10, 90};
+    appRoot.childIndexVec = {1};
+    controller.AddWindowsAndNode(app, {appRoot, appText});
+    Window floating(13);
+    floating.windowLayer_ = 2;
+    floating.bounds_ = Rect{50, 100, 50, 150};
+    MockAccessibilityElementInfo floatButton;
+    floatButton.accessibilityId = "3";
+    floatButton.windowId = "13";
+    floatButton.content = string(floatText);
+    floatButton.rectInScreen = Rect{50, 100, 50, 150};
+    controller.AddWindowsAndNode(floating, {floatButton});
+}
+
+static string FindTextAt(UiDriver &driver, int32_t x, int32_t y)
+{
+    auto error = ApiCallErr(NO_ERROR);
+    auto widget = driver.FindWidgetAt(Point(x, y), error);
+    EXPECT_EQ(NO_ERROR, error.code_);
+    return widget == nullptr ? "" : widget->GetAttr(UiAttr::TEXT);
+}
+
+TEST_F(UiDriverTest, FindWidgetAtOverlappingWindows)
+{
+    AddHitTestWindows(*controller_, "Float");
+    ASSERT_EQ("Float", FindTextAt(*driver_, 70, 70));
+    ASSERT_EQ("AppText", FindTextAt(*driver_, 20, 20));
+    ASSERT_EQ("AppRoot", FindTextAt(*driver_, 20, 180));
+    ASSERT_EQ("", FindTextAt(*driver_, 150, 150));
+    auto error = ApiCallErr(NO_ERROR);
+    ASSERT_EQ(nullptr, driver_->FindWidgetAt(Point(70, 70, 1), error));
+}
+
+TEST_F(UiDriverTest, FindWidgetAtReusesIndex)
+{
+    controller_->SetUiEventTracked(true);
+    AddHitTestWindows(*controller_, "Float");
+    ASSERT_EQ("Float", FindTextAt(*driver_, 70, 70));
+    ASSERT_EQ("AppText", FindTextAt(*driver_, 20, 20));
+    ASSERT_EQ("Float", FindTextAt(*driver_, 60, 140));
+    // the repeated lookups on the unchanged UI are done on the same snapshot
+    ASSERT_EQ(1, controller_->GetUiWindowsCount());
+    ASSERT_EQ(TWO, controller_->GetFetchCount());
+    controller_->RemoveWindowsAndNode(Window(13));
+    controller_->RemoveWindowsAndNode(Window(12));
+    AddHitTestWindows(*controller_, "Changed");
+    ASSERT_EQ("Changed", FindTextAt(*driver_, 70, 70));
+    ASSERT_EQ(TWO, controller_->GetUiWindowsCount());
+}
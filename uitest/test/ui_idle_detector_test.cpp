@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include "gtest/gtest.h"
+#include "common_utilities_hpp.h"
+#include "ui_idle_detector.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+// tolerated wake-up delay caused by the thread scheduling
+static constexpr uint64_t WAKE_UP_PRECISION_MS = 10;
+
+/**Feed the events at the given offsets(ms) from now in another thread.*/
+static thread FeedEvents(UiIdleDetector &detector, vector<uint32_t> offsetsMs)
+{
+    const auto startMs = GetCurrentMillisecond();
+    return thread([&detector, offsetsMs, startMs]() {
+        for (auto offset : offsetsMs) {
+            this_thread::sleep_until(chrono::steady_clock::time_point(chrono::milliseconds(startMs + offset)));
+            detector.OnUiEvent(GetCurrentMillisecond());
+        }
+    });
+}
+
+TEST(UiIdleDetectorTest, idleAlready)
+{
+    UiIdleDetector detector;
+    detector.OnUiEvent(GetCurrentMillisecond() - 1000);
+    uint64_t latencyMs = 1;
+    const auto startMs = GetCurrentMillisecond();
+    ASSERT_TRUE(detector.WaitIdle(500, 3000, latencyMs));
+    ASSERT_LT(GetCurrentMillisecond() - startMs, WAKE_UP_PRECISION_MS);
+    ASSERT_EQ(0, latencyMs);
+}
+
+TEST(UiIdleDetectorTest, wakeUpAtThreshold)
+{
+    UiIdleDetector detector;
+    const auto eventMs = GetCurrentMillisecond();
+    detector.OnUiEvent(eventMs);
+    uint64_t latencyMs = 0;
+    ASSERT_TRUE(detector.WaitIdle(100, 3000, latencyMs));
+    const auto wakeMs = GetCurrentMillisecond();
+    ASSERT_GE(wakeMs, eventMs + 100);
+    ASSERT_LT(wakeMs, eventMs + 100 + WAKE_UP_PRECISION_MS);
+    ASSERT_LT(latencyMs, WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiIdleDetectorTest, eventsPostponeIdle)
+{
+    UiIdleDetector detector;
+    detector.OnUiEvent(GetCurrentMillisecond());
+    auto feeder = FeedEvents(detector, {40, 80, 120, 160});
+    uint64_t latencyMs = 0;
+    ASSERT_TRUE(detector.WaitIdle(100, 3000, latencyMs));
+    const auto wakeMs = GetCurrentMillisecond();
+    feeder.join();
+    // idle comes exactly the threshold after the last event
+    const auto idleMs = detector.GetLastEventMillis() + 100;
+    ASSERT_GE(wakeMs, idleMs);
+    ASSERT_LT(wakeMs, idleMs + WAKE_UP_PRECISION_MS);
+    ASSERT_LT(latencyMs, WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiIdleDetectorTest, timeoutWhileBusy)
+{
+    UiIdleDetector detector;
+    vector<uint32_t> offsets;
+    for (uint32_t offset = 0; offset <= 400; offset += 20) {
+        offsets.emplace_back(offset);
+    }
+    auto feeder = FeedEvents(detector, offsets);
+    uint64_t latencyMs = 0;
+    const auto startMs = GetCurrentMillisecond();
+    ASSERT_FALSE(detector.WaitIdle(100, 200, latencyMs));
+    const auto costMs = GetCurrentMillisecond() - startMs;
+    feeder.join();
+    ASSERT_GE(costMs, 200);
+    ASSERT_LT(costMs, 200 + WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiIdleDetectorTest, perCallThreshold)
+{
+    UiIdleDetector detector;
+    const auto eventMs = GetCurrentMillisecond();
+    detector.OnUiEvent(eventMs);
+    uint64_t latencyMs = 0;
+    // the shorter threshold is reached first, then the longer one is waited for the same event
+    ASSERT_TRUE(detector.WaitIdle(50, 3000, latencyMs));
+    ASSERT_LT(GetCurrentMillisecond(), eventMs + 50 + WAKE_UP_PRECISION_MS);
+    ASSERT_TRUE(detector.WaitIdle(150, 3000, latencyMs));
+    const auto wakeMs = GetCurrentMillisecond();
+    ASSERT_GE(wakeMs, eventMs + 150);
+    ASSERT_LT(wakeMs, eventMs + 150 + WAKE_UP_PRECISION_MS);
+}
@@ -63,6 +63,57 @@ TEST(REGEXPTestFalse, testRegex)
     ASSERT_EQ(false, matchResultTxt2);
 }
 
+TEST(REGEXPTestCache, testCompileOnce)
+{
+    Widget widget("hierarchy");
+    widget.SetAttr(UiAttr::TEXT, "checkBox1");
+    widget.SetAttr(UiAttr::ACCESSIBILITY_ID, "123");
+    auto &cache = RegexCache::Get();
+    cache.Clear();
+    const auto compileCount = cache.GetCompileCount();
+    auto matcherTxt = WidgetMatchModel(UiAttr::TEXT, "checkBox\\w", ValueMatchPattern::REG_EXP);
+    auto matcherIcase = WidgetMatchModel(UiAttr::TEXT, "^CHECK\\w+$", ValueMatchPattern::REG_EXP_ICASE);
+    auto matcherCase = WidgetMatchModel(UiAttr::TEXT, "^CHECK\\w+$", ValueMatchPattern::REG_EXP);
+    auto matcherInt = WidgetMatchModel(UiAttr::ACCESSIBILITY_ID, "^1[0-9]3$", ValueMatchPattern::REG_EXP);
+    auto matcherInvalid = WidgetMatchModel(UiAttr::TEXT, "check(Box", ValueMatchPattern::REG_EXP);
+    for (auto round = 0; round < 100; round++) {
+        ASSERT_TRUE(widget.MatchAttr(matcherTxt));
+        ASSERT_TRUE(widget.MatchAttr(matcherIcase));
+        ASSERT_FALSE(widget.MatchAttr(matcherCase));
+        ASSERT_TRUE(widget.MatchAttr(matcherInt));
+        ASSERT_FALSE(widget.MatchAttr(matcherInvalid));
+    }
+    // same pattern with different flags is compiled separately, invalid pattern is not compiled again
+    ASSERT_EQ(compileCount + 5, cache.GetCompileCount());
+    ASSERT_EQ(5, cache.Size());
+}
+
+TEST(REGEXPTestCache, testBoundedCapacity)
+{
+    auto &cache = RegexCache::Get();
+    cache.Clear();
+    Widget widget("hierarchy");
+    widget.SetAttr(UiAttr::TEXT, "text_7");
+    const auto total = RegexCache::CAPACITY * 2;
+    for (size_t index = 0; index < total; index++) {
+        auto matcher = WidgetMatchModel(UiAttr::TEXT, "^text_" + to_string(index) + "$", ValueMatchPattern::REG_EXP);
+        ASSERT_EQ(index == 7, widget.MatchAttr(matcher));
+    }
+    ASSERT_EQ(RegexCache::CAPACITY, cache.Size());
+    // the holder keeps the evicted pattern usable
+    auto compiled = cache.Acquire("^text_7$", REG_EXTENDED);
+    const auto compileCount = cache.GetCompileCount();
+    for (size_t index = 0; index < RegexCache::CAPACITY; index++) {
+        cache.Acquire("^other_" + to_string(index) + "$", REG_EXTENDED);
+    }
+    ASSERT_EQ(RegexCache::CAPACITY, cache.Size());
+    ASSERT_TRUE(compiled != nullptr);
+    ASSERT_TRUE(widget.MatchAttr(WidgetMatchModel(UiAttr::TEXT, "^text_7$", ValueMatchPattern::REG_EXP)));
+    ASSERT_EQ(compileCount + RegexCache::CAPACITY + 1, cache.GetCompileCount());
+    cache.Clear();
+    ASSERT_EQ(0, cache.Size());
+}
+
 
 TEST(RectTest, testRectBase)
 {
@@ -144,6 +195,75 @@ TEST(WidgetTest, testClone)
     ASSERT_TRUE(ret->GetAttr(UiAttr::TEXT) == "Camera");
 }
 
+TEST(WidgetTest, testTypedAttributes)
+{
+    Widget widget("hierarchy");
+    widget.SetAttr(UiAttr::VISIBLE, "true");
+    widget.SetAttr(UiAttr::CLICKABLE, "false");
+    widget.SetAttr(UiAttr::ACCESSIBILITY_ID, "-12");
+    widget.SetAttr(UiAttr::HOST_WINDOW_ID, "012");
+    widget.SetIntAttr(UiAttr::ZINDEX, 9223372036854775807);
+    widget.SetAttr(UiAttr::TEXT, "true");
+    // the string values are restored exactly
+    ASSERT_EQ("true", widget.GetAttr(UiAttr::VISIBLE));
+    ASSERT_EQ("false", widget.GetAttr(UiAttr::CLICKABLE));
+    ASSERT_EQ("-12", widget.GetAttr(UiAttr::ACCESSIBILITY_ID));
+    ASSERT_EQ("012", widget.GetAttr(UiAttr::HOST_WINDOW_ID));
+    ASSERT_EQ("9223372036854775807", widget.GetAttr(UiAttr::ZINDEX));
+    ASSERT_EQ("true", widget.GetAttr(UiAttr::TEXT));
+    ASSERT_EQ("", widget.GetAttr(UiAttr::CHECKED));
+    ASSERT_EQ("hierarchy", widget.GetAttr(UiAttr::HIERARCHY));
+    // typed accessors
+    ASSERT_TRUE(widget.IsVisible());
+    ASSERT_FALSE(widget.GetBoolAttr(UiAttr::CLICKABLE));
+    ASSERT_FALSE(widget.GetBoolAttr(UiAttr::CHECKED));
+    int64_t number = 0;
+    ASSERT_TRUE(widget.GetIntAttr(UiAttr::ACCESSIBILITY_ID, number));
+    ASSERT_EQ(-12, number);
+    ASSERT_FALSE(widget.GetIntAttr(UiAttr::HOST_WINDOW_ID, number));
+    // overwrite with values of another type
+    widget.SetAttr(UiAttr::VISIBLE, "unknown");
+    widget.SetAttr(UiAttr::ACCESSIBILITY_ID, "");
+    ASSERT_FALSE(widget.IsVisible());
+    ASSERT_EQ("unknown", widget.GetAttr(UiAttr::VISIBLE));
+    ASSERT_EQ("", widget.GetAttr(UiAttr::ACCESSIBILITY_ID));
+    ASSERT_FALSE(widget.GetIntAttr(UiAttr::ACCESSIBILITY_ID, number));
+    // match on typed values
+    ASSERT_TRUE(widget.MatchAttr(WidgetMatchModel(UiAttr::ZINDEX, "807", ENDS_WITH)));
+    ASSERT_TRUE(widget.MatchAttr(WidgetMatchModel(UiAttr::CLICKABLE, "false", EQ)));
+    widget.SetBounds(Rect(1, 2, 3, 4));
+    ASSERT_EQ("[1,3][2,4]", widget.GetAttr(UiAttr::BOUNDS));
+    ASSERT_TRUE(widget.MatchAttr(WidgetMatchModel(UiAttr::BOUNDS, "^\\[1,3\\]", REG_EXP)));
+}
+
+TEST(WidgetTest, testAttrPool)
+{
+    auto pool = make_shared<AttrStringPool>();
+    Widget widget1("hierarchy1");
+    Widget widget2("hierarchy2");
+    widget1.SetAttr(UiAttr::TYPE, "Button");
+    widget1.SetAttr(UiAttr::BUNDLENAME, "com.example.app");
+    widget1.SetAttrPool(pool);
+    widget2.SetAttrPool(pool);
+    widget2.SetAttr(UiAttr::TYPE, "Button");
+    widget2.SetAttr(UiAttr::BUNDLENAME, "com.example.app");
+    widget2.SetAttr(UiAttr::TEXT, "OK");
+    widget2.SetAttr(UiAttr::ENABLED, "true");
+    // same values are stored once
+    ASSERT_EQ(3, pool->Size());
+    ASSERT_EQ("Button", widget1.GetAttr(UiAttr::TYPE));
+    ASSERT_EQ("com.example.app", widget2.GetAttr(UiAttr::BUNDLENAME));
+    // clone keeps its values after the pool is released
+    auto clone = widget2.Clone(widget2.GetHierarchy());
+    widget1.SetAttrPool(make_shared<AttrStringPool>());
+    widget2.SetAttrPool(make_shared<AttrStringPool>());
+    pool.reset();
+    ASSERT_EQ("OK", clone->GetAttr(UiAttr::TEXT));
+    ASSERT_EQ("Button", clone->GetAttr(UiAttr::TYPE));
+    ASSERT_EQ("Button", widget1.GetAttr(UiAttr::TYPE));
+    ASSERT_EQ("true", clone->GetAttr(UiAttr::ENABLED));
+}
+
 TEST(DumpHandlerTest, DumpWindowInfoToJson_FieldsNotChanged)
 {
     std::vector<Widget> allWidget;
@@ -270,4 +390,190 @@ TEST(DumpHandlerTest, DumpWindowInfoToJson_FieldsNotChanged)
     DumpHandler::DumpWindowInfoToJson(optionWithoutExtended, allWidget, jsonWithoutExtended);
     auto& rootAttrsNoExtended = jsonWithoutExtended["attributes"];
     ASSERT_TRUE(rootAttrsNoExtended.contains("hashcode"));
-}
\ No newline at end of file
+}
+TEST(DumpHandlerTest, DumpWindowInfoToJson_HiddenSubtrees)
+{
+    // hierarchy and visibility, hidden nodes are dumped only if they have visible descendants
+    const vector<pair<string, bool>> nodes = {{"ROOT", true}, {"ROOT,10", true}, {"ROOT,0", false},
+        {"ROOT,0,0", false}, {"ROOT,0,0,0", true}, {"ROOT,0,1", false}, {"ROOT,1", false}, {"ROOT,1,0", false}};
+    std::vector<Widget> allWidget;
+    for (const auto &[hierarchy, visible] : nodes) {
+        Widget widget(hierarchy);
+        widget.SetAttr(UiAttr::ACCESSIBILITY_ID, hierarchy);
+        widget.SetAttr(UiAttr::VISIBLE, visible ? "true" : "false");
+        allWidget.push_back(move(widget));
+    }
+    nlohmann::json rootJson;
+    DumpOption option;
+    DumpHandler::DumpWindowInfoToJson(option, allWidget, rootJson);
+    auto &children = rootJson["children"];
+    // in the order of the positions, "ROOT,1" is not taken as the ancestor of "ROOT,10"
+    ASSERT_EQ(2, children.size());
+    ASSERT_EQ("ROOT,0", children[0]["attributes"]["accessibilityId"]);
+    ASSERT_EQ("ROOT,10", children[1]["attributes"]["accessibilityId"]);
+    ASSERT_EQ(1, children[0]["children"].size());
+    auto &hidden = children[0]["children"][0];
+    ASSERT_EQ("ROOT,0,0", hidden["attributes"]["accessibilityId"]);
+    ASSERT_EQ(1, hidden["children"].size());
+    ASSERT_EQ("ROOT,0,0,0", hidden["children"][0]["attributes"]["accessibilityId"]);
+    ASSERT_EQ(0, children[1]["children"].size());
+}
+
+// hidumper info of a window in the format of "WindowManagerService -a -w <id> -default -lastpage"
+static constexpr std::string_view HIDUMPER_SAMPLE =
+    "WindowName: MainWindow\n"
+    "DisplayId: 0\n"
+    "|-> Stack childSize:1\n"
+    "  | ID: 1\n"
+    "  | AccessibilityId: 1000\n"
+    "  | BackgroundColor: #FFF1F3F5\n"
+    "  |-> Column childSize:2\n"
+    "    | ID: 2\n"
+    "    | AccessibilityId: 1001\n"
+    "    | BackgroundColor: #00000000\n"
+    "    |-> Text childSize:0\n"
+    "      | ID: 3\n"
+    "      | AccessibilityId: 10021\n"
+    "      | BackgroundColor: #00000000\n"
+    "      | Content: Hello World\n"
+    "      | FontColor: #E5000000\n"
+    "      | FontSize: 16.00fp\n"
+    "    |-> Button childSize:1\n"
+    "      | ID: 4\n"
+    "      | AccessibilityId: 1002\n"
+    "      | FontSize: 14.00fp\n"
+    "      | FontColor: #FFFFFFFF\n"
+    "      |-> Text childSize:0\n"
+    "        | ID: 5\n"
+    "        | AccessibilityId: 1003\n"
+    "        | Content: \n"
+    "|-> lastpage end\n";
+
+TEST(DumpHandlerTest, IndexExtraAttrs_CapturedSample)
+{
+    ExtraAttrsIndex index;
+    DumpHandler::IndexExtraAttrs(HIDUMPER_SAMPLE, index);
+    // the node with empty content has no extra attribute
+    ASSERT_EQ(4, index.size());
+    ASSERT_EQ(index.end(), index.find("1003"));
+    const ExtraAttrs expectedText = {{"BackgroundColor", "#00000000"}, {"Content", "Hello World"},
+        {"FontColor", "#E5000000"}, {"FontSize", "16.00fp"}};
+    ASSERT_EQ(expectedText, index.at("10021"));
+    // the attributes out of order are found, keyed by the whole id rather than a prefix of another id
+    const ExtraAttrs expectedButton = {{"FontColor", "#FFFFFFFF"}, {"FontSize", "14.00fp"}};
+    ASSERT_EQ(expectedButton, index.at("1002"));
+    ASSERT_EQ((ExtraAttrs {{"BackgroundColor", "#FFF1F3F5"}}), index.at("1000"));
+}
+
+TEST(DumpHandlerTest, AddExtraAttrs_CapturedSample)
+{
+    auto node = [](const string &windowId, const string &accessibilityId) {
+        nlohmann::json data;
+        data["attributes"]["hostWindowId"] = windowId;
+        data["attributes"]["accessibilityId"] = accessibilityId;
+        data["children"] = nlohmann::json::array();
+        return data;
+    };
+    auto root = node("", "");
+    auto window = node("7", "1000");
+    window["children"].push_back(node("7", "1002"));
+    window["children"].push_back(node("7", "10021"));
+    window["children"].push_back(node("7", "1003"));
+    root["children"].push_back(window);
+    // the same node in the window without hidumper info
+    root["children"].push_back(node("8", "1002"));
+    DumpHandler::AddExtraAttrs(root, {{7, HIDUMPER_SAMPLE}});
+    ASSERT_EQ(0, root.count("extraAttrs"));
+    auto &first = root["children"][0];
+    ASSERT_EQ("#FFF1F3F5", first["extraAttrs"]["BackgroundColor"]);
+    ASSERT_EQ("14.00fp", first["children"][0]["extraAttrs"]["FontSize"]);
+    ASSERT_EQ("Hello World", first["children"][1]["extraAttrs"]["Content"]);
+    ASSERT_EQ(4, first["children"][1]["extraAttrs"].size());
+    ASSERT_EQ(0, first["children"][2].count("extraAttrs"));
+    ASSERT_EQ(0, root["children"][1].count("extraAttrs"));
+}
+
+static nlohmann::json LayoutNode(const string &hashcode, const string &text, vector<nlohmann::json> children = {})
+{
+    nlohmann::json node;
+    node["attributes"]["hashcode"] = hashcode;
+    node["attributes"]["text"] = text;
+    node["children"] = children;
+    return node;
+}
+
+TEST(DumpHandlerTest, LayoutDiffRoundTrip)
+{
+    auto base = LayoutNode("", "", {LayoutNode("1:1", "window", {LayoutNode("1:2", "a"), LayoutNode("1:3", "b"),
+        LayoutNode("1:4", "c", {LayoutNode("1:5", "d")})})});
+    base["children"][0]["children"][0]["extraAttrs"]["FontSize"] = "16.00fp";
+    // reorder the children, change and remove attributes, replace the extraAttrs and move a node to a new parent
+    auto layout = LayoutNode("", "", {LayoutNode("1:1", "window", {LayoutNode("1:3", "b"), LayoutNode("1:2", "a2"),
+        LayoutNode("1:6", "e", {LayoutNode("1:5", "d")})})});
+    layout["children"][0]["children"][0]["extraAttrs"]["Content"] = "b";
+    layout["children"][0]["attributes"].erase("text");
+    nlohmann::json diff;
+    auto error = ApiCallErr(NO_ERROR);
+    DumpHandler::DiffLayout(base, layout, diff, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(1, diff["added"].size());
+    ASSERT_EQ(nlohmann::json::array({"1:5"}), diff["added"]["1:6"]["children"]);
+    ASSERT_EQ(nlohmann::json::array({"1:4"}), diff["removed"]);
+    ASSERT_EQ(nlohmann::json::array({"text"}), diff["changed"]["1:1"]["removedAttributes"]);
+    ASSERT_EQ("a2", diff["changed"]["1:2"]["attributes"]["text"]);
+    ASSERT_TRUE(diff["changed"]["1:2"]["extraAttrs"].is_null());
+    ASSERT_EQ("b", diff["changed"]["1:3"]["extraAttrs"]["Content"]);
+    // the unchanged nodes are not in the diff
+    ASSERT_EQ(0, diff["changed"].count(""));
+    ASSERT_EQ(0, diff["changed"].count("1:5"));
+    nlohmann::json rebuilt;
+    DumpHandler::ApplyLayoutDiff(base, diff, rebuilt, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(layout, rebuilt);
+}
+
+TEST(DumpHandlerTest, LayoutDiffWithLast)
+{
+    nlohmann::json last;
+    nlohmann::json out;
+    auto first = LayoutNode("", "", {LayoutNode("1:1", "a")});
+    DumpHandler::DiffLayoutWithLast(last, first, out);
+    // nothing to diff against on the first capture
+    ASSERT_FALSE(out["diff"].get<bool>());
+    ASSERT_EQ(first, out["layout"]);
+    auto second = LayoutNode("", "", {LayoutNode("1:1", "b")});
+    DumpHandler::DiffLayoutWithLast(last, second, out);
+    ASSERT_TRUE(out["diff"].get<bool>());
+    ASSERT_EQ("b", out["layout"]["changed"]["1:1"]["attributes"]["text"]);
+    // the nodes can not be keyed, the full layout is given and taken as the next base
+    auto third = LayoutNode("", "", {LayoutNode("", "no hashcode")});
+    DumpHandler::DiffLayoutWithLast(last, third, out);
+    ASSERT_FALSE(out["diff"].get<bool>());
+    ASSERT_EQ(third, out["layout"]);
+    ASSERT_EQ(third, last);
+}
+
+TEST(DumpHandlerTest, LayoutDiffInvalid)
+{
+    auto base = LayoutNode("", "", {LayoutNode("1:1", "a"), LayoutNode("1:2", "b")});
+    auto layout = LayoutNode("", "", {LayoutNode("1:1", "a", {LayoutNode("1:1", "duplicated")})});
+    nlohmann::json diff;
+    auto error = ApiCallErr(NO_ERROR);
+    DumpHandler::DiffLayout(base, layout, diff, error);
+    ASSERT_EQ(ERR_INVALID_INPUT, error.code_);
+    error = ApiCallErr(NO_ERROR);
+    DumpHandler::DiffLayout(base, LayoutNode("", "", {LayoutNode("", "no hashcode")}), diff, error);
+    ASSERT_EQ(ERR_INVALID_INPUT, error.code_);
+    // the diff against another base, or with a node referred twice, does not apply
+    error = ApiCallErr(NO_ERROR);
+    DumpHandler::DiffLayout(base, LayoutNode("", "", {LayoutNode("1:2", "b")}), diff, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    nlohmann::json rebuilt;
+    DumpHandler::ApplyLayoutDiff(LayoutNode("", "", {LayoutNode("1:2", "b")}), diff, rebuilt, error);
+    ASSERT_EQ(ERR_INVALID_INPUT, error.code_);
+    ASSERT_TRUE(rebuilt.is_null());
+    diff["changed"]["1:2"]["children"] = nlohmann::json::array({"1:2"});
+    error = ApiCallErr(NO_ERROR);
+    DumpHandler::ApplyLayoutDiff(base, diff, rebuilt, error);
+    ASSERT_EQ(ERR_INVALID_INPUT, error.code_);
+}
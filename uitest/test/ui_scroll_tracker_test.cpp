@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+#include "gtest/gtest.h"
+#include "common_utilities_hpp.h"
+#include "ui_scroll_tracker.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+// tolerated wake-up delay caused by the thread scheduling
+static constexpr uint64_t WAKE_UP_PRECISION_MS = 10;
+static constexpr uint32_t SCROLL_TIMEOUT_MS = 10000;
+static constexpr int32_t WINDOW_ID = 12;
+
+/**Fake scroll event source, each event is fired at its offset(ms) from now, true for start and false for end.*/
+static thread FireScrollEvents(UiScrollTracker &tracker, vector<pair<uint32_t, bool>> events, uint64_t &lastEndMs,
+    int32_t windowId = WINDOW_ID)
+{
+    const auto startMs = GetCurrentMillisecond();
+    return thread([&tracker, events, startMs, &lastEndMs, windowId]() {
+        for (const auto &[offset, isStart] : events) {
+            this_thread::sleep_until(chrono::steady_clock::time_point(chrono::milliseconds(startMs + offset)));
+            const auto eventMs = GetCurrentMillisecond();
+            if (isStart) {
+                tracker.OnScrollStart(eventMs, windowId);
+            } else {
+                lastEndMs = eventMs;
+                tracker.OnScrollEnd(eventMs, windowId);
+            }
+        }
+    });
+}
+
+TEST(UiScrollTrackerTest, noScroll)
+{
+    UiScrollTracker tracker;
+    const auto startMs = GetCurrentMillisecond();
+    ASSERT_TRUE(tracker.WaitScrollComplete(SCROLL_TIMEOUT_MS, 0));
+    ASSERT_LT(GetCurrentMillisecond() - startMs, WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, wakeUpOnScrollEnd)
+{
+    UiScrollTracker tracker;
+    tracker.OnScrollStart(GetCurrentMillisecond(), WINDOW_ID);
+    uint64_t lastEndMs = 0;
+    auto source = FireScrollEvents(tracker, {{60, false}}, lastEndMs);
+    ASSERT_TRUE(tracker.WaitScrollComplete(SCROLL_TIMEOUT_MS, 0));
+    const auto wakeMs = GetCurrentMillisecond();
+    source.join();
+    ASSERT_GE(wakeMs, lastEndMs);
+    ASSERT_LT(wakeMs, lastEndMs + WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, waitQuietPeriod)
+{
+    UiScrollTracker tracker;
+    tracker.OnScrollStart(GetCurrentMillisecond(), WINDOW_ID);
+    uint64_t lastEndMs = 0;
+    // the scroll restarts within the quiet period of the first end, as a fling does
+    auto source = FireScrollEvents(tracker, {{40, false}, {60, true}, {120, false}}, lastEndMs);
+    constexpr uint32_t quietMs = 50;
+    ASSERT_TRUE(tracker.WaitScrollComplete(SCROLL_TIMEOUT_MS, quietMs));
+    const auto wakeMs = GetCurrentMillisecond();
+    source.join();
+    ASSERT_GE(wakeMs, lastEndMs + quietMs);
+    ASSERT_LT(wakeMs, lastEndMs + quietMs + WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, timeoutWithoutScrollEnd)
+{
+    UiScrollTracker tracker;
+    const auto startMs = GetCurrentMillisecond();
+    tracker.OnScrollStart(startMs, WINDOW_ID);
+    constexpr uint32_t timeoutMs = 100;
+    ASSERT_FALSE(tracker.WaitScrollComplete(timeoutMs, 0));
+    const auto wakeMs = GetCurrentMillisecond();
+    ASSERT_GE(wakeMs, startMs + timeoutMs);
+    ASSERT_LT(wakeMs, startMs + timeoutMs + WAKE_UP_PRECISION_MS);
+    // the lost end event does not block the later waits
+    ASSERT_TRUE(tracker.WaitScrollComplete(timeoutMs, 0));
+    ASSERT_LT(GetCurrentMillisecond() - wakeMs, WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, waitScrollEndWithoutScroll)
+{
+    UiScrollTracker tracker;
+    const auto endCount = tracker.GetScrollEndCount(WINDOW_ID);
+    ASSERT_NE(0, endCount);
+    const auto startMs = GetCurrentMillisecond();
+    constexpr uint32_t startTimeoutMs = 50;
+    ASSERT_FALSE(tracker.WaitScrollEnd(WINDOW_ID, endCount, startTimeoutMs, SCROLL_TIMEOUT_MS));
+    const auto wakeMs = GetCurrentMillisecond();
+    ASSERT_GE(wakeMs, startMs + startTimeoutMs);
+    ASSERT_LT(wakeMs, startMs + startTimeoutMs + WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, waitScrollEndBeyondStartTimeout)
+{
+    UiScrollTracker tracker;
+    const auto endCount = tracker.GetScrollEndCount(WINDOW_ID);
+    uint64_t lastEndMs = 0;
+    // the scroll starts in the start timeout and ends after it
+    auto source = FireScrollEvents(tracker, {{20, true}, {120, false}}, lastEndMs);
+    constexpr uint32_t startTimeoutMs = 50;
+    ASSERT_TRUE(tracker.WaitScrollEnd(WINDOW_ID, endCount, startTimeoutMs, SCROLL_TIMEOUT_MS));
+    const auto wakeMs = GetCurrentMillisecond();
+    source.join();
+    ASSERT_EQ(endCount + 1, tracker.GetScrollEndCount(WINDOW_ID));
+    ASSERT_GE(wakeMs, lastEndMs);
+    ASSERT_LT(wakeMs, lastEndMs + WAKE_UP_PRECISION_MS);
+}
+
+TEST(UiScrollTrackerTest, waitScrollEndOfTargetWindow)
+{
+    UiScrollTracker tracker;
+    const auto endCount = tracker.GetScrollEndCount(WINDOW_ID);
+    uint64_t otherEndMs = 0;
+    uint64_t lastEndMs = 0;
+    // another window keeps scrolling before and after the target one
+    auto other = FireScrollEvents(tracker, {{10, true}, {30, false}, {90, true}, {110, false}}, otherEndMs,
+        WINDOW_ID + 1);
+    auto source = FireScrollEvents(tracker, {{50, true}, {70, false}}, lastEndMs);
+    constexpr uint32_t startTimeoutMs = 200;
+    ASSERT_TRUE(tracker.WaitScrollEnd(WINDOW_ID, endCount, startTimeoutMs, SCROLL_TIMEOUT_MS));
+    const auto wakeMs = GetCurrentMillisecond();
+    other.join();
+    source.join();
+    ASSERT_GE(wakeMs, lastEndMs);
+    ASSERT_EQ(endCount + 1, tracker.GetScrollEndCount(WINDOW_ID));
+    ASSERT_EQ(endCount + TWO, tracker.GetScrollEndCount(WINDOW_ID + 1));
+}
@@ -316,3 +316,304 @@ TEST_F(WidgetOperatorTest, scrollSearchCheckDirection)
         }
     }
 }
+
+/**Mock a long list scrolled by the injected swipes, only the items inside the list are rendered like a lazy list.
+ * The contents move by the swipe distance multiplied by the shift ratio, as a fling moves them farther.*/
+class ScrollingListController : public MockController {
+public:
+    static constexpr int32_t LIST_WIDTH = 600;
+    static constexpr int32_t LIST_HEIGHT = 1000;
+    static constexpr int32_t ITEM_HEIGHT = 50;
+    static constexpr int32_t LIST_WINDOW_ID = 12;
+
+    ScrollingListController(int32_t itemCount, float shiftRatio) : itemCount_(itemCount), shiftRatio_(shiftRatio) {}
+
+    bool GetWidgetsInWindow(const Window &winInfo, std::unique_ptr<ElementNodeIterator> &elementNodeIterator,
+        AamsWorkMode mode) override
+    {
+        std::vector<MockAccessibilityElementInfo> eles(1);
+        eles[0].accessibilityId = "1";
+        eles[0].componentType = "List";
+        eles[0].hierarchy = "ROOT";
+        eles[0].rectInScreen = Rect{0, LIST_WIDTH, 0, LIST_HEIGHT};
+        for (auto index = offset_ / ITEM_HEIGHT; index < itemCount_ && index * ITEM_HEIGHT < offset_ + LIST_HEIGHT;
+            index++) {
+            MockAccessibilityElementInfo item;
+            item.accessibilityId = to_string(ITEM_ID_BASE + index);
+            item.componentType = "Text";
+            item.content = "Item " + to_string(index);
+            item.hierarchy = WidgetHierarchyBuilder::Build("ROOT", eles[0].childIndexVec.size());
+            item.parentIndex = 0;
+            const auto top = index * ITEM_HEIGHT - offset_;
+            item.rectInScreen = Rect{0, LIST_WIDTH, top, top + ITEM_HEIGHT};
+            eles[0].childIndexVec.emplace_back(eles.size());
+            eles.emplace_back(item);
+        }
+        elementNodeIterator = std::make_unique<MockElementNodeIterator>(eles);
+        return true;
+    }
+
+    void InjectTouchEventSequence(const PointerMatrix &events) const override
+    {
+        swipeCount_++;
+        const auto from = events.At(0, 0).point_.py_;
+        const auto to = events.At(0, events.GetSteps() - 1).point_.py_;
+        const auto maxOffset = itemCount_ * ITEM_HEIGHT - LIST_HEIGHT;
+        const auto ratio = events.At(0, 0).flags_ == TouchOp::FLING ? flingRatio_ : shiftRatio_;
+        const auto lastOffset = offset_;
+        offset_ += static_cast<int32_t>((from - to) * ratio);
+        offset_ = std::max(0, std::min(maxOffset, offset_));
+        if (offset_ != lastOffset && flingRatio_ > 0 && !dropScrollEvents_) {
+            {
+                std::lock_guard<std::mutex> locker(scrollMtx_);
+                scrollEndCounts_[LIST_WINDOW_ID]++;
+            }
+            scrollCond_.notify_all();
+        }
+    }
+
+    /**Track the scroll events, a fling moves the contents by its distance multiplied by flingRatio.*/
+    void TrackScrollEvents(float flingRatio)
+    {
+        flingRatio_ = flingRatio;
+    }
+
+    void DropScrollEvents(bool drop)
+    {
+        dropScrollEvents_ = drop;
+    }
+
+    uint64_t GetScrollEndCount(int32_t windowId) const override
+    {
+        std::lock_guard<std::mutex> locker(scrollMtx_);
+        // counted from 1 as the real tracker does
+        return flingRatio_ > 0 ? scrollEndCounts_[windowId] + 1 : 0;
+    }
+
+    bool WaitForScrollEnd(int32_t windowId, uint64_t count, uint32_t timeoutMs) const override
+    {
+        std::unique_lock<std::mutex> locker(scrollMtx_);
+        waitScrollEndCount_++;
+        return scrollCond_.wait_for(locker, std::chrono::milliseconds(timeoutMs), [this, windowId, count]() {
+            return scrollEndCounts_[windowId] + 1 != count;
+        });
+    }
+
+    /**Mock the scroll end of another scrollable, such as a carousel.*/
+    void EmitScrollEnd(int32_t windowId)
+    {
+        {
+            std::lock_guard<std::mutex> locker(scrollMtx_);
+            scrollEndCounts_[windowId]++;
+        }
+        scrollCond_.notify_all();
+    }
+
+    int32_t GetWaitScrollEndCount() const
+    {
+        return waitScrollEndCount_;
+    }
+
+    int32_t GetSwipeCount() const
+    {
+        return swipeCount_;
+    }
+
+    int32_t GetOffset() const
+    {
+        return offset_;
+    }
+
+private:
+    static constexpr int32_t ITEM_ID_BASE = 100;
+    const int32_t itemCount_;
+    const float shiftRatio_;
+    float flingRatio_ = 0;
+    bool dropScrollEvents_ = false;
+    mutable int32_t offset_ = 0;
+    mutable int32_t swipeCount_ = 0;
+    mutable int32_t waitScrollEndCount_ = 0;
+    mutable std::map<int32_t, uint64_t> scrollEndCounts_;
+    mutable std::mutex scrollMtx_;
+    mutable std::condition_variable scrollCond_;
+};
+
+class ScrollingListTest : public testing::Test {
+protected:
+    void SetUpList(int32_t itemCount, float shiftRatio)
+    {
+        auto controller = std::make_unique<ScrollingListController>(itemCount, shiftRatio);
+        controller_ = controller.get();
+        UiDriver::RegisterController(std::move(controller));
+        driver_ = make_unique<UiDriver>();
+        Window window{ScrollingListController::LIST_WINDOW_ID};
+        window.bounds_ = Rect{0, ScrollingListController::LIST_WIDTH, 0, ScrollingListController::LIST_HEIGHT};
+        window.bundleName_ = "list";
+        controller_->AddWindowsAndNode(window, {});
+        auto error = ApiCallErr(NO_ERROR);
+        WidgetSelector listSelector;
+        listSelector.AddMatcher(WidgetMatchModel(UiAttr::TYPE, "List", EQ));
+        vector<unique_ptr<Widget>> lists;
+        driver_->FindWidgets(listSelector, lists, error);
+        ASSERT_EQ(1, lists.size());
+        list_ = move(lists.at(0));
+    }
+
+    unique_ptr<Widget> ScrollFind(int32_t itemIndex, ApiCallErr &error)
+    {
+        WidgetSelector target;
+        target.AddMatcher(WidgetMatchModel(UiAttr::TEXT, "Item " + to_string(itemIndex), EQ));
+        auto wOp = WidgetOperator(*driver_, *list_, opt_);
+        return wOp.ScrollFindWidget(target, true, error);
+    }
+
+    ScrollingListController *controller_ = nullptr;
+    unique_ptr<UiDriver> driver_ = nullptr;
+    unique_ptr<Widget> list_ = nullptr;
+    UiOpArgs opt_;
+};
+
+TEST_F(ScrollingListTest, scrollSearchLongList)
+{
+    constexpr int32_t itemCount = 3000;
+    constexpr int32_t targetIndex = 2000;
+    SetUpList(itemCount, 1.0);
+    const auto snapshots = controller_->GetUiWindowsCount();
+    auto error = ApiCallErr(NO_ERROR);
+    auto target = ScrollFind(targetIndex, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_NE(nullptr, target);
+    ASSERT_EQ("Item 2000", target->GetAttr(UiAttr::TEXT));
+    // one turn to find the top border, then turns of a whole swipe distance each
+    const int32_t swipeDistance = ScrollingListController::LIST_HEIGHT - TWO * opt_.scrollWidgetDeadZone_;
+    const int32_t targetOffset = (targetIndex + 1) * ScrollingListController::ITEM_HEIGHT -
+        ScrollingListController::LIST_HEIGHT;
+    const int32_t turns = 1 + (targetOffset + swipeDistance - 1) / swipeDistance;
+    ASSERT_EQ(turns, controller_->GetSwipeCount());
+    // one snapshot per page, besides the one to retrieve the list
+    ASSERT_EQ(turns + TWO, controller_->GetUiWindowsCount() - snapshots);
+}
+
+TEST_F(ScrollingListTest, scrollSearchFlingList)
+{
+    // each swipe moves the contents more than the whole list, items are skipped unless the swipe is shortened
+    constexpr int32_t itemCount = 3000;
+    constexpr float shiftRatio = 2.5;
+    SetUpList(itemCount, shiftRatio);
+    auto error = ApiCallErr(NO_ERROR);
+    // never shown by the swipes of the whole distance
+    auto target = ScrollFind(1290, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_NE(nullptr, target);
+    ASSERT_EQ("Item 1290", target->GetAttr(UiAttr::TEXT));
+}
+
+TEST_F(ScrollingListTest, scrollSearchNotFound)
+{
+    SetUpList(500, 1.0);
+    auto error = ApiCallErr(NO_ERROR);
+    ASSERT_EQ(nullptr, ScrollFind(500, error));
+    ASSERT_EQ(NO_ERROR, error.code_);
+    // stops at the bottom border
+    ASSERT_EQ(500 * ScrollingListController::ITEM_HEIGHT - ScrollingListController::LIST_HEIGHT,
+        controller_->GetOffset());
+}
+
+TEST_F(ScrollingListTest, scrollToEndLongList)
+{
+    constexpr int32_t itemCount = 3000;
+    SetUpList(itemCount, 1.0);
+    auto error = ApiCallErr(NO_ERROR);
+    auto wOp = WidgetOperator(*driver_, *list_, opt_);
+    wOp.ScrollToEnd(false, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    const int32_t maxOffset = itemCount * ScrollingListController::ITEM_HEIGHT - ScrollingListController::LIST_HEIGHT;
+    ASSERT_EQ(maxOffset, controller_->GetOffset());
+    // the last turn hits the border and moves less than expected, no extra turn to confirm it
+    const int32_t swipeDistance = ScrollingListController::LIST_HEIGHT - TWO * opt_.scrollWidgetDeadZone_;
+    ASSERT_LE(controller_->GetSwipeCount(), (maxOffset + swipeDistance - 1) / swipeDistance + 1);
+}
+
+TEST_F(ScrollingListTest, flingToEndLongList)
+{
+    constexpr int32_t itemCount = 3000;
+    constexpr float flingRatio = 10;
+    SetUpList(itemCount, 1.0);
+    controller_->TrackScrollEvents(flingRatio);
+    const auto snapshots = controller_->GetUiWindowsCount();
+    auto error = ApiCallErr(NO_ERROR);
+    auto wOp = WidgetOperator(*driver_, *list_, opt_);
+    wOp.ScrollToEnd(false, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    const int32_t maxOffset = itemCount * ScrollingListController::ITEM_HEIGHT - ScrollingListController::LIST_HEIGHT;
+    ASSERT_EQ(maxOffset, controller_->GetOffset());
+    // flings until one scrolls nothing, the page is not compared after each of them
+    const int32_t flingShift = (ScrollingListController::LIST_HEIGHT - TWO * opt_.scrollWidgetDeadZone_) * flingRatio;
+    const int32_t flings = (maxOffset + flingShift - 1) / flingShift + 1;
+    ASSERT_EQ(flings + 1, controller_->GetSwipeCount());
+    ASSERT_EQ(flings, controller_->GetWaitScrollEndCount());
+    // one snapshot to retrieve the list, the others to confirm the end by one more page turn
+    ASSERT_EQ(THREE, controller_->GetUiWindowsCount() - snapshots);
+}
+
+TEST_F(ScrollingListTest, flingToEndWithScrollsInOtherWindow)
+{
+    constexpr int32_t itemCount = 3000;
+    constexpr float flingRatio = 10;
+    static constexpr int32_t carouselWindowId = 13;
+    static constexpr uint32_t carouselIntervalMs = 10;
+    SetUpList(itemCount, 1.0);
+    controller_->TrackScrollEvents(flingRatio);
+    atomic<bool> scrolling = true;
+    thread carousel([this, &scrolling]() {
+        while (scrolling) {
+            controller_->EmitScrollEnd(carouselWindowId);
+            this_thread::sleep_for(chrono::milliseconds(carouselIntervalMs));
+        }
+    });
+    auto error = ApiCallErr(NO_ERROR);
+    auto wOp = WidgetOperator(*driver_, *list_, opt_);
+    wOp.ScrollToEnd(false, error);
+    scrolling = false;
+    carousel.join();
+    ASSERT_EQ(NO_ERROR, error.code_);
+    const int32_t maxOffset = itemCount * ScrollingListController::ITEM_HEIGHT - ScrollingListController::LIST_HEIGHT;
+    ASSERT_EQ(maxOffset, controller_->GetOffset());
+    // the scrolls of the carousel do not keep the flings going
+    const int32_t flingShift = (ScrollingListController::LIST_HEIGHT - TWO * opt_.scrollWidgetDeadZone_) * flingRatio;
+    const int32_t flings = (maxOffset + flingShift - 1) / flingShift + 1;
+    ASSERT_EQ(flings, controller_->GetWaitScrollEndCount());
+}
+
+TEST_F(ScrollingListTest, flingToEndWithLostScrollEvents)
+{
+    constexpr int32_t itemCount = 3000;
+    constexpr float flingRatio = 10;
+    SetUpList(itemCount, 1.0);
+    controller_->TrackScrollEvents(flingRatio);
+    // the flings move the contents but no scroll is reported, the end is not reached
+    controller_->DropScrollEvents(true);
+    auto error = ApiCallErr(NO_ERROR);
+    auto wOp = WidgetOperator(*driver_, *list_, opt_);
+    wOp.ScrollToEnd(false, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(1, controller_->GetWaitScrollEndCount());
+    // turned pages on to the end
+    const int32_t maxOffset = itemCount * ScrollingListController::ITEM_HEIGHT - ScrollingListController::LIST_HEIGHT;
+    ASSERT_EQ(maxOffset, controller_->GetOffset());
+}
+
+TEST_F(ScrollingListTest, flingToTop)
+{
+    constexpr int32_t itemCount = 1000;
+    SetUpList(itemCount, 1.0);
+    controller_->TrackScrollEvents(1.0);
+    auto error = ApiCallErr(NO_ERROR);
+    auto wOp = WidgetOperator(*driver_, *list_, opt_);
+    wOp.ScrollToEnd(false, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_NE(0, controller_->GetOffset());
+    wOp.ScrollToEnd(true, error);
+    ASSERT_EQ(NO_ERROR, error.code_);
+    ASSERT_EQ(0, controller_->GetOffset());
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <tuple>
+#include "gtest/gtest.h"
+#include "widget_spatial_index.h"
+
+using namespace OHOS::uitest;
+using namespace std;
+
+static Widget MakeIndexedWidget(const string &id, const Rect &bounds, int32_t depth, int32_t nodeIndex)
+{
+    Widget widget("test");
+    widget.SetAttr(UiAttr::ACCESSIBILITY_ID, id);
+    widget.SetBounds(bounds);
+    widget.SetNodePosition(nodeIndex, -1, depth);
+    return widget;
+}
+
+static string FindId(const WidgetSpatialIndex &index, int32_t x, int32_t y)
+{
+    auto widget = index.Find(Point(x, y));
+    return widget == nullptr ? "" : widget->GetAttr(UiAttr::ACCESSIBILITY_ID);
+}
+
+TEST(WidgetSpatialIndexTest, emptyIndex)
+{
+    WidgetSpatialIndex index;
+    index.Build();
+    ASSERT_EQ(0, index.Size());
+    ASSERT_EQ(nullptr, index.Find(Point(0, 0)));
+}
+
+TEST(WidgetSpatialIndexTest, deepestAndLatestWins)
+{
+    WidgetSpatialIndex index;
+    index.Add(MakeIndexedWidget("root", Rect(0, 100, 0, 200), 0, 0), 0);
+    index.Add(MakeIndexedWidget("child", Rect(10, 50, 10, 50), 1, 1), 0);
+    index.Add(MakeIndexedWidget("grandchild", Rect(20, 30, 20, 30), TWO, TWO), 0);
+    // siblings overlapping each other, the later one is drawn on top
+    index.Add(MakeIndexedWidget("sibling", Rect(40, 90, 40, 90), 1, 3), 0);
+    index.Build();
+    ASSERT_EQ(4, index.Size());
+    ASSERT_EQ("grandchild", FindId(index, 25, 25));
+    ASSERT_EQ("child", FindId(index, 15, 15));
+    ASSERT_EQ("sibling", FindId(index, 45, 45));
+    ASSERT_EQ("root", FindId(index, 95, 150));
+    // the edges are included
+    ASSERT_EQ("grandchild", FindId(index, 30, 30));
+    ASSERT_EQ("root", FindId(index, 100, 200));
+    ASSERT_EQ("", FindId(index, 101, 100));
+    ASSERT_EQ("", FindId(index, -1, 100));
+}
+
+TEST(WidgetSpatialIndexTest, overlappingWindows)
+{
+    WidgetSpatialIndex index;
+    // a deep widget in the bottom window and a shallow one of the floating window above it
+    index.Add(MakeIndexedWidget("bottomRoot", Rect(0, 1000, 0, 2000), 0, 0), 1);
+    index.Add(MakeIndexedWidget("bottomDeep", Rect(100, 500, 100, 500), 5, 1), 1);
+    index.Add(MakeIndexedWidget("floatRoot", Rect(300, 800, 300, 800), 0, 0), TWO);
+    index.Build();
+    ASSERT_EQ("floatRoot", FindId(index, 400, 400));
+    ASSERT_EQ("bottomDeep", FindId(index, 200, 200));
+    ASSERT_EQ("floatRoot", FindId(index, 700, 700));
+    ASSERT_EQ("bottomRoot", FindId(index, 900, 900));
+}
+
+TEST(WidgetSpatialIndexTest, sameAsLinearScan)
+{
+    constexpr size_t widgetCount = 2000;
+    constexpr size_t lookupCount = 5000;
+    constexpr int32_t width = 1260;
+    constexpr int32_t height = 2720;
+    constexpr int32_t maxDepth = 12;
+    constexpr int32_t layerCount = 3;
+    mt19937 random(20250303);
+    vector<tuple<Rect, int32_t, int32_t>> widgets;
+    WidgetSpatialIndex index;
+    for (size_t order = 0; order < widgetCount; order++) {
+        const auto depth = static_cast<int32_t>(random() % maxDepth);
+        // the deeper widgets are smaller, as the nested ones are
+        const auto maxSize = width / (depth + 1);
+        const auto right = static_cast<int32_t>(random() % width) + 1;
+        const auto bottom = static_cast<int32_t>(random() % height) + 1;
+        const Rect bounds(max(0, right - 1 - static_cast<int32_t>(random() % maxSize)), right,
+            max(0, bottom - 1 - static_cast<int32_t>(random() % maxSize)), bottom);
+        const auto layer = static_cast<int32_t>(random() % layerCount);
+        widgets.emplace_back(bounds, depth, layer);
+        index.Add(MakeIndexedWidget(to_string(order), bounds, depth, static_cast<int32_t>(order)), layer);
+    }
+    index.Build();
+    for (size_t lookup = 0; lookup < lookupCount; lookup++) {
+        const Point point(static_cast<int32_t>(random() % (width + TWO)) - 1,
+            static_cast<int32_t>(random() % (height + TWO)) - 1);
+        string expect = "";
+        tuple<int32_t, int32_t, size_t> best;
+        for (size_t order = 0; order < widgets.size(); order++) {
+            const auto &[bounds, depth, layer] = widgets[order];
+            if (point.px_ < bounds.left_ || point.px_ > bounds.right_ ||
+                point.py_ < bounds.top_ || point.py_ > bounds.bottom_) {
+                continue;
+            }
+            const auto rank = make_tuple(layer, depth, order);
+            if (expect.empty() || rank > best) {
+                best = rank;
+                expect = to_string(order);
+            }
+        }
+        ASSERT_EQ(expect, FindId(index, point.px_, point.py_)) << "lookup " << lookup;
+    }
+}